@@ -0,0 +1,166 @@
+#include "ActivityScheduler.h"
+
+ActivityScheduler::ActivityScheduler(const ATrack& track, const std::vector<Car*>& cars)
+	: m_Track(track),
+	m_Cars(cars),
+	m_WaitingForCar(cars.size()),
+	m_FollowerIds(cars.size(), NoCarId),
+	m_LeaderIds(cars.size(), NoCarId),
+	m_LastLightPhase(track.GetTrafficLight().GetCurrentPhase())
+{
+	// Every car start awake
+	m_AwakeCars.reserve(cars.size());
+	m_SteppingCars.reserve(cars.size());
+	m_PendingFollowers.reserve(cars.size());
+	for (const auto& car : cars)
+	{
+		assert(car->GetId() < cars.size());
+		m_AwakeCars.push_back(car->GetId());
+	}
+}
+
+void ActivityScheduler::Tick()
+{
+	// The lights only change every few seconds, so we only check them once per tick
+	int lightPhase = m_Track.GetTrafficLight().GetCurrentPhase();
+	if (lightPhase != m_LastLightPhase)
+	{
+		WakeUp(m_WaitingForLight[lightPhase]);
+		// A car blocked behind a stationary car may also be waiting for the other lane to be free,
+		// give all of them a chance to change lane once per light phase
+		for (auto& waitingCars : m_WaitingForCar)
+			WakeUp(waitingCars);
+#if PLATOON_COMPRESSION
+		SplitPlatoons();
+#endif
+		m_LastLightPhase = lightPhase;
+	}
+
+	std::swap(m_SteppingCars, m_AwakeCars);
+	m_AwakeCars.clear();
+	for (uint32_t carId : m_SteppingCars)
+	{
+		HandleMoveResult(carId, m_Cars[carId]->Move());
+#if PLATOON_COMPRESSION
+		MovePlatoon(carId);
+#endif
+	}
+#if PLATOON_COMPRESSION
+	JoinPlatoons();
+#endif
+}
+
+void ActivityScheduler::HandleMoveResult(uint32_t carId, EMoveResult moveResult)
+{
+	Car* car = m_Cars[carId];
+	switch (moveResult)
+	{
+	case EMoveResult::StoppedAtRedLight:
+		ParkUntilGreenLight(carId, TrafficLight::GetModuloIndex(car->GetLastTrackDirection()));
+		break;
+	case EMoveResult::WaitingForReservation:
+		// Nothing tell us when the slots will be free, ask again on the next tick
+		m_AwakeCars.push_back(carId);
+		break;
+	case EMoveResult::BlockedByCar:
+		// Only park if the car in front will not move by itself
+		if (m_Cars[car->GetBlockingCarId()]->GetSpeed() == 0.0f)
+			ParkUntilCarMoves(carId, car->GetBlockingCarId());
+		else
+			m_AwakeCars.push_back(carId);
+		break;
+	case EMoveResult::Moving:
+#if PLATOON_COMPRESSION
+		// Slowed down by the car ahead, it can be carried by it
+		if (car->CanFollowInPlatoon(*m_Cars[car->GetBlockingCarId()]))
+			m_PendingFollowers.emplace_back(carId, car->GetBlockingCarId());
+		else
+#endif
+			m_AwakeCars.push_back(carId);
+		// The cars behind us can move again (they will move on the next tick)
+		if (car->GetSpeed() > 0.0f)
+			WakeUp(m_WaitingForCar[carId]);
+		break;
+	}
+}
+
+void ActivityScheduler::MovePlatoon(uint32_t leaderId)
+{
+	// Walk down the platoon, each car is moved right after the one it follow
+	uint32_t carId = leaderId;
+	while (m_FollowerIds[carId] != NoCarId)
+	{
+		const uint32_t followerId = m_FollowerIds[carId];
+		Car* follower = m_Cars[followerId];
+		if (follower->CanFollowInPlatoon(*m_Cars[carId]))
+		{
+			follower->MoveWith(*m_Cars[carId]);
+			WakeUp(m_WaitingForCar[followerId]);
+		}
+		else
+		{
+			// The rest of the platoon stay behind this car, it's their new leader
+			LeavePlatoon(followerId);
+			HandleMoveResult(followerId, follower->Move());
+		}
+		carId = followerId;
+	}
+}
+
+void ActivityScheduler::JoinPlatoons()
+{
+	for (const auto& [followerId, leaderId] : m_PendingFollowers)
+	{
+		// The leader may have moved after the follower, and only one car can follow it
+		bool canJoin = m_FollowerIds[leaderId] == NoCarId && m_Cars[followerId]->CanFollowInPlatoon(*m_Cars[leaderId]);
+		// A platoon can't be a loop (a queue all around a circuit), somebody have to lead it
+		for (uint32_t carId = leaderId; canJoin && carId != NoCarId; carId = m_LeaderIds[carId])
+			canJoin = (carId != followerId);
+
+		if (canJoin)
+		{
+			m_FollowerIds[leaderId] = followerId;
+			m_LeaderIds[followerId] = leaderId;
+			m_PlatoonFollowersAmount++;
+		}
+		else
+			m_AwakeCars.push_back(followerId);
+	}
+	m_PendingFollowers.clear();
+}
+
+void ActivityScheduler::LeavePlatoon(uint32_t followerId)
+{
+	assert(m_LeaderIds[followerId] != NoCarId);
+	m_FollowerIds[m_LeaderIds[followerId]] = NoCarId;
+	m_LeaderIds[followerId] = NoCarId;
+	m_PlatoonFollowersAmount--;
+}
+
+void ActivityScheduler::SplitPlatoons()
+{
+	for (uint32_t carId = 0; carId < m_LeaderIds.size(); carId++)
+	{
+		if (m_LeaderIds[carId] == NoCarId)
+			continue;
+		LeavePlatoon(carId);
+		m_AwakeCars.push_back(carId);
+	}
+}
+
+void ActivityScheduler::ParkUntilGreenLight(uint32_t carId, int lightModuloIndex)
+{
+	m_WaitingForLight[lightModuloIndex].push_back(carId);
+}
+
+void ActivityScheduler::ParkUntilCarMoves(uint32_t carId, uint32_t leaderId)
+{
+	m_WaitingForCar[leaderId].push_back(carId);
+}
+
+void ActivityScheduler::WakeUp(std::vector<uint32_t>& parkedCars)
+{
+	// A parked car is only in one list, so it can't be woken twice
+	m_AwakeCars.insert(m_AwakeCars.end(), parkedCars.begin(), parkedCars.end());
+	parkedCars.clear();
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+#include "TrafficLight.h"
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <utility>
+#include <cstdint>
+
+/**
+ * Step the cars 1 tick at the time, but only the cars that can actually move.
+ * A car stopped at a red light is parked until its light turn green,
+ * and a car blocked behind a stationary car is parked until that car moves
+ * (a car waiting for a reservation of the intersection stay awake, see IntersectionManager).
+ * So the cost of a tick depend on the amount of moving cars, not on the amount of cars.
+ * With PLATOON_COMPRESSION, a car held back by the car ahead on a straight lane join it in a platoon:
+ * it's carried by the car ahead (same step, see Car::MoveWith) instead of solving the collisions with every car again,
+ * so a dense queue cost about one Move per platoon. A follower leave the platoon as soon as it can't be carried
+ * (the leader brake, accelerate, change lane or reach an intersection), and all the platoons are split at every light phase
+ * so their cars get a chance to change lane, like the parked ones.
+ * note: the car ids have to be their index in the cars vector.
+ */
+class ActivityScheduler
+{
+
+public:
+	ActivityScheduler(const ATrack& track, const std::vector<Car*>& cars);
+
+public:
+	/** Move all the awake cars 1 step forward, then park or wake them based on what happened (the track's lights time have to be set before) */
+	void Tick();
+
+	size_t GetAwakeCarsAmount() const { return (m_AwakeCars.size()); }
+	size_t GetParkedCarsAmount() const { return (m_Cars.size() - m_AwakeCars.size() - m_PlatoonFollowersAmount); }
+	/** The cars carried by the car ahead of them */
+	size_t GetPlatoonFollowersAmount() const { return (m_PlatoonFollowersAmount); }
+
+private:
+	static constexpr uint32_t NoCarId = UINT32_MAX;
+
+	/** Keep the car awake, park it, or put it in a platoon, based on its last move */
+	void HandleMoveResult(uint32_t carId, EMoveResult moveResult);
+	/** Move the cars carried by the given car (it just moved), the followers that can't be carried anymore leave the platoon and Move normally */
+	void MovePlatoon(uint32_t leaderId);
+	/** Put the pending followers behind their leader, if they can still be carried (otherwise they stay awake) */
+	void JoinPlatoons();
+	void LeavePlatoon(uint32_t followerId);
+	/** Split all the platoons, their cars are awake again */
+	void SplitPlatoons();
+	void ParkUntilGreenLight(uint32_t carId, int lightModuloIndex);
+	void ParkUntilCarMoves(uint32_t carId, uint32_t leaderId);
+	/** Wake all the cars in the list and clear it */
+	void WakeUp(std::vector<uint32_t>& parkedCars);
+
+private:
+	const ATrack& m_Track;
+	const std::vector<Car*>& m_Cars;
+
+	/** Cars to move on the next tick */
+	std::vector<uint32_t> m_AwakeCars;
+	/** Cars being moved during the current tick (kept as member to reuse the allocation) */
+	std::vector<uint32_t> m_SteppingCars;
+	/** Cars parked at a red light, by the light phase that will wake them */
+	std::array<std::vector<uint32_t>, TrafficLight::PhaseAmount> m_WaitingForLight;
+	/** Cars parked behind another car, by the id of the car they're waiting for */
+	std::vector<std::vector<uint32_t>> m_WaitingForCar;
+
+	/** By car id, the car carried right behind it in its platoon and the car it follow (NoCarId if none) */
+	std::vector<uint32_t> m_FollowerIds;
+	std::vector<uint32_t> m_LeaderIds;
+	/** Cars that can join a platoon (follower id, leader id), only joined at the end of the tick so no car move twice in a tick */
+	std::vector<std::pair<uint32_t, uint32_t>> m_PendingFollowers;
+	size_t m_PlatoonFollowersAmount = 0;
+
+	int m_LastLightPhase;
+};
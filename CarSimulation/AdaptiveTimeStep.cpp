@@ -0,0 +1,108 @@
+#include "AdaptiveTimeStep.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <cassert>
+
+namespace
+{
+	/** How fast a car can go along the axis, its forward vector may not be normalized (and is zero on an intersection at the spawn, it could go anywhere) */
+	float GetMaxSpeedAlong(const Vector2D& forwardVector, float maxSpeed, const Vector2D& axis)
+	{
+		const float forwardLength = forwardVector.Length();
+		if (forwardLength == 0.0f)
+			return (maxSpeed);
+		return (maxSpeed * std::max(0.0f, forwardVector.Dot(axis) / forwardLength));
+	}
+}
+
+AdaptiveTimeStep::AdaptiveTimeStep(const ATrack& track, size_t carsAmount, uint32_t maxStepTicks)
+	: m_Track(track), m_MaxStepTicks(std::max(1u, maxStepTicks)), m_SortedCars(track)
+{
+	m_SortedCars.Reserve(carsAmount);
+	m_States.resize(carsAmount);
+}
+
+uint32_t AdaptiveTimeStep::FindStepTicks(const std::vector<Car>& cars, uint64_t tick, uint64_t ticksLeft)
+{
+	assert(cars.size() <= m_States.size() && ticksLeft > 0);
+	float stepTicks = static_cast<float>(std::min<uint64_t>(m_MaxStepTicks, ticksLeft));
+	if (m_Track.GetIntersectionManager())
+		stepTicks = 1.0f;
+
+	// The first tick of the next phase, rounded like the engines do
+	const double nextPhaseTime = m_Track.GetTrafficLight().GetNextPhaseTime(static_cast<double>(tick) * TickDurationInSecond);
+	const float ticksBeforeNextPhase = static_cast<float>(std::max(1.0, std::ceil(nextPhaseTime / TickDurationInSecond) - static_cast<double>(tick)));
+
+	m_SortedCars.Clear();
+	for (uint32_t i = 0; i < cars.size() && stepTicks > 1.0f; i++)
+	{
+		const Car& car = cars[i];
+		m_States[i] = car.GetState();
+		m_SortedCars.Add(m_States[i].position, i);
+
+		stepTicks = std::min(stepTicks, MaxStepLength / car.GetMaxSpeed());
+		if (ticksBeforeNextPhase < stepTicks && IsApproachingLight(car))
+			stepTicks = ticksBeforeNextPhase;
+	}
+	m_SortedCars.Sort();
+
+	// Two cars further than that can't touch within the longest step, a car is only compared with the tiles in this radius around it
+	constexpr float MaxReach = MaxStepLength * 2.0f + CAR_SIZE_RADIUS * 2.0f + SAFE_DISTANCE_BETWEEN_CARS;
+	constexpr int TilesRadius = static_cast<int>(MaxReach) + 1;
+	for (size_t i = 0; i < m_SortedCars.GetSize() && stepTicks > 1.0f; i++)
+	{
+		const uint32_t carIndex = m_SortedCars.GetCarIndex(i);
+		const IntVector2D tile = m_SortedCars.GetTile(i);
+		m_SortedCars.ForEachInTiles(tile - TilesRadius, tile + TilesRadius, [&](size_t j)
+		{
+			// Each pair is only compared from its first car
+			if (j <= i)
+				return;
+			const uint32_t otherCarIndex = m_SortedCars.GetCarIndex(j);
+			stepTicks = std::min(stepTicks, FindStepTicksBeforeContact(m_States[carIndex], cars[carIndex].GetMaxSpeed(),
+				m_States[otherCarIndex], cars[otherCarIndex].GetMaxSpeed()));
+		});
+	}
+
+	const uint32_t foundStepTicks = std::max(1u, static_cast<uint32_t>(stepTicks));
+	m_StepsAmount++;
+	m_TicksAmount += foundStepTicks;
+	return (foundStepTicks);
+}
+
+bool AdaptiveTimeStep::IsApproachingLight(const Car& car) const
+{
+	// The car check the light 2 tiles before the intersection, and can cross MaxStepLength more tiles within the step
+	constexpr int LookAheadTiles = 2 + static_cast<int>(std::ceil(MaxStepLength));
+	IntVector2D tilePosition = m_Track.MapPositionOnTrack(car.GetPosition());
+	char directionChar = car.GetLastTrackDirection();
+	for (int i = 0; i < LookAheadTiles; i++)
+	{
+		tilePosition += GetDirectionVector(directionChar);
+		const char trackChar = m_Track.GetTrackChar(tilePosition);
+		if (trackChar == INTERSECTION)
+			return (true);
+		if (trackChar == CENTER)
+			return (false);
+		directionChar = trackChar;
+	}
+	return (false);
+}
+
+float AdaptiveTimeStep::FindStepTicksBeforeContact(const CarKinematicState& state, float maxSpeed, const CarKinematicState& otherState, float otherMaxSpeed)
+{
+	const Vector2D offset = otherState.position - state.position;
+	const float distance = offset.Length();
+	const float gap = distance - CAR_SIZE_RADIUS * 2.0f - SAFE_DISTANCE_BETWEEN_CARS;
+	if (gap <= 0.0f)
+		return (0.0f);
+
+	// Both cars at max speed toward each other, the car moving away may also stop at once (at a red light)
+	const Vector2D axis = offset / distance;
+	const float closingSpeed = GetMaxSpeedAlong(state.forwardVector, maxSpeed, axis) + GetMaxSpeedAlong(otherState.forwardVector, otherMaxSpeed, -axis);
+	if (closingSpeed <= 0.0f)
+		return (std::numeric_limits<float>::max());
+	return (gap / closingSpeed);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+#include "TileSortedCars.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * Choose how long the next step of a headless simulation can be (see ADAPTIVE_TIME_STEP), a whole amount of ticks so the lights
+ * keep the same timing as with fixed ticks. The step is the longest one that every car allow:
+ * - a car never move further than MaxStepLength in one step, so it can't jump over the tile where it check the light or cut a turn,
+ * - two cars that could close the gap between them (both at max speed, the one ahead can stop at once) never do it in one step,
+ * - a car that can reach the tile where it check the light do not see the light change phase in the middle of a step.
+ * When no car is close to another or to a light, the cars run MaxStepLength at a time, as soon as it's dense it's one tick at a time.
+ * The cars are sorted by tile so a car is only compared with the cars around it, nothing is allocated after the construction.
+ * note: with an intersection manager every step is one tick, the reservations are planned tick by tick.
+ */
+class AdaptiveTimeStep
+{
+
+public:
+	/** The furthest a car can move in one step, in tiles */
+	static constexpr float MaxStepLength = 0.75f;
+
+public:
+	/**
+	 * \param carsAmount The amount of cars given to FindStepTicks.
+	 * \param maxStepTicks The longest step, in ticks.
+	 */
+	AdaptiveTimeStep(const ATrack& track, size_t carsAmount, uint32_t maxStepTicks);
+
+public:
+	/**
+	 * Find how many ticks the next step can last, from the state of the cars before the step.
+	 *
+	 * \param tick The tick at which the step start (the lights time is tick * tick duration).
+	 * \param ticksLeft The step never go further than that.
+	 * \return Between 1 and the max step ticks.
+	 */
+	uint32_t FindStepTicks(const std::vector<Car>& cars, uint64_t tick, uint64_t ticksLeft);
+
+	uint64_t GetStepsAmount() const { return (m_StepsAmount); }
+	uint64_t GetTicksAmount() const { return (m_TicksAmount); }
+
+private:
+	/** Whether the car can reach the tile where it check the light of the next intersection within one step */
+	bool IsApproachingLight(const Car& car) const;
+	/** The longest step (in ticks, not rounded) before the two cars could touch */
+	static float FindStepTicksBeforeContact(const CarKinematicState& state, float maxSpeed, const CarKinematicState& otherState, float otherMaxSpeed);
+
+private:
+	const ATrack& m_Track;
+	const uint32_t m_MaxStepTicks;
+
+	/** The cars by index, sorted for each step */
+	TileSortedCars m_SortedCars;
+	/** The state of each car when it was sorted, by car index */
+	std::vector<CarKinematicState> m_States;
+
+	uint64_t m_StepsAmount = 0;
+	uint64_t m_TicksAmount = 0;
+};
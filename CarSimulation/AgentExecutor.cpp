@@ -0,0 +1,110 @@
+#include "AgentExecutor.h"
+#include "RegionEngine.h"
+
+#include <algorithm>
+
+namespace
+{
+	/** Index of the worker running on this thread */
+	thread_local size_t CurrentWorkerIndex = 0;
+}
+
+AgentExecutor::AgentExecutor(const ATrack& track, unsigned int threadsAmount)
+	: m_Track(track),
+	m_LastLightPhase(track.GetTrafficLight().GetCurrentPhase()),
+	m_SortedCars(track),
+	m_Workers(std::max(1u, threadsAmount)),
+	m_Barrier(m_Workers.size())
+{
+	// The thread calling Tick is the first worker
+	m_Threads.reserve(m_Workers.size() - 1);
+	for (size_t i = 1; i < m_Workers.size(); i++)
+		m_Threads.emplace_back(&AgentExecutor::WorkerLoop, this, i);
+}
+
+AgentExecutor::~AgentExecutor()
+{
+	m_IsStopping = true;
+	m_Barrier.Wait();
+	for (std::thread& thread : m_Threads)
+		thread.join();
+}
+
+void AgentExecutor::Spawn(AgentTask&& agent)
+{
+	m_Workers[0].NextTickAgents.push_back(agent.GetHandle());
+	m_Agents.push_back(std::move(agent));
+}
+
+void AgentExecutor::Tick()
+{
+	m_ReadyAgents.clear();
+
+	// The lights only change every few seconds, so we only check them once per tick
+	int lightPhase = m_Track.GetTrafficLight().GetCurrentPhase();
+	if (lightPhase != m_LastLightPhase)
+	{
+		for (Worker& worker : m_Workers)
+		{
+			m_ReadyAgents.insert(m_ReadyAgents.end(), worker.WaitingForLight[lightPhase].begin(), worker.WaitingForLight[lightPhase].end());
+			worker.WaitingForLight[lightPhase].clear();
+		}
+		m_LastLightPhase = lightPhase;
+	}
+	for (Worker& worker : m_Workers)
+	{
+		m_ReadyAgents.insert(m_ReadyAgents.end(), worker.NextTickAgents.begin(), worker.NextTickAgents.end());
+		worker.NextTickAgents.clear();
+	}
+
+	// The cars moved during the tick are less than a tile away from where they were sorted
+	if (m_ReadyAgents.empty() == false)
+	{
+		const std::vector<const Car*>& cars = m_Track.GetCarsOnTrack();
+		m_SortedCars.Clear();
+		for (size_t i = 0; i < cars.size(); i++)
+			m_SortedCars.Add(cars[i]->GetPosition(), static_cast<uint32_t>(i));
+		m_SortedCars.Sort();
+	}
+
+	m_Barrier.Wait();
+	ResumeAgents(0);
+	m_Barrier.Wait();
+}
+
+const std::vector<const Car*>& AgentExecutor::GatherNearbyCars(const Car& car)
+{
+	std::vector<const Car*>& nearbyCars = GetCurrentWorker().NearbyCars;
+	const IntVector2D carTile = m_SortedCars.GetClampedTile(car.GetPosition());
+	nearbyCars.clear();
+	m_SortedCars.GatherCars(carTile - RegionEngine::NearbyTilesRadius, carTile + RegionEngine::NearbyTilesRadius, m_Track.GetCarsOnTrack(), nearbyCars);
+	return (nearbyCars);
+}
+
+AgentExecutor::Worker& AgentExecutor::GetCurrentWorker()
+{
+	return (m_Workers[CurrentWorkerIndex]);
+}
+
+void AgentExecutor::WorkerLoop(size_t workerIndex)
+{
+	CurrentWorkerIndex = workerIndex;
+	while (true)
+	{
+		// Wait for the next tick
+		m_Barrier.Wait();
+		if (m_IsStopping)
+			return;
+		ResumeAgents(workerIndex);
+		m_Barrier.Wait();
+	}
+}
+
+void AgentExecutor::ResumeAgents(size_t workerIndex)
+{
+	// Contiguous shares, each worker resume its agents until they co_await again
+	const size_t firstAgentIndex = m_ReadyAgents.size() * workerIndex / m_Workers.size();
+	const size_t lastAgentIndex = m_ReadyAgents.size() * (workerIndex + 1) / m_Workers.size();
+	for (size_t i = firstAgentIndex; i < lastAgentIndex; i++)
+		m_ReadyAgents[i].resume();
+}
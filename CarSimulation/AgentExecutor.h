@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Defines.h"
+#include "Track.h"
+#include "TrafficLight.h"
+#include "AgentTask.h"
+#include "Barrier.h"
+#include "TileSortedCars.h"
+
+#include <vector>
+#include <array>
+#include <thread>
+#include <coroutine>
+
+/**
+ * Run agents written as coroutines on a few worker threads, 1 tick at the time.
+ * Each agent act on its own and co_await what it's waiting for (the next tick, or its light turning green),
+ * the executor only resume the agents that have something to do during the tick, spread over the workers.
+ * An agent only cost its coroutine frame (a few hundred bytes) instead of a whole thread with its stack.
+ * Like the thread per car mode, the agents moved at the same time only see each other through the published states.
+ * The cars of the track are sorted by tile at the start of each tick, an agent only look at the cars of the tiles around its car (GatherNearbyCars).
+ */
+class AgentExecutor
+{
+
+public:
+	/**
+	 * \param threadsAmount The amount of threads resuming the agents (the one calling Tick included).
+	 */
+	AgentExecutor(const ATrack& track, unsigned int threadsAmount = std::thread::hardware_concurrency());
+	~AgentExecutor();
+	AgentExecutor(const AgentExecutor& other) = delete;
+	AgentExecutor& operator=(const AgentExecutor& other) = delete;
+
+public:
+	/** Take the agent, it start on the next tick (not during a tick) */
+	void Spawn(AgentTask&& agent);
+	/** Resume every agent waiting for this tick, return once they're all suspended again (the track's lights time have to be set before) */
+	void Tick();
+
+	size_t GetAgentsAmount() const { return (m_Agents.size()); }
+	/** Amount of agents resumed during the last tick */
+	size_t GetResumedAgentsAmount() const { return (m_ReadyAgents.size()); }
+	/**
+	 * The cars of the track that the car can reach during the tick, to give to Car::Move (see RegionEngine::NearbyTilesRadius).
+	 * Only for the agents being resumed, the list belong to the worker and is valid until its next call.
+	 */
+	const std::vector<const Car*>& GatherNearbyCars(const Car& car);
+
+public:
+	/** co_await it to wait for the next tick */
+	struct NextTickAwaiter
+	{
+		AgentExecutor& executor;
+
+		bool await_ready() const noexcept { return (false); }
+		void await_suspend(std::coroutine_handle<> agent) const { executor.GetCurrentWorker().NextTickAgents.push_back(agent); }
+		void await_resume() const noexcept {}
+	};
+	/** co_await it to wait for the tick during which the lights turn green for the given direction */
+	struct GreenLightAwaiter
+	{
+		AgentExecutor& executor;
+		char trackDirectionChar;
+
+		bool await_ready() const noexcept { return (executor.m_Track.GetTrafficLight().IsGreenFor(trackDirectionChar)); }
+		void await_suspend(std::coroutine_handle<> agent) const
+		{
+			executor.GetCurrentWorker().WaitingForLight[TrafficLight::GetModuloIndex(trackDirectionChar)].push_back(agent);
+		}
+		void await_resume() const noexcept {}
+	};
+
+	NextTickAwaiter NextTick() { return (NextTickAwaiter{ *this }); }
+	GreenLightAwaiter GreenLight(char trackDirectionChar) { return (GreenLightAwaiter{ *this, trackDirectionChar }); }
+
+private:
+	/** What the agents resumed by a worker are waiting for, only that worker touch it during a tick */
+	struct alignas(CACHE_LINE_SIZE) Worker
+	{
+		std::vector<std::coroutine_handle<>> NextTickAgents;
+		std::array<std::vector<std::coroutine_handle<>>, TrafficLight::PhaseAmount> WaitingForLight;
+		std::vector<const Car*> NearbyCars;
+	};
+
+	/** The worker of the calling thread (the one calling Tick and Spawn is the first one) */
+	Worker& GetCurrentWorker();
+
+	void WorkerLoop(size_t workerIndex);
+	/** Resume the worker's share of the ready agents */
+	void ResumeAgents(size_t workerIndex);
+
+private:
+	const ATrack& m_Track;
+
+	std::vector<AgentTask> m_Agents;
+	/** The agents to resume during the current tick */
+	std::vector<std::coroutine_handle<>> m_ReadyAgents;
+	int m_LastLightPhase;
+	/** The cars of the track by index, sorted before the agents of the tick are resumed (they only read it) */
+	TileSortedCars m_SortedCars;
+
+	std::vector<Worker> m_Workers;
+	std::vector<std::thread> m_Threads;
+	Barrier m_Barrier;
+	/** Only written before a barrier, the barrier make it visible to the workers */
+	bool m_IsStopping = false;
+};
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+/**
+ * The coroutine of an agent (see AgentExecutor).
+ * It start suspended, the executor resume it, and it own the coroutine frame: destroying the task destroy the agent.
+ */
+class AgentTask
+{
+
+public:
+	struct promise_type
+	{
+		AgentTask get_return_object() { return (AgentTask(std::coroutine_handle<promise_type>::from_promise(*this))); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+
+public:
+	AgentTask(AgentTask&& other) noexcept : m_Handle(std::exchange(other.m_Handle, nullptr)) {}
+	AgentTask& operator=(AgentTask&& other) noexcept
+	{
+		if (this != &other)
+		{
+			if (m_Handle)
+				m_Handle.destroy();
+			m_Handle = std::exchange(other.m_Handle, nullptr);
+		}
+		return *this;
+	}
+	AgentTask(const AgentTask& other) = delete;
+	AgentTask& operator=(const AgentTask& other) = delete;
+	~AgentTask()
+	{
+		if (m_Handle)
+			m_Handle.destroy();
+	}
+
+public:
+	std::coroutine_handle<> GetHandle() const { return (m_Handle); }
+
+private:
+	explicit AgentTask(std::coroutine_handle<promise_type> handle) : m_Handle(handle) {}
+
+private:
+	std::coroutine_handle<promise_type> m_Handle;
+};
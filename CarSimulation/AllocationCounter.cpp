@@ -0,0 +1,81 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	// Constant initialized, so they're ready before the first allocation of the static constructors
+	std::atomic<uint64_t> AllocationsAmount = { 0 };
+	std::atomic<uint64_t> DeallocationsAmount = { 0 };
+}
+
+uint64_t AllocationCounter::GetAllocationsAmount()
+{
+	return (AllocationsAmount.load(std::memory_order_relaxed));
+}
+
+uint64_t AllocationCounter::GetDeallocationsAmount()
+{
+	return (DeallocationsAmount.load(std::memory_order_relaxed));
+}
+
+#if COUNT_ALLOCATIONS
+// The array and nothrow versions of the standard library call these ones, so replacing them is enough to count everything
+
+void* operator new(std::size_t size)
+{
+	AllocationsAmount.fetch_add(1, std::memory_order_relaxed);
+	if (void* memory = std::malloc(size == 0 ? 1 : size))
+		return (memory);
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	AllocationsAmount.fetch_add(1, std::memory_order_relaxed);
+	const size_t alignmentInBytes = static_cast<size_t>(alignment);
+	if (size == 0)
+		size = 1;
+#ifdef _WIN32
+	void* memory = _aligned_malloc(size, alignmentInBytes);
+#else
+	// aligned_alloc want a size multiple of the alignment
+	void* memory = std::aligned_alloc(alignmentInBytes, (size + alignmentInBytes - 1) / alignmentInBytes * alignmentInBytes);
+#endif
+	if (memory)
+		return (memory);
+	throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+	if (memory == nullptr)
+		return;
+	DeallocationsAmount.fetch_add(1, std::memory_order_relaxed);
+	std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	operator delete(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+	if (memory == nullptr)
+		return;
+	DeallocationsAmount.fetch_add(1, std::memory_order_relaxed);
+#ifdef _WIN32
+	_aligned_free(memory);
+#else
+	std::free(memory);
+#endif
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(memory, alignment);
+}
+#endif
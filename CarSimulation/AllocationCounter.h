@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Defines.h"
+
+#include <cstdint>
+
+/**
+ * Count the heap allocations of the whole program, to check that a piece of code does not allocate.
+ * With COUNT_ALLOCATIONS the global operator new and delete are replaced by counting versions (see AllocationCounter.cpp),
+ * without it the counters always stay at 0.
+ * Only what goes through operator new is counted, not the direct malloc calls of the C runtime or the OS.
+ */
+class AllocationCounter
+{
+
+public:
+	/** Amount of calls to operator new since the program started (from any thread) */
+	static uint64_t GetAllocationsAmount();
+	/** Amount of calls to operator delete since the program started (from any thread) */
+	static uint64_t GetDeallocationsAmount();
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Defines.h"
+#include "IntVector2D.h"
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+/** What is known about a tile once the map is done, one bit each (see TrackLayout::tileFlags) */
+struct TileFlags
+{
+	static constexpr uint8_t Road = 1 << 0;
+	static constexpr uint8_t Intersection = 1 << 1;
+	/** The tile 45 degrees clockwise from the direction (in the map, y going down) is a lane going the same way */
+	static constexpr uint8_t LaneClockwise = 1 << 2;
+	/** Same for 45 degrees counter clockwise, only used when there is no lane clockwise */
+	static constexpr uint8_t LaneCounterClockwise = 1 << 3;
+};
+
+constexpr bool IsRoadChar(char c)
+{
+	return (c == UP || c == UP_RIGHT || c == RIGHT || c == RIGHT_DOWN
+		|| c == DOWN || c == DOWN_LEFT || c == LEFT || c == LEFT_UP || c == INTERSECTION);
+}
+
+/** The direction 45 degrees away, the same tiles Car::FindNextLaneDirection used to find with its rotated vectors. CENTER for the other chars */
+constexpr char RotateDirectionChar45(char direction, bool isClockwise)
+{
+	constexpr char Directions[8] = { UP, UP_RIGHT, RIGHT, RIGHT_DOWN, DOWN, DOWN_LEFT, LEFT, LEFT_UP };
+	for (int i = 0; i < 8; i++)
+	{
+		if (Directions[i] == direction)
+			return (Directions[(i + (isClockwise ? 1 : 7)) % 8]);
+	}
+	return (CENTER);
+}
+
+/** The flags of the tile, computed from the tile and its neighbours (the chars out of the map are ' ') */
+constexpr uint8_t ComputeTileFlags(const char* tiles, int width, int height, int x, int y)
+{
+	const auto getChar = [&](const IntVector2D& pos) { return ((pos.x >= 0 && pos.x < width && pos.y >= 0 && pos.y < height) ? tiles[pos.y * width + pos.x] : ' '); };
+	const char trackChar = tiles[y * width + x];
+	uint8_t flags = 0;
+	if (IsRoadChar(trackChar))
+		flags |= TileFlags::Road;
+	if (trackChar == INTERSECTION)
+		flags |= TileFlags::Intersection;
+	else if (IsRoadChar(trackChar))
+	{
+		if (getChar(IntVector2D(x, y) + GetDirectionVector(RotateDirectionChar45(trackChar, true))) == trackChar)
+			flags |= TileFlags::LaneClockwise;
+		if (getChar(IntVector2D(x, y) + GetDirectionVector(RotateDirectionChar45(trackChar, false))) == trackChar)
+			flags |= TileFlags::LaneCounterClockwise;
+	}
+	return (flags);
+}
+
+/**
+ * The tiles of a map and the tables derived from them, as seen by ATrack.
+ * Only pointers, the data is owned either by a BakedTrack (static, built when the program is compiled)
+ * or by the track itself for the maps made at run time.
+ * The tiles are stored row after row, the index of a tile is y * width + x.
+ */
+struct TrackLayout
+{
+	int width = 0;
+	int height = 0;
+	/** width * height chars */
+	const char* tiles = nullptr;
+	/** width * height TileFlags */
+	const uint8_t* tileFlags = nullptr;
+	/** Index of every road tile except the intersections, in the map order */
+	const uint32_t* spawnSlots = nullptr;
+	size_t spawnSlotsAmount = 0;
+	/** Index of every intersection tile, in the map order */
+	const uint32_t* intersectionTiles = nullptr;
+	size_t intersectionTilesAmount = 0;
+};
+
+/**
+ * A built-in map with all its tables, computed by the compiler: nothing to allocate or to look for when the program start,
+ * and every query on a constexpr BakedTrack is folded into a constant (see the static_assert under the built-in tracks).
+ * The track keep pointers to it, so it have to be static (a static constexpr member of the track class for example).
+ * The tables are as big as the map, they only fit the small hand made maps (the generated ones compute theirs at run time, see ATrack).
+ */
+template<int Width, int Height>
+class BakedTrack
+{
+
+public:
+	static constexpr int TilesAmount = Width * Height;
+
+public:
+	constexpr BakedTrack(const char (&rows)[Height][Width])
+	{
+		for (int y = 0; y < Height; y++)
+		{
+			for (int x = 0; x < Width; x++)
+				m_Tiles[y * Width + x] = rows[y][x];
+		}
+		for (int i = 0; i < TilesAmount; i++)
+		{
+			m_TileFlags[i] = ComputeTileFlags(m_Tiles.data(), Width, Height, i % Width, i / Width);
+			if ((m_TileFlags[i] & TileFlags::Intersection) != 0)
+				m_IntersectionTiles[m_IntersectionTilesAmount++] = static_cast<uint32_t>(i);
+			else if ((m_TileFlags[i] & TileFlags::Road) != 0)
+				m_SpawnSlots[m_SpawnSlotsAmount++] = static_cast<uint32_t>(i);
+		}
+	}
+
+public:
+	constexpr char GetTrackChar(const IntVector2D& pos) const
+	{
+		if (pos.x >= 0 && pos.x < Width && pos.y >= 0 && pos.y < Height)
+			return (m_Tiles[pos.y * Width + pos.x]);
+		return (' ');
+	}
+	constexpr uint8_t GetTileFlags(const IntVector2D& pos) const
+	{
+		if (pos.x >= 0 && pos.x < Width && pos.y >= 0 && pos.y < Height)
+			return (m_TileFlags[pos.y * Width + pos.x]);
+		return (0);
+	}
+	constexpr size_t GetSpawnSlotsAmount() const { return (m_SpawnSlotsAmount); }
+	constexpr size_t GetIntersectionTilesAmount() const { return (m_IntersectionTilesAmount); }
+
+	constexpr TrackLayout GetLayout() const
+	{
+		return (TrackLayout{ Width, Height, m_Tiles.data(), m_TileFlags.data(), m_SpawnSlots.data(), m_SpawnSlotsAmount, m_IntersectionTiles.data(), m_IntersectionTilesAmount });
+	}
+
+private:
+	std::array<char, TilesAmount> m_Tiles = {};
+	std::array<uint8_t, TilesAmount> m_TileFlags = {};
+	std::array<uint32_t, TilesAmount> m_SpawnSlots = {};
+	size_t m_SpawnSlotsAmount = 0;
+	std::array<uint32_t, TilesAmount> m_IntersectionTiles = {};
+	size_t m_IntersectionTilesAmount = 0;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * Reusable thread barrier: every participant wait until all of them reached it, then they're all released together.
+ * Everything written by a participant before the barrier is visible to all the others after it.
+ */
+class Barrier
+{
+
+public:
+	explicit Barrier(size_t participantsAmount)
+		: m_ParticipantsAmount(participantsAmount)
+	{}
+	Barrier(const Barrier& other) = delete;
+	Barrier& operator=(const Barrier& other) = delete;
+
+public:
+	void Wait()
+	{
+		std::unique_lock<std::mutex> lock(m_Mutex);
+		uint64_t generation = m_Generation;
+		if (++m_ArrivedAmount == m_ParticipantsAmount)
+		{
+			// Last one in, release everyone and get ready for the next use
+			m_ArrivedAmount = 0;
+			m_Generation++;
+			m_AllArrived.notify_all();
+			return;
+		}
+		m_AllArrived.wait(lock, [this, generation]() { return (m_Generation != generation); });
+	}
+
+private:
+	const size_t m_ParticipantsAmount;
+
+	std::mutex m_Mutex;
+	std::condition_variable m_AllArrived;
+	size_t m_ArrivedAmount = 0;
+	/** Incremented every time the barrier open, so a participant can't be released by the previous use */
+	uint64_t m_Generation = 0;
+};
@@ -0,0 +1,152 @@
+#include "BatchRunner.h"
+#include "Car.h"
+#include "IntersectionManager.h"
+#include "AdaptiveTimeStep.h"
+#include "Random.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+
+BatchRunner::BatchRunner(const ATrack& track, unsigned int threadsAmount)
+	: m_Track(track),
+	m_ThreadsAmount(std::max(1u, threadsAmount))
+{}
+
+std::vector<BatchScenario> BatchRunner::CreateScenarios(uint64_t seed, size_t amount, uint32_t minCarsAmount, uint32_t maxCarsAmount,
+	double minLightPhaseDuration, double maxLightPhaseDuration, uint64_t ticksAmount)
+{
+	assert(minCarsAmount > 0 && minCarsAmount <= maxCarsAmount && minLightPhaseDuration > 0.0 && minLightPhaseDuration <= maxLightPhaseDuration);
+
+	RandomStream random(seed, 0, ERandomPurpose::Scenarios);
+	std::vector<BatchScenario> scenarios(amount);
+	for (size_t i = 0; i < amount; i++)
+	{
+		BatchScenario& scenario = scenarios[i];
+		scenario.index = static_cast<uint32_t>(i);
+		scenario.seed = (static_cast<uint64_t>(random.NextUInt()) << 32) | random.NextUInt();
+		scenario.carsAmount = minCarsAmount + random.Range(maxCarsAmount - minCarsAmount + 1);
+		scenario.lightPhaseDurationInSecond = minLightPhaseDuration + random.NextFloat() * (maxLightPhaseDuration - minLightPhaseDuration);
+		scenario.ticksAmount = ticksAmount;
+	}
+	return (scenarios);
+}
+
+void BatchRunner::Run(const std::vector<BatchScenario>& scenarios)
+{
+	m_Results.assign(scenarios.size(), BatchResult());
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+	// Each worker take the next scenario when it's done, so the long scenarios do not leave the other cores waiting
+	std::atomic<size_t> nextScenarioIndex = { 0 };
+	auto runScenarios = [this, &scenarios, &nextScenarioIndex](size_t workerIndex)
+	{
+		for (size_t i = nextScenarioIndex++; i < scenarios.size(); i = nextScenarioIndex++)
+			m_Results[i] = RunScenario(scenarios[i], workerIndex);
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(m_ThreadsAmount - 1);
+	for (unsigned int i = 1; i < m_ThreadsAmount; i++)
+		workers.emplace_back(runScenarios, i);
+	runScenarios(0);
+	for (std::thread& worker : workers)
+		worker.join();
+
+	m_RunDurationInSecond = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+bool BatchRunner::WriteResults(const std::string& path) const
+{
+	std::ofstream file(path);
+	if (file.is_open() == false)
+		return (false);
+
+	file << "scenario,seed,cars,light_phase_duration,ticks,average_speed,blocked_by_car_ratio,stopped_at_red_light_ratio,jammed_ticks,steps\n";
+	for (const BatchResult& result : m_Results)
+	{
+		const BatchScenario& scenario = result.scenario;
+		file << scenario.index << ',' << scenario.seed << ',' << scenario.carsAmount << ',' << scenario.lightPhaseDurationInSecond << ',' << scenario.ticksAmount << ','
+			<< result.averageSpeed << ',' << result.blockedByCarRatio << ',' << result.stoppedAtRedLightRatio << ',' << result.jammedTicksAmount << ',' << result.stepsAmount << '\n';
+	}
+	return (file.good());
+}
+
+BatchResult BatchRunner::RunScenario(const BatchScenario& scenario, size_t workerIndex) const
+{
+	ATrack track = m_Track.CreateEmptyCopy();
+	track.GetTrafficLight().SetPhaseDuration(scenario.lightPhaseDurationInSecond);
+#if INTERSECTION_CONTROL
+	// Each scenario have its own reservations, like its own lights
+	IntersectionManager intersectionManager(track);
+	track.SetIntersectionManager(&intersectionManager);
+#endif
+
+	// The cars are stored contiguously, the vector is never resized once the cars are registered
+	std::vector<Vector2D> spawnPoints = track.GetUniqueSpawnPoints(scenario.carsAmount, scenario.seed);
+	std::vector<Car> cars;
+	cars.reserve(scenario.carsAmount);
+	for (uint32_t i = 0; i < scenario.carsAmount; i++)
+	{
+		cars.emplace_back(track, i, scenario.seed, spawnPoints[i]);
+		track.RegisterNewCarOnTrack(&cars.back());
+	}
+
+#if ADAPTIVE_TIME_STEP
+	AdaptiveTimeStep timeStep(track, cars.size(), ADAPTIVE_MAX_STEP_TICKS);
+#endif
+
+	BatchResult result;
+	result.scenario = scenario;
+	double speedSum = 0.0;
+	uint64_t blockedByCarAmount = 0;
+	uint64_t stoppedAtRedLightAmount = 0;
+	for (uint64_t tick = 0; tick < scenario.ticksAmount;)
+	{
+		track.GetTrafficLight().SetTime(static_cast<double>(tick) * TickDurationInSecond);
+#if ADAPTIVE_TIME_STEP
+		const uint32_t stepTicks = timeStep.FindStepTicks(cars, tick, scenario.ticksAmount - tick);
+#else
+		const uint32_t stepTicks = 1;
+#endif
+		const double stepDurationInSecond = static_cast<double>(stepTicks) * TickDurationInSecond;
+
+		// A step of several ticks count as that many ticks of the step's result
+		uint32_t blockedCarsAmount = 0;
+		for (Car& car : cars)
+		{
+			switch (car.Move(track.GetCarsOnTrack(), stepDurationInSecond))
+			{
+			case EMoveResult::BlockedByCar:
+				blockedCarsAmount++;
+				break;
+			case EMoveResult::StoppedAtRedLight:
+			case EMoveResult::WaitingForReservation:
+				stoppedAtRedLightAmount += stepTicks;
+				break;
+			default:
+				break;
+			}
+			speedSum += car.GetSpeed() * static_cast<double>(stepTicks);
+			if (m_Heatmap)
+				m_Heatmap->RecordCar(car, workerIndex, stepTicks);
+		}
+		if (m_Heatmap)
+			m_Heatmap->EndTick(workerIndex, stepTicks);
+		blockedByCarAmount += static_cast<uint64_t>(blockedCarsAmount) * stepTicks;
+		if (blockedCarsAmount * 2 >= scenario.carsAmount)
+			result.jammedTicksAmount += stepTicks;
+		result.stepsAmount++;
+		tick += stepTicks;
+	}
+
+	const double movesAmount = static_cast<double>(scenario.ticksAmount) * scenario.carsAmount;
+	if (movesAmount > 0.0)
+	{
+		result.averageSpeed = speedSum / movesAmount;
+		result.blockedByCarRatio = blockedByCarAmount / movesAmount;
+		result.stoppedAtRedLightRatio = stoppedAtRedLightAmount / movesAmount;
+	}
+	return (result);
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Defines.h"
+#include "Track.h"
+#include "TileHeatmap.h"
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+/** The parameters of 1 headless simulation */
+struct BatchScenario
+{
+	uint32_t index = 0;
+	uint64_t seed = 0;
+	uint32_t carsAmount = 0;
+	double lightPhaseDurationInSecond = TrafficLight::DefaultPhaseDurationInSecond;
+	uint64_t ticksAmount = 0;
+};
+
+/** What we measured during 1 scenario (the ratios are over all the car moves) */
+struct BatchResult
+{
+	BatchScenario scenario;
+	double averageSpeed = 0.0;
+	double blockedByCarRatio = 0.0;
+	double stoppedAtRedLightRatio = 0.0;
+	/** Amount of ticks during which at least half of the cars were blocked behind another car */
+	uint64_t jammedTicksAmount = 0;
+	/** Amount of steps the ticks were run in (the amount of ticks with fixed steps, see ADAPTIVE_TIME_STEP) */
+	uint64_t stepsAmount = 0;
+};
+
+/**
+ * Run a lot of independent headless simulations (Monte Carlo), spread over all the cores.
+ * Each worker pick the next scenario as soon as it's done with the previous one.
+ * The scenarios share the immutable map of the track, each one get its own copy of the rest (cars, registry, lights).
+ */
+class BatchRunner
+{
+
+public:
+	BatchRunner(const ATrack& track, unsigned int threadsAmount = std::thread::hardware_concurrency());
+
+public:
+	/**
+	 * Draw random scenarios, the same seed always give the same scenarios.
+	 *
+	 * \param seed The seed of the batch, each scenario get its own seed from it.
+	 * \param amount The amount of scenarios.
+	 * \param minCarsAmount, maxCarsAmount The range of the amount of cars (included).
+	 * \param minLightPhaseDuration, maxLightPhaseDuration The range of the lights phase duration in second.
+	 * \param ticksAmount The amount of ticks each scenario run.
+	 */
+	static std::vector<BatchScenario> CreateScenarios(uint64_t seed, size_t amount, uint32_t minCarsAmount, uint32_t maxCarsAmount,
+		double minLightPhaseDuration, double maxLightPhaseDuration, uint64_t ticksAmount);
+
+	/** Run all the scenarios, return once they're all done */
+	void Run(const std::vector<BatchScenario>& scenarios);
+	/** Count every tick of every scenario in the heatmap (it need GetThreadsAmount threads, each worker record in its own grid) */
+	void SetHeatmap(TileHeatmap* heatmap) { m_Heatmap = heatmap; }
+	/** Write one line per scenario in a csv file, return false if the file can't be written */
+	bool WriteResults(const std::string& path) const;
+
+	/** The results of the last run, in the same order as the scenarios */
+	const std::vector<BatchResult>& GetResults() const { return (m_Results); }
+	double GetSimulationsPerSecond() const { return (m_Results.size() / m_RunDurationInSecond); }
+	double GetRunDuration() const { return (m_RunDurationInSecond); }
+	unsigned int GetThreadsAmount() const { return (m_ThreadsAmount); }
+
+private:
+	BatchResult RunScenario(const BatchScenario& scenario, size_t workerIndex) const;
+
+private:
+	const ATrack& m_Track;
+	const unsigned int m_ThreadsAmount;
+
+	std::vector<BatchResult> m_Results;
+	double m_RunDurationInSecond = 0.0;
+	TileHeatmap* m_Heatmap = nullptr;
+};
@@ -0,0 +1,355 @@
+#include "Bench.h"
+#include "Vector2D.h"
+#include "IntVector2D.h"
+#include "FixedVector2D.h"
+#include "Car.h"
+#include "Track.h"
+#include "FleetPool.h"
+#include "TrackGenerator.h"
+#include "RegionEngine.h"
+#include "Random.h"
+#include "Barrier.h"
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace
+{
+	/** A power of two, the inputs are picked by masking the index of the call */
+	constexpr size_t InputsAmount = 1024;
+	constexpr uint64_t InputsMask = InputsAmount - 1;
+	constexpr uint64_t BenchSeed = 1;
+
+	/** The results are written there, the compiler has to compute them */
+	volatile float FloatSink;
+	volatile int IntSink;
+
+	/** Spawn the cars on the track, in a fleet made for that amount */
+	void SpawnFleet(ATrack& track, FleetPool& fleet, size_t carsAmount)
+	{
+		const std::vector<Vector2D> spawnPoints = track.GetUniqueSpawnPoints(carsAmount, BenchSeed);
+		for (size_t i = 0; i < spawnPoints.size(); i++)
+			track.RegisterNewCarOnTrack(fleet.Create(track, static_cast<uint32_t>(i), BenchSeed, spawnPoints[i]));
+	}
+
+	/** Random vectors between -range and range, each id give different ones */
+	std::vector<Vector2D> CreateVectors(uint32_t id, float range)
+	{
+		RandomStream random(BenchSeed, id, ERandomPurpose::Benchmarks);
+		std::vector<Vector2D> vectors(InputsAmount);
+		for (Vector2D& vector : vectors)
+			vector = Vector2D(random.Range(-range, range), random.Range(-range, range));
+		return (vectors);
+	}
+
+	std::vector<IntVector2D> CreateIntVectors(uint32_t id, int range)
+	{
+		RandomStream random(BenchSeed, id, ERandomPurpose::Benchmarks);
+		std::vector<IntVector2D> vectors(InputsAmount);
+		for (IntVector2D& vector : vectors)
+			vector = IntVector2D(static_cast<int>(random.Range(0, 2 * range + 1)) - range, static_cast<int>(random.Range(0, 2 * range + 1)) - range);
+		return (vectors);
+	}
+
+	/** A car before the hot/cold split of Car: the members in their declaration order, the cars allocated one after the other */
+	struct PackedCar
+	{
+		uint32_t id;
+		float maxSpeed;
+		float acceleration;
+		Vector2D position;
+		Vector2D forwardVector;
+		float speed;
+	};
+	/** The layout of Car: the constants on the cold cache line, what a move write on the hot one */
+	struct SplitCar
+	{
+		uint32_t id;
+		float maxSpeed;
+		float acceleration;
+		alignas(CACHE_LINE_SIZE) Vector2D position;
+		Vector2D forwardVector;
+		float speed;
+	};
+	static_assert(sizeof(SplitCar) == CACHE_LINE_SIZE * 2, "SplitCar should have the cache lines of Car");
+
+	/** The cars of each thread */
+	constexpr size_t CarsPerThread = 16;
+
+	/** Read the constants of the car, write its state, like Car::Move */
+	template<typename CarType>
+	void MoveCar(CarType& car)
+	{
+		car.speed = (car.speed >= car.maxSpeed ? 0.0f : std::min(car.maxSpeed, car.speed + car.acceleration));
+		car.position += car.forwardVector * car.speed;
+	}
+
+	/** Each thread move its cars movesPerThread times, in nanoseconds per move */
+	template<typename CarType>
+	double MeasureMoves(size_t threadsAmount, uint64_t movesPerThread)
+	{
+		std::vector<CarType> cars(threadsAmount * CarsPerThread);
+		for (size_t i = 0; i < cars.size(); i++)
+			cars[i] = { static_cast<uint32_t>(i), 0.2f, 0.05f, Vector2D(), Vector2D(1.0f, 0.0f), 0.0f };
+
+		Barrier barrier(threadsAmount + 1);
+		std::vector<std::thread> threads;
+		for (size_t threadIndex = 0; threadIndex < threadsAmount; threadIndex++)
+		{
+			threads.emplace_back([&cars, &barrier, threadsAmount, movesPerThread, threadIndex]()
+			{
+				barrier.Wait();
+				for (uint64_t i = 0; i < movesPerThread; i++)
+				{
+					// The cars of the threads are interleaved, like cars spawned one after the other and moved by different threads
+					MoveCar(cars[(i % CarsPerThread) * threadsAmount + threadIndex]);
+					// Every move really write the car, the compiler can't keep it in registers
+					std::atomic_signal_fence(std::memory_order_seq_cst);
+				}
+				barrier.Wait();
+			});
+		}
+		barrier.Wait();
+		const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+		barrier.Wait();
+		const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - startTime;
+		for (std::thread& thread : threads)
+			thread.join();
+
+		FloatSink = cars[0].position.x;
+		return (duration.count() / static_cast<double>(movesPerThread));
+	}
+}
+
+void Bench::RunAll(std::ostream& stream)
+{
+	stream << "Benchmarks, " << BENCHMARK_ITERATIONS << " iterations each" << std::endl;
+	RunVectorOperators(stream);
+	RunFalseSharing(stream);
+	RunFixedPoint(stream);
+	RunRegionScaling(stream);
+}
+
+void Bench::RunVectorOperators(std::ostream& stream)
+{
+	stream << "Vector2D and IntVector2D operators:" << std::endl;
+	const std::vector<Vector2D> a = CreateVectors(0, 100.0f);
+	const std::vector<Vector2D> b = CreateVectors(1, 100.0f);
+	const std::vector<IntVector2D> intA = CreateIntVectors(2, 10000);
+	const std::vector<IntVector2D> intB = CreateIntVectors(3, 10000);
+	// The steering turn by 45 degrees one way or the other, the sign is only known at run time
+	std::vector<float> degrees(InputsAmount);
+	for (size_t i = 0; i < InputsAmount; i++)
+		degrees[i] = (a[i].x >= 0.0f ? 45.0f : -45.0f);
+	const float cos45 = CosDegree(45.0f);
+	constexpr float Angle45 = 3.14159265358979323846f / 4.0f;
+
+	// Each result is written in its own slot, so the calls don't wait for each other
+	std::vector<Vector2D> results(InputsAmount);
+	std::vector<float> scalars(InputsAmount);
+	PrintResult(stream, "Vector2D + Vector2D", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask] = a[i & InputsMask] + b[i & InputsMask]; }));
+	PrintResult(stream, "Vector2D - Vector2D", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask] = a[i & InputsMask] - b[i & InputsMask]; }));
+	PrintResult(stream, "Vector2D * float", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask] = a[i & InputsMask] * b[i & InputsMask].x; }));
+	PrintResult(stream, "Vector2D / float", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask] = a[i & InputsMask] / b[i & InputsMask].x; }));
+	PrintResult(stream, "Vector2D + IntVector2D", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask] = a[i & InputsMask] + intA[i & InputsMask]; }));
+	PrintResult(stream, "Vector2D::Normalize", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask] = a[i & InputsMask].Normalize(); }));
+	PrintResult(stream, "Vector2D::Round", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask] = a[i & InputsMask].Round(); }));
+	PrintResult(stream, "Vector2D == Vector2D", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { scalars[i & InputsMask] = (a[i & InputsMask] == b[(i + 1) & InputsMask] ? 1.0f : 0.0f); }));
+	PrintResult(stream, "Vector2D::Dot", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { scalars[i & InputsMask] = a[i & InputsMask].Dot(b[i & InputsMask]); }));
+	PrintResult(stream, "Vector2D::LengthSquared", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { scalars[i & InputsMask] = a[i & InputsMask].LengthSquared(); }));
+	PrintResult(stream, "Vector2D::Length", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { scalars[i & InputsMask] = a[i & InputsMask].Length(); }));
+
+	// The angle checks of the steering, with the trigonometry and with the dot products only
+	PrintResult(stream, "AngleBetween >= 45 degrees", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { scalars[i & InputsMask] = (a[i & InputsMask].AngleBetween(b[i & InputsMask]) >= Angle45 ? 1.0f : 0.0f); }));
+	PrintResult(stream, "IsAngleWiderThan 45 degrees", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { scalars[i & InputsMask] = (a[i & InputsMask].IsAngleWiderThan(b[i & InputsMask], cos45) ? 1.0f : 0.0f); }));
+
+	// The rotations, in place
+	results = a;
+	PrintResult(stream, "Rotate(+-45)", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask].Rotate(degrees[i & InputsMask]); }));
+	PrintResult(stream, "Rotate45 / RotateMinus45", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i)
+	{
+		Vector2D& vector = results[i & InputsMask];
+		degrees[i & InputsMask] > 0.0f ? vector.Rotate45() : vector.RotateMinus45();
+	}));
+	PrintResult(stream, "Rotate(+-90)", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask].Rotate(degrees[i & InputsMask] * 2.0f); }));
+	PrintResult(stream, "Rotate90 / RotateMinus90", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i)
+	{
+		Vector2D& vector = results[i & InputsMask];
+		degrees[i & InputsMask] > 0.0f ? vector.Rotate90() : vector.RotateMinus90();
+	}));
+	FloatSink = results[0].x + results[InputsAmount - 1].y + scalars[0] + scalars[InputsAmount - 1];
+
+	std::vector<IntVector2D> intResults(InputsAmount);
+	PrintResult(stream, "IntVector2D + IntVector2D", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { intResults[i & InputsMask] = intA[i & InputsMask] + intB[i & InputsMask]; }));
+	PrintResult(stream, "IntVector2D - IntVector2D", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { intResults[i & InputsMask] = intA[i & InputsMask] - intB[i & InputsMask]; }));
+	PrintResult(stream, "IntVector2D * int", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { intResults[i & InputsMask] = intA[i & InputsMask] * static_cast<int>(i & 7); }));
+	PrintResult(stream, "IntVector2D == IntVector2D", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { intResults[i & InputsMask].x = (intA[i & InputsMask] == intB[(i + 1) & InputsMask] ? 1 : 0); }));
+	IntSink = intResults[0].x + intResults[InputsAmount - 1].y;
+}
+
+void Bench::RunFalseSharing(std::ostream& stream)
+{
+	// Nothing is shared with a single thread, at least 2 to see something (and every core to see how bad it get)
+	const size_t threadsAmount = std::max(2u, std::thread::hardware_concurrency());
+	stream << "False sharing, " << threadsAmount << " threads moving " << CarsPerThread << " cars each (time of a move on each thread):" << std::endl;
+	PrintResult(stream, "Packed cars", MeasureMoves<PackedCar>(threadsAmount, BENCHMARK_ITERATIONS));
+	PrintResult(stream, "Cold and hot cache lines (Car)", MeasureMoves<SplitCar>(threadsAmount, BENCHMARK_ITERATIONS));
+}
+
+void Bench::RunFixedPoint(std::ostream& stream)
+{
+	stream << "Float and fixed point car math:" << std::endl;
+	const std::vector<Vector2D> positions = CreateVectors(4, 100.0f);
+	std::vector<Vector2D> forwardVectors = CreateVectors(5, 1.0f);
+	std::vector<float> speeds(InputsAmount);
+	for (size_t i = 0; i < InputsAmount; i++)
+	{
+		forwardVectors[i] = forwardVectors[i].Normalize();
+		speeds[i] = std::abs(positions[i].x) / 500.0f;
+	}
+	std::vector<FixedVector2D> fixedPositions;
+	std::vector<FixedVector2D> fixedForwardVectors;
+	std::vector<Fixed> fixedSpeeds;
+	for (size_t i = 0; i < InputsAmount; i++)
+	{
+		fixedPositions.emplace_back(positions[i]);
+		fixedForwardVectors.emplace_back(forwardVectors[i]);
+		fixedSpeeds.emplace_back(speeds[i]);
+	}
+
+	std::vector<Vector2D> results(InputsAmount);
+	std::vector<FixedVector2D> fixedResults(InputsAmount);
+	std::vector<float> scalars(InputsAmount);
+	std::vector<Fixed> fixedScalars(InputsAmount);
+	PrintResult(stream, "float position + forward * speed", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask] = positions[i & InputsMask] + forwardVectors[i & InputsMask] * speeds[i & InputsMask]; }));
+	PrintResult(stream, "Fixed position + forward * speed", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { fixedResults[i & InputsMask] = fixedPositions[i & InputsMask] + fixedForwardVectors[i & InputsMask] * fixedSpeeds[i & InputsMask]; }));
+	PrintResult(stream, "float Dot", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { scalars[i & InputsMask] = positions[i & InputsMask].Dot(forwardVectors[i & InputsMask]); }));
+	PrintResult(stream, "Fixed Dot", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { fixedScalars[i & InputsMask] = fixedPositions[i & InputsMask].Dot(fixedForwardVectors[i & InputsMask]); }));
+	PrintResult(stream, "float Length", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { scalars[i & InputsMask] = positions[i & InputsMask].Length(); }));
+	PrintResult(stream, "Fixed Length", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { fixedScalars[i & InputsMask] = fixedPositions[i & InputsMask].Length(); }));
+	PrintResult(stream, "float Normalize", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { results[i & InputsMask] = positions[i & InputsMask].Normalize(); }));
+	PrintResult(stream, "Fixed Normalize", Measure(BENCHMARK_ITERATIONS, [&](uint64_t i) { fixedResults[i & InputsMask] = fixedPositions[i & InputsMask].Normalize(); }));
+	FloatSink = results[0].x + scalars[0] + static_cast<float>(fixedResults[0].x) + static_cast<float>(fixedScalars[0]);
+
+	// Move every input DriftStepsAmount times in float, in fixed point and in double (the exact result for both)
+	constexpr int DriftStepsAmount = 1000;
+	double maxFloatDrift = 0.0;
+	double maxFixedDrift = 0.0;
+	for (size_t i = 0; i < InputsAmount; i++)
+	{
+		Vector2D position = positions[i];
+		FixedVector2D fixedPosition = fixedPositions[i];
+		double exactX = positions[i].x;
+		double exactY = positions[i].y;
+		for (int step = 0; step < DriftStepsAmount; step++)
+		{
+			position += forwardVectors[i] * speeds[i];
+			fixedPosition += fixedForwardVectors[i] * fixedSpeeds[i];
+			exactX += static_cast<double>(forwardVectors[i].x) * speeds[i];
+			exactY += static_cast<double>(forwardVectors[i].y) * speeds[i];
+		}
+		const Vector2D fixedAsFloat = static_cast<Vector2D>(fixedPosition);
+		maxFloatDrift = std::max(maxFloatDrift, std::max(std::abs(position.x - exactX), std::abs(position.y - exactY)));
+		maxFixedDrift = std::max(maxFixedDrift, std::max(std::abs(fixedAsFloat.x - exactX), std::abs(fixedAsFloat.y - exactY)));
+	}
+	stream << "  Drift after " << DriftStepsAmount << " steps: float " << std::setprecision(6) << maxFloatDrift << " tiles, Fixed " << maxFixedDrift << " tiles" << std::endl;
+
+	// The whole move of a car, with the coordinates this build use
+	stream << "Car::Move, " << CARS_AMOUNT << " cars on the figure eight:" << std::endl;
+	ATrack track = FigureEightTrack();
+	FleetPool fleet(CARS_AMOUNT);
+	const std::vector<Vector2D> spawnPoints = track.GetUniqueSpawnPoints(CARS_AMOUNT, BenchSeed);
+	for (int i = 0; i < CARS_AMOUNT; i++)
+		track.RegisterNewCarOnTrack(fleet.Create(track, i, BenchSeed, spawnPoints[i]));
+	const std::vector<Car*>& cars = fleet.GetCars();
+	const uint64_t ticksAmount = std::max<uint64_t>(1, BENCHMARK_ITERATIONS / 1000);
+	const double tickDuration = Measure(ticksAmount, [&](uint64_t tick)
+	{
+		track.GetTrafficLight().SetTime(static_cast<double>(tick) * TickDurationInSecond);
+		for (Car* car : cars)
+			car->Move();
+	});
+	PrintResult(stream, FIXED_POINT_COORDINATES ? "Car::Move (Fixed)" : "Car::Move (float)", tickDuration / cars.size());
+}
+
+void Bench::RunRegionScaling(std::ostream& stream)
+{
+	uint64_t tick = 0;
+	const uint64_t ticksAmount = std::max<uint64_t>(1, BENCHMARK_ITERATIONS / 200000);
+
+	// A small fleet, against every car looking at the whole fleet on one thread (SIMULATION_ENGINE 0 without the threads), only a few ticks it's slow
+	{
+		constexpr int MapWidth = 800;
+		constexpr int MapHeight = 200;
+		constexpr size_t CarsAmount = 2000;
+		ATrack track(TrackGenerator::CreateManhattanGrid(MapWidth, MapHeight));
+		FleetPool fleet(CarsAmount);
+		SpawnFleet(track, fleet, CarsAmount);
+		const std::vector<Car*>& cars = fleet.GetCars();
+		stream << "Region engine, " << cars.size() << " cars on a " << MapWidth << "x" << MapHeight << " grid (time of a tick):" << std::endl;
+
+		const double sharedFleetDuration = Measure(std::max<uint64_t>(1, ticksAmount / 10), [&](uint64_t)
+		{
+			track.GetTrafficLight().SetTime(static_cast<double>(tick++) * TickDurationInSecond);
+			for (Car* car : cars)
+				car->Move();
+		});
+		PrintResult(stream, "Whole fleet, 1 thread", sharedFleetDuration);
+		MeasureRegionTicks(stream, track, cars, ticksAmount, tick);
+	}
+
+	// A big fleet, the regions only (the whole fleet would take minutes per tick)
+	{
+		constexpr int MapWidth = 2000;
+		constexpr int MapHeight = 2000;
+		constexpr size_t CarsAmount = 200000;
+		ATrack track(TrackGenerator::CreateManhattanGrid(MapWidth, MapHeight));
+		FleetPool fleet(CarsAmount);
+		SpawnFleet(track, fleet, CarsAmount);
+		stream << "Region engine, " << fleet.GetCars().size() << " cars on a " << MapWidth << "x" << MapHeight << " grid (time of a tick):" << std::endl;
+		MeasureRegionTicks(stream, track, fleet.GetCars(), std::max<uint64_t>(1, ticksAmount / 10), tick);
+	}
+}
+
+void Bench::MeasureRegionTicks(std::ostream& stream, ATrack& track, const std::vector<Car*>& cars, uint64_t ticksAmount, uint64_t& inOutTick)
+{
+	// The cars keep going from where the previous run left them, every run see about the same traffic
+	// 1, 2, 4... threads up to every core, and at least up to 4 (past the cores it only show what the barriers cost)
+	const unsigned int coresAmount = std::max(1u, std::thread::hardware_concurrency());
+	const unsigned int maxThreadsAmount = std::max(4u, coresAmount);
+	std::vector<unsigned int> threadsAmounts;
+	for (unsigned int threadsAmount = 1; threadsAmount < maxThreadsAmount; threadsAmount *= 2)
+		threadsAmounts.push_back(threadsAmount);
+	threadsAmounts.push_back(maxThreadsAmount);
+
+	double oneThreadDuration = 0.0;
+	for (unsigned int threadsAmount : threadsAmounts)
+	{
+		RegionEngine engine(track, cars, threadsAmount);
+		const double tickDuration = Measure(ticksAmount, [&](uint64_t)
+		{
+			track.GetTrafficLight().SetTime(static_cast<double>(inOutTick++) * TickDurationInSecond);
+			engine.Tick();
+		});
+		const std::string name = "Regions, " + std::to_string(engine.GetThreadsAmount()) + (engine.GetThreadsAmount() == 1 ? " thread" : " threads");
+		PrintResult(stream, name.c_str(), tickDuration);
+		if (threadsAmount == 1)
+			oneThreadDuration = tickDuration;
+		else
+			stream << "    " << std::setprecision(2) << oneThreadDuration / tickDuration << "x the regions on 1 thread"
+				<< (engine.GetThreadsAmount() > coresAmount ? " (more threads than cores)" : "") << std::endl;
+	}
+}
+
+void Bench::PrintResult(std::ostream& stream, const char* name, double nanoseconds)
+{
+	// The ticks of the big maps are better read in milliseconds
+	const bool isLong = (nanoseconds >= 1000000.0);
+	stream << "  " << std::left << std::setw(32) << name << std::right << std::fixed << std::setprecision(2) << std::setw(8)
+		<< (isLong ? nanoseconds / 1000000.0 : nanoseconds) << (isLong ? " ms" : " ns") << std::endl;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Defines.h"
+
+#include <chrono>
+#include <ostream>
+#include <cstdint>
+#include <vector>
+
+class ATrack;
+class Car;
+
+/**
+ * Microbenchmarks of the hot code, run instead of the simulation with RUN_BENCHMARKS.
+ * Each one time the versions it compare on the same inputs and print the time per operation.
+ * The inputs are random and generated before the timing, and every result end up in a sink, so the compiler can't fold the work away.
+ */
+class Bench
+{
+
+public:
+	/** Run every benchmark and print the results */
+	static void RunAll(std::ostream& stream);
+
+private:
+	/** Each operator of Vector2D and IntVector2D, and the trigonometry the fixed rotations and IsAngleWiderThan replace */
+	static void RunVectorOperators(std::ostream& stream);
+	/** Threads moving their own cars, with the cars packed one after the other (before the hot/cold split of Car) and with the layout of Car */
+	static void RunFalseSharing(std::ostream& stream);
+	/**
+	 * The car math in float and in fixed point (see FIXED_POINT_COORDINATES), how far both drift from the exact result,
+	 * and Car::Move on the figure eight with the coordinates of this build.
+	 */
+	static void RunFixedPoint(std::ostream& stream);
+	/**
+	 * The ticks of RegionEngine for every amount of threads up to the cores: with a small fleet against the whole fleet on one thread,
+	 * and with a big fleet on a big generated grid.
+	 */
+	static void RunRegionScaling(std::ostream& stream);
+	/** The ticks of RegionEngine with 1, 2, 4... threads, the simulated time go on from inOutTick */
+	static void MeasureRegionTicks(std::ostream& stream, ATrack& track, const std::vector<Car*>& cars, uint64_t ticksAmount, uint64_t& inOutTick);
+
+	/** Time the function called iterationsAmount times (with the index of the call), in nanoseconds per call */
+	template<typename Function>
+	static double Measure(uint64_t iterationsAmount, Function&& function)
+	{
+		const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+		for (uint64_t i = 0; i < iterationsAmount; i++)
+			function(i);
+		const std::chrono::duration<double, std::nano> duration = std::chrono::steady_clock::now() - startTime;
+		return (duration.count() / static_cast<double>(iterationsAmount));
+	}
+	/** Print the time of an operation, in milliseconds past 1 ms */
+	static void PrintResult(std::ostream& stream, const char* name, double nanoseconds);
+};
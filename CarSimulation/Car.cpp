@@ -1,33 +1,77 @@
 #include "Car.h"
+#include "IntersectionManager.h"
 
-Car::Car(const ATrack& track, uint8_t id, Vector2D spawnPoint, float acceleration, float maxSpeed)
+namespace
+{
+	/** std::abs for both kinds of CarScalar */
+	CarScalar Abs(CarScalar value)
+	{
+#if FIXED_POINT_COORDINATES
+		return (value.Abs());
+#else
+		return (std::abs(value));
+#endif
+	}
+
+	/**
+	 * Whether a point going from startOffset to startOffset + step get closer than the distance to the origin
+	 * (no square root, the closest time is clamped to the step). The points starting closer than that are ignored.
+	 */
+	bool IsPassingCloserThan(const CarVector& startOffset, const CarVector& step, CarScalar distanceSquared)
+	{
+		if (startOffset.LengthSquared() < distanceSquared)
+			return (false);
+		const CarScalar stepLengthSquared = step.LengthSquared();
+		if (stepLengthSquared == 0.0f)
+			return (false);
+		CarScalar closestTime = -startOffset.Dot(step) / stepLengthSquared;
+		closestTime = std::min(CarScalar(1.0f), std::max(CarScalar(0.0f), closestTime));
+		return ((startOffset + step * closestTime).LengthSquared() < distanceSquared);
+	}
+}
+
+Car::Car(const ATrack& track, uint32_t id, uint64_t seed, Vector2D spawnPoint, float acceleration, float maxSpeed)
+	: Car(track, id, spawnPoint, RandomStream(seed, id, ERandomPurpose::CarParameters), acceleration, maxSpeed)
+{}
+
+Car::Car(const ATrack& track, uint32_t id, Vector2D spawnPoint, RandomStream&& random, float acceleration, float maxSpeed)
 	: m_Track(track),
 	m_Id(id),
-	m_Position(spawnPoint),
-	// TODO: fix the random to be more evenly random (using std::max will just clamp the low value which make getting the lowest value more likely)
-	m_MaxSpeed(CLAMP(CAR_MIN_MAXSPEED, CAR_MAX_MAXSPEED, maxSpeed == -1 ? static_cast<float>(std::rand()) / RAND_MAX : maxSpeed)),
-	m_Acceleration(CLAMP(CAR_MIN_ACCELERATION, CAR_MAX_ACCELERATION, acceleration == -1 ? static_cast<float>(std::rand()) / RAND_MAX : acceleration))
+	// Draw the missing parameters evenly in their range (explicit values are still clamped)
+	m_MaxSpeed(CarScalar(maxSpeed == -1 ? random.Range(CAR_MIN_MAXSPEED, CAR_MAX_MAXSPEED) : CLAMP(CAR_MIN_MAXSPEED, CAR_MAX_MAXSPEED, maxSpeed))),
+	m_Acceleration(CarScalar(acceleration == -1 ? random.Range(CAR_MIN_ACCELERATION, CAR_MAX_ACCELERATION) : CLAMP(CAR_MIN_ACCELERATION, CAR_MAX_ACCELERATION, acceleration))),
+	m_Position(CarVector(spawnPoint))
 {
+#if LOG_EACH_CAR_SPAWN && BATCH_MODE == 0 && RUN_BENCHMARKS == 0
+	// '\n' instead of std::endl, no need to flush for every car
 	std::cout << "Car " << GetDisplayChar() << " spawned at " << m_Position
 		<< " maxspeed: " << m_MaxSpeed << " acceleration: " << m_Acceleration
-		<< std::endl;
+		<< '\n';
+#endif
 	IntVector2D currentTrackTilePosition = m_Track.MapPositionOnTrack(m_Position);
 	char currentTrackTileDirectionChar = m_Track.GetTrackChar(currentTrackTilePosition);
 
 	m_ForwardVector = GetDirectionVector(currentTrackTileDirectionChar);
 	m_LastTrackDirection = currentTrackTileDirectionChar;
+	PublishState();
 }
 
 Car::Car(const Car& other)
 	: m_Track(other.m_Track),
 	m_Id(other.m_Id),
-	m_Position(other.m_Position),
 	m_MaxSpeed(other.m_MaxSpeed),
 	m_Acceleration(other.m_Acceleration),
-	m_Speed(other.m_Speed),
+	m_Position(other.m_Position),
 	m_ForwardVector(other.m_ForwardVector),
-	m_LastTrackDirection(other.m_LastTrackDirection)
-{}
+	m_Speed(other.m_Speed),
+	m_LastTrackDirection(other.m_LastTrackDirection),
+	m_LastMoveResult(other.m_LastMoveResult),
+	m_IsHeldBack(other.m_IsHeldBack),
+	m_BlockingCarId(other.m_BlockingCarId),
+	m_LaneChangesAmount(other.m_LaneChangesAmount)
+{
+	PublishState();
+}
 
 Car& Car::operator=(const Car& other)
 {
@@ -35,77 +79,106 @@ Car& Car::operator=(const Car& other)
 	m_Speed = other.m_Speed;
 	m_ForwardVector = other.m_ForwardVector;
 	m_LastTrackDirection = other.m_LastTrackDirection;
+	m_LastMoveResult = other.m_LastMoveResult;
+	m_IsHeldBack = other.m_IsHeldBack;
+	m_BlockingCarId = other.m_BlockingCarId;
+	m_LaneChangesAmount = other.m_LaneChangesAmount;
+	PublishState();
 	return *this;
 }
 
-void Car::Move()
+EMoveResult Car::Move(const std::vector<const Car*>& nearbyCars, double deltaTimeInSecond)
 {
+	assert(deltaTimeInSecond > 0.0);
+	const CarScalar stepTicks = CarScalar(static_cast<float>(deltaTimeInSecond / TickDurationInSecond));
+
 	IntVector2D currentTrackTilePosition = m_Track.MapPositionOnTrack(m_Position);
 	char currentTrackTileDirectionChar = m_Track.GetTrackChar(currentTrackTilePosition);
+	m_IsHeldBack = false;
 
 	// Accelerate or stop the car if there is an intersection ahead
 	// TODO: implement deceleration instead of instant stop
 	if (IsNextTileAnIntersection(currentTrackTilePosition, GetDirectionVector(m_LastTrackDirection))
-		&& currentTrackTileDirectionChar != INTERSECTION
-		&& IsNextIntersectionRedLightForMe(m_LastTrackDirection) == false)
+		&& currentTrackTileDirectionChar != INTERSECTION)
 	{
-		m_Speed = 0.0f;
-		return;
+		// Without intersection manager the lights decide, otherwise we need the time slots of the intersection
+		IntersectionManager* intersectionManager = m_Track.GetIntersectionManager();
+		EMoveResult stopReason = EMoveResult::Moving;
+		if (intersectionManager == nullptr && m_Track.GetTrafficLight().IsGreenFor(m_LastTrackDirection) == false)
+			stopReason = EMoveResult::StoppedAtRedLight;
+		else if (intersectionManager && intersectionManager->TryReserve(*this, currentTrackTilePosition + GetDirectionVector(m_LastTrackDirection) * 2, nearbyCars) == false)
+			stopReason = EMoveResult::WaitingForReservation;
+		if (stopReason != EMoveResult::Moving)
+		{
+			m_Speed = 0.0f;
+			m_LastMoveResult = stopReason;
+			PublishState();
+			return (m_LastMoveResult);
+		}
 	}
 
-	// Accelerate
-	float newSpeed = std::min(m_MaxSpeed, m_Speed + m_Acceleration * m_MaxSpeed);
+	// Accelerate, then from here on the car work with the length of its step (the speed is the step over the ticks of the step)
+	CarScalar newSpeed = std::min(m_MaxSpeed, m_Speed + m_Acceleration * m_MaxSpeed * stepTicks);
+	newSpeed = newSpeed * stepTicks;
 
 	// Get target point, where do we want to go next (forward)
-	Vector2D newDirection;
+	CarVector newDirection;
 	if (currentTrackTileDirectionChar != CENTER)
-		newDirection = FindNextDirection(currentTrackTilePosition);
+		newDirection = FindNextDirection(currentTrackTilePosition, stepTicks);
 	else
 	{
 		// In case something wrong happen we keep our current direction
 		// but if were leaving the map we change the direction toward the center of the map
 		if (m_Track.IsHereInMapBounds(currentTrackTilePosition))
-			m_ForwardVector = m_Position - m_Track.GetMapCenter();
+			m_ForwardVector = m_Position - CarVector(m_Track.GetMapCenter());
 		newDirection = m_ForwardVector;
 	}
 
 #if DRIVING_MODE == 0 // no collision just follow the road
-	m_Speed = newSpeed;
+	m_Speed = newSpeed / stepTicks;
 	m_ForwardVector = newDirection;
-	m_Position = m_Position + newDirection * Vector2D(newSpeed);
+	m_Position = m_Position + newDirection * CarVector(newSpeed);
 #elif DRIVING_MODE == 1 // collision detection (traffic jam simulator)
 	// Compute new position
-	Vector2D positionToCheck = m_Position + newDirection * Vector2D(newSpeed + SAFE_DISTANCE_BETWEEN_CARS);
+	CarVector positionToCheck = m_Position + newDirection * CarVector(newSpeed + SAFE_DISTANCE_BETWEEN_CARS);
 
-	float extraCollidingDistance;
-	if (IsCollidingWithOtherCar(positionToCheck, m_Track.GetCarsOnTrack(), &extraCollidingDistance))
-		newSpeed = CalculateMaxSpeedWithoutCollision(newSpeed - extraCollidingDistance, newDirection);
+	CarScalar extraCollidingDistance;
+	bool isBlocked = false;
+	if (IsCollidingWithOtherCar(positionToCheck, nearbyCars, &extraCollidingDistance, &m_BlockingCarId))
+	{
+		newSpeed = CalculateMaxSpeedWithoutCollision(newSpeed - extraCollidingDistance, newDirection, nearbyCars);
+		isBlocked = (newSpeed == 0.0f);
+		m_IsHeldBack = true;
+	}
+	LimitStepToSweep(newDirection, stepTicks, newSpeed, isBlocked, nearbyCars);
 
 	// Move the car
-	m_Position += newDirection * Vector2D(newSpeed);
+	m_Position += newDirection * CarVector(newSpeed);
 	m_ForwardVector = newDirection;
-	m_Speed = newSpeed;
+	m_Speed = newSpeed / stepTicks;
 
 #else // collision + lane change (Work In Progress)
 	// Compute new position
-	Vector2D positionToCheck = m_Position + newDirection * Vector2D(newSpeed + SAFE_DISTANCE_BETWEEN_CARS);
+	CarVector positionToCheck = m_Position + newDirection * CarVector(newSpeed + SAFE_DISTANCE_BETWEEN_CARS);
 
-	float extraCollidingDistance;
-	if (IsCollidingWithOtherCar(positionToCheck, m_Track.GetCarsOnTrack(), &extraCollidingDistance))
+	CarScalar extraCollidingDistance;
+	bool isBlocked = false;
+	if (IsCollidingWithOtherCar(positionToCheck, nearbyCars, &extraCollidingDistance, &m_BlockingCarId))
 	{
 		// If there is a car in front of you try to change lane
-		Vector2D newLaneDirection = FindNextLaneDirection(currentTrackTilePosition, currentTrackTileDirectionChar);
+		CarVector newLaneDirection = FindNextLaneDirection(currentTrackTilePosition, currentTrackTileDirectionChar);
 
-		if (newLaneDirection != Vector2D::Zero)
+		if (newLaneDirection != CarVector::Zero)
 		{
 			// Compute position when changing lane
-			positionToCheck = m_Position + newLaneDirection * Vector2D(newSpeed);
+			positionToCheck = m_Position + newLaneDirection * CarVector(newSpeed);
 
 			// check if it collide with any of the cars
-			if (IsCollidingWithOtherCar(positionToCheck, m_Track.GetCarsOnTrack()))
+			if (IsCollidingWithOtherCar(positionToCheck, nearbyCars))
 			{
 				// Slow down to avoid crashing into the car in front of you
-				newSpeed = CalculateMaxSpeedWithoutCollision(newSpeed - extraCollidingDistance, newDirection);
+				newSpeed = CalculateMaxSpeedWithoutCollision(newSpeed - extraCollidingDistance, newDirection, nearbyCars);
+				m_IsHeldBack = true;
 			}
 			else if (m_Track.GetTrackChar(m_Track.MapPositionOnTrack(positionToCheck)) == CENTER)
 			{
@@ -115,72 +188,200 @@ void Car::Move()
 			else
 			{
 				newDirection = newLaneDirection;
+				m_LaneChangesAmount++;
 			}
 		}
 		else
+		{
 			// Slow down to avoid crashing into the car in front of you
-			newSpeed = CalculateMaxSpeedWithoutCollision(newSpeed - extraCollidingDistance, newDirection);
+			newSpeed = CalculateMaxSpeedWithoutCollision(newSpeed - extraCollidingDistance, newDirection, nearbyCars);
+			m_IsHeldBack = true;
+		}
+		isBlocked = (newSpeed == 0.0f);
 	}
+	LimitStepToSweep(newDirection, stepTicks, newSpeed, isBlocked, nearbyCars);
 
 	// Move the car
-	m_Position += newDirection * Vector2D(newSpeed);
+	m_Position += newDirection * CarVector(newSpeed);
 	m_ForwardVector = newDirection;
-	m_Speed = newSpeed;
+	m_Speed = newSpeed / stepTicks;
 #endif
 
 	// Update directionChar
 	m_LastTrackDirection = GetDirectionChar();
+#if DRIVING_MODE == 0
+	m_LastMoveResult = EMoveResult::Moving;
+#else
+	m_LastMoveResult = (isBlocked ? EMoveResult::BlockedByCar : EMoveResult::Moving);
+#endif
+	PublishState();
+	return (m_LastMoveResult);
+}
+
+int Car::FindCoastingSteps(int maxSteps, const std::vector<const Car*>& nearbyCars) const
+{
+	// Still accelerating (or stopped), every step is different
+	if (m_Speed <= 0.0f || m_Speed < m_MaxSpeed)
+		return (0);
+
+	IntVector2D trackTilePosition = m_Track.MapPositionOnTrack(m_Position);
+	char trackDirectionChar = m_Track.GetTrackChar(trackTilePosition);
+	if (m_Track.IsRoad(trackDirectionChar) == false || trackDirectionChar == INTERSECTION)
+		return (0);
+
+	// We have to be heading exactly along the lane (FindNextDirection will then keep the same direction)
+	IntVector2D trackDirectionVector = GetDirectionVector(trackDirectionChar);
+	CarVector laneDirection = CarVector(trackDirectionVector).Normalize();
+	if ((m_ForwardVector - laneDirection).LengthSquared() > 1e-8f)
+		return (0);
+
+	// Find the last tile of the straight line, stopping before the tiles where Move would check the traffic light
+	IntVector2D lastTilePosition = trackTilePosition;
+	if (IsNextTileAnIntersection(lastTilePosition, trackDirectionVector))
+		return (0);
+	while (m_Track.GetTrackChar(lastTilePosition + trackDirectionVector) == trackDirectionChar
+		&& IsNextTileAnIntersection(lastTilePosition + trackDirectionVector, trackDirectionVector) == false
+		&& (lastTilePosition - trackTilePosition).LengthSquared() < maxSteps * maxSteps)
+		lastTilePosition += trackDirectionVector;
+
+	// Distance before leaving the last tile (the first axis to cross the tile border)
+	CarScalar distanceLeft = std::numeric_limits<CarScalar>::max();
+	if (laneDirection.x != 0.0f)
+	{
+		CarScalar border = static_cast<CarScalar>(trackDirectionVector.x > 0 ? lastTilePosition.x + 1 : lastTilePosition.x);
+		distanceLeft = std::min(distanceLeft, (border - m_Position.x) / laneDirection.x);
+	}
+	if (laneDirection.y != 0.0f)
+	{
+		CarScalar border = static_cast<CarScalar>(trackDirectionVector.y > 0 ? lastTilePosition.y + 1 : lastTilePosition.y);
+		distanceLeft = std::min(distanceLeft, (border - m_Position.y) / laneDirection.y);
+	}
+
+	// Do not get closer to the cars ahead (in our lane or the next one, it may change lane) than what Move would allow
+	constexpr CarScalar CorridorHalfWidth = CoastingCorridorHalfWidth;
+	constexpr CarScalar MinimumDistanceBetweenCars = CAR_SIZE_RADIUS * 2.0f + SAFE_DISTANCE_BETWEEN_CARS * 2.0f;
+	for (const Car* car : nearbyCars)
+	{
+		if (car->GetId() == m_Id)
+			continue;
+
+		CarVector vectorBetween = CarVector(car->GetPosition()) - m_Position;
+		CarScalar distanceAhead = vectorBetween.Dot(laneDirection);
+		CarScalar distanceAside = Abs(vectorBetween.x * laneDirection.y - vectorBetween.y * laneDirection.x);
+		if (distanceAhead <= 0.0f || distanceAside > CorridorHalfWidth)
+			continue;
+		// The next normal Move will also look 1 step ahead
+		distanceLeft = std::min(distanceLeft, distanceAhead - MinimumDistanceBetweenCars - m_Speed);
+	}
+
+	if (distanceLeft <= 0.0f)
+		return (0);
+	return (std::min(maxSteps, static_cast<int>(distanceLeft / m_Speed)));
+}
+
+void Car::Coast(int steps)
+{
+	m_Position += m_ForwardVector * (m_Speed * static_cast<CarScalar>(steps));
+	m_LastTrackDirection = GetDirectionChar();
+	m_IsHeldBack = false;
+	PublishState();
 }
 
-bool Car::IsColliding(const std::shared_ptr<Car>& car) const
+bool Car::CanFollowInPlatoon(const Car& leader) const
 {
-	Vector2D vectorBetween = car->GetPosition() - m_Position;
-	float carsMininumDistanceRequired = CAR_SIZE_RADIUS * 2.0f;
-	return (vectorBetween.Length() <= carsMininumDistanceRequired);
+	// Slowed down by that car during the last move (or already carried by it), and that car is driving at a speed we can follow
+	const CarKinematicState leaderState = leader.GetState();
+	if (m_IsHeldBack == false || m_BlockingCarId != leader.GetId()
+		|| leaderState.lastMoveResult != EMoveResult::Moving || leaderState.speed <= 0.0f || CarScalar(leaderState.speed) > m_MaxSpeed)
+		return (false);
+
+	IntVector2D trackTilePosition = m_Track.MapPositionOnTrack(m_Position);
+	char trackDirectionChar = m_Track.GetTrackChar(trackTilePosition);
+	if (m_Track.IsRoad(trackDirectionChar) == false || trackDirectionChar == INTERSECTION)
+		return (false);
+
+	// Both heading exactly along the lane, the leader on our tile or the next one of the same lane
+	IntVector2D trackDirectionVector = GetDirectionVector(trackDirectionChar);
+	CarVector laneDirection = CarVector(trackDirectionVector).Normalize();
+	if ((m_ForwardVector - laneDirection).LengthSquared() > 1e-8f || (CarVector(leaderState.forwardVector) - laneDirection).LengthSquared() > 1e-8f)
+		return (false);
+	IntVector2D leaderTilePosition = m_Track.MapPositionOnTrack(leaderState.position);
+	if ((leaderTilePosition != trackTilePosition && leaderTilePosition != trackTilePosition + trackDirectionVector)
+		|| m_Track.GetTrackChar(leaderTilePosition) != trackDirectionChar)
+		return (false);
+
+	return (IsNextTileAnIntersection(trackTilePosition, trackDirectionVector) == false);
+}
+
+void Car::MoveWith(const Car& leader)
+{
+	const CarKinematicState leaderState = leader.GetState();
+	m_Position += CarVector(leaderState.forwardVector) * CarScalar(leaderState.speed);
+	m_ForwardVector = CarVector(leaderState.forwardVector);
+	m_Speed = CarScalar(leaderState.speed);
+	m_LastTrackDirection = GetDirectionChar();
+	m_LastMoveResult = EMoveResult::Moving;
+	m_IsHeldBack = true;
+	m_BlockingCarId = leader.GetId();
+	PublishState();
 }
 
-float Car::FindExtraDistanceBetweenCars(const std::shared_ptr<Car>& car, const Vector2D& fromThisPosition) const
+void Car::ApplyState(const CarKinematicState& state, char lastTrackDirection)
 {
-	Vector2D vectorBetween = car->GetPosition() - fromThisPosition;
-	float carsMininumDistanceRequired = CAR_SIZE_RADIUS * 2.0f;
+	m_Position = CarVector(state.position);
+	m_ForwardVector = CarVector(state.forwardVector);
+	m_Speed = CarScalar(state.speed);
+	m_LaneChangesAmount = state.laneChangesAmount;
+	m_LastMoveResult = state.lastMoveResult;
+	m_LastTrackDirection = lastTrackDirection;
+	m_IsHeldBack = false;
+	PublishState();
+}
+
+bool Car::IsColliding(const Car& car) const
+{
+	// Can be called from other threads, only use the published states
+	Vector2D vectorBetween = car.GetPosition() - GetPosition();
+	constexpr float carsMininumDistanceRequired = CAR_SIZE_RADIUS * 2.0f;
+	return (vectorBetween.LengthSquared() <= carsMininumDistanceRequired * carsMininumDistanceRequired);
+}
+
+CarScalar Car::FindExtraDistanceBetweenCars(const Car& car, const CarVector& fromThisPosition) const
+{
+	CarVector vectorBetween = CarVector(car.GetPosition()) - fromThisPosition;
+	CarScalar carsMininumDistanceRequired = CAR_SIZE_RADIUS * 2.0f;
+#if FIXED_POINT_COORDINATES
+	// The fixed point length is already exact (rounded down to 1 / 65536)
+	return (vectorBetween.Length() - carsMininumDistanceRequired);
+#else
 	// Here there is a bug :D
 	// when 2 cars follow each other too much the gab bewteen the vector length and the carsMinimumDistanceRequired is too small and the floating point bug
 	// Example that I saw vector length equal 0.49999998 - 0.5000000 then the result became -2.21546894616e-8
 	// TODO: Fix that if possible even though rounding is working pretty good
 	float roundedVectorBetweenLengthFloat = std::round(vectorBetween.Length() * 10000.0f) / 10000.0f;
 	return (roundedVectorBetweenLengthFloat - carsMininumDistanceRequired);
+#endif
 }
 
-Vector2D Car::FindNextLaneDirection(const IntVector2D& currentTrackTilePosition, char currentTrackTileDirectionChar) const
+CarVector Car::FindNextLaneDirection(const IntVector2D& currentTrackTilePosition, char currentTrackTileDirectionChar) const
 {
-	// Get road direction
-	Vector2D newLaneDirection = GetDirectionVector(currentTrackTileDirectionChar).Normalize();
-	if (newLaneDirection == Vector2D::Zero)
-		return Vector2D::Zero;
-
-	// Rotate the vector to 45 degree
-	newLaneDirection = newLaneDirection.Rotate(45.0f);
-	IntVector2D tilePosition = m_Track.MapPositionOnTrack(currentTrackTilePosition + newLaneDirection);
-	// Check if it's a road, and if it is check if the road is going in the same direction
+	// The lanes next to each tile are known since the map was made (see TileFlags), first the one at 45 degree then the one at -45 degree
 	// TODO: handle the case where the next lane direction is less than 45 degree from the current direction
-	if (m_Track.IsHereARoad(tilePosition) == false
-		|| m_Track.GetTrackChar(tilePosition) != currentTrackTileDirectionChar)
-	{
-		// Rotate the vector to -45 degree
-		newLaneDirection = newLaneDirection.Rotate(-90.0f);
-		tilePosition = m_Track.MapPositionOnTrack(currentTrackTilePosition + newLaneDirection);
-		if (m_Track.IsHereARoad(tilePosition) == false
-			|| m_Track.GetTrackChar(tilePosition) != currentTrackTileDirectionChar)
-			return Vector2D::Zero;
-	}
-
-	return ((tilePosition + Vector2D(0.5f, 0.5f)) - m_Position).Normalize();
+	const uint8_t tileFlags = m_Track.GetTileFlags(currentTrackTilePosition);
+	IntVector2D tilePosition;
+	if ((tileFlags & TileFlags::LaneClockwise) != 0)
+		tilePosition = currentTrackTilePosition + GetDirectionVector(RotateDirectionChar45(currentTrackTileDirectionChar, true));
+	else if ((tileFlags & TileFlags::LaneCounterClockwise) != 0)
+		tilePosition = currentTrackTilePosition + GetDirectionVector(RotateDirectionChar45(currentTrackTileDirectionChar, false));
+	else
+		return CarVector::Zero;
+	return (CarVector(tilePosition + Vector2D(0.5f, 0.5f)) - m_Position).Normalize();
 }
 
-float Car::CalculateMaxSpeedWithoutCollision(float currentSpeed, const Vector2D& direction) const
+CarScalar Car::CalculateMaxSpeedWithoutCollision(CarScalar currentSpeed, const CarVector& direction, const std::vector<const Car*>& cars) const
 {
-	float bestSpeed = currentSpeed;
-	float extraSpeed;
+	CarScalar bestSpeed = currentSpeed;
+	CarScalar extraSpeed;
 	bool isColliding;
 
 	int i = 0;
@@ -196,93 +397,120 @@ float Car::CalculateMaxSpeedWithoutCollision(float currentSpeed, const Vector2D&
 			break;
 		}
 		isColliding = IsCollidingWithOtherCar(
-			m_Position + direction * Vector2D(bestSpeed),
-			m_Track.GetCarsOnTrack(), &extraSpeed);
+			m_Position + direction * CarVector(bestSpeed),
+			cars, &extraSpeed);
 		if (isColliding)
 			bestSpeed -= extraSpeed;
 
 	} while (isColliding && bestSpeed > 0.0f);
 
-	return std::max(0.0f, bestSpeed - SAFE_DISTANCE_BETWEEN_CARS);
+	return std::max(CarScalar(0.0f), bestSpeed - SAFE_DISTANCE_BETWEEN_CARS);
 }
 
-bool Car::IsCollidingWithOtherCar(const Vector2D& position, const std::vector<std::weak_ptr<Car>>& cars, float* outExtraDistance) const
+bool Car::IsCollidingWithOtherCar(const CarVector& position, const std::vector<const Car*>& cars, CarScalar* outExtraDistance, uint32_t* outClosestCarId) const
 {
-	float closestCarDistance = std::numeric_limits<float>::max();
-	std::shared_ptr<Car> closestCar;
+	CarScalar closestCarDistanceSquared = std::numeric_limits<CarScalar>::max();
+	const Car* closestCar = nullptr;
 
-	// Find the closestCar car
-	for (auto carPtr: m_Track.GetCarsOnTrack())
+	// Find the closestCar car (comparing the squared distances, only the closest one need the real distance)
+	for (const Car* car : cars)
 	{
-		auto car = carPtr.lock();
-
 		// Do not check collision with himself
 		if (car->GetId() == m_Id)
 			continue;
 
-		float distanceBetweenCars = FindExtraDistanceBetweenCars(car, position);
-		if (distanceBetweenCars < closestCarDistance)
+		CarScalar distanceBetweenCarsSquared = (CarVector(car->GetPosition()) - position).LengthSquared();
+		if (distanceBetweenCarsSquared < closestCarDistanceSquared)
 		{
-			closestCarDistance = distanceBetweenCars;
+			closestCarDistanceSquared = distanceBetweenCarsSquared;
 			closestCar = car;
 		}
 	}
+	if (closestCar == nullptr)
+		return (false);
+
+	CarScalar closestCarDistance = FindExtraDistanceBetweenCars(*closestCar, position);
 	// Avoid getting to close from other cars
 	closestCarDistance -= SAFE_DISTANCE_BETWEEN_CARS;
-	if (closestCarDistance >= 0.0)
+	if (closestCarDistance >= 0.0f)
 		return (false);
 
 	if (outExtraDistance)
 		*outExtraDistance = -closestCarDistance;
+	if (outClosestCarId)
+		*outClosestCarId = closestCar->GetId();
 	return (true);
 }
 
-bool Car::IsNextTileAnIntersection(const IntVector2D& currentTrackTilePosition, const IntVector2D& trackTileDirectionVector) const
+bool Car::IsSweepingThroughOtherCar(const CarVector& step, CarScalar stepTicks, const std::vector<const Car*>& cars, uint32_t* outCarId) const
 {
-	// In fact we check two tiles ahead because otherwise we get too close from the intersection and other car may see us as an obstacle
-	return (m_Track.GetTrackChar(currentTrackTilePosition + trackTileDirectionVector * 2) == INTERSECTION);
-}
+	constexpr float CarsMininumDistanceRequired = CAR_SIZE_RADIUS * 2.0f;
+	const CarScalar minimumDistanceSquared = CarScalar(CarsMininumDistanceRequired * CarsMininumDistanceRequired);
+	const CarScalar stepLength = step.Length();
 
-bool Car::IsNextIntersectionRedLightForMe(char trackDirectionChar) const
-{
-	constexpr int LightSwitchIntervalInSecond = 5;
-	constexpr uint64_t NumberOfSecondInAMinute = 60ui64;
+	for (const Car* car : cars)
+	{
+		// Do not check collision with himself
+		if (car->GetId() == m_Id)
+			continue;
 
-	// Calculate at which second were at in the current minute
-	uint64_t amountOfSecondsSinceEpoch = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
-	int amountOfSecondsElapseInCurrentMinute = static_cast<int>(amountOfSecondsSinceEpoch % NumberOfSecondInAMinute);
+		const CarKinematicState state = car->GetState();
+		const CarVector otherPosition = CarVector(state.position);
+		// Too far to be reached by the two steps
+		const CarScalar otherStepLength = CarScalar(state.speed) * stepTicks;
+		const CarScalar reach = stepLength + otherStepLength + CarScalar(CarsMininumDistanceRequired);
+		if ((otherPosition - m_Position).LengthSquared() > reach * reach)
+			continue;
 
-	int moduloIndex = GetTraficLightModuloIndex(trackDirectionChar);
-	if ((amountOfSecondsElapseInCurrentMinute / LightSwitchIntervalInSecond) % 4 == moduloIndex)
-		return true;
-	return false;
+		// Seen from this car, the other car go from startOffset to startOffset + relativeStep during the tick
+		// if it already moved, or stay where it is if it did not yet (it will check our step when it move), both are checked
+		const CarVector otherStep = CarVector(state.forwardVector) * otherStepLength;
+		if (IsPassingCloserThan(otherPosition - otherStep - m_Position, otherStep - step, minimumDistanceSquared)
+			|| IsPassingCloserThan(otherPosition - m_Position, -step, minimumDistanceSquared))
+		{
+			if (outCarId)
+				*outCarId = car->GetId();
+			return (true);
+		}
+	}
+	return (false);
 }
 
-int Car::GetTraficLightModuloIndex(const char trackDirectionChar) const
+void Car::LimitStepToSweep(const CarVector& direction, CarScalar stepTicks, CarScalar& inOutStepLength, bool& inOutIsBlocked, const std::vector<const Car*>& cars)
 {
-	// We assume that the traffic light is always a 4 way intersection (2 input, 2 output)
-	// and that it's either on diagonal or normal (no mix)
-	// note that the index are either 0 or 2 that's because we want a delay to allow the car to go through before allowing the other car to go through
-	if (trackDirectionChar == RIGHT_DOWN || trackDirectionChar == LEFT_UP)
-		return 0;
-	else if (trackDirectionChar == UP_RIGHT || trackDirectionChar == DOWN_LEFT)
-		return 2;
-	else if (trackDirectionChar == RIGHT || trackDirectionChar == LEFT)
-		return 0;
-	else if (trackDirectionChar == UP || trackDirectionChar == DOWN)
-		return 2;
-
-	assert(false);
+#if CONTINUOUS_COLLISION_DETECTION
+	// Halving keep the direction and the car behind the other one, a few times is enough to stop short of it
+	constexpr int MaxHalvingsAmount = 4;
+	int halvingsAmount = 0;
+	while (inOutStepLength > 0.0f && IsSweepingThroughOtherCar(direction * CarVector(inOutStepLength), stepTicks, cars, &m_BlockingCarId))
+	{
+		inOutStepLength = (++halvingsAmount < MaxHalvingsAmount ? inOutStepLength * CarScalar(0.5f) : CarScalar(0.0f));
+		inOutIsBlocked = (inOutStepLength == 0.0f);
+		m_IsHeldBack = true;
+	}
+#else
+	(void)direction;
+	(void)stepTicks;
+	(void)inOutStepLength;
+	(void)inOutIsBlocked;
+	(void)cars;
+#endif
 }
 
-Vector2D Car::FindNextDirection(const IntVector2D& currentTrackTilePosition) const
+bool Car::IsNextTileAnIntersection(const IntVector2D& currentTrackTilePosition, const IntVector2D& trackTileDirectionVector) const
 {
+	// In fact we check two tiles ahead because otherwise we get too close from the intersection and other car may see us as an obstacle
+	return (m_Track.GetTrackChar(currentTrackTilePosition + trackTileDirectionVector * 2) == INTERSECTION);
+}
 
+CarVector Car::FindNextDirection(const IntVector2D& currentTrackTilePosition, CarScalar stepTicks) const
+{
 	// Find the point(target) that we want to go to
 	// We do so by following the target point of our current track tile
 	// and if the target point does not fit our requirement we check the next tile, and so on
-	Vector2D targetPointDirection;
-	Vector2D targetPointPosition;
+	CarVector targetPointDirection;
+	CarVector targetPointPosition;
+	const CarScalar halfSpeed = m_Speed * stepTicks / 2.0f;
 	int stepForward = 0;
 	do
 	{
@@ -290,14 +518,14 @@ Vector2D Car::FindNextDirection(const IntVector2D& currentTrackTilePosition) con
 			assert(false);
 
 		// Move through the track 1 tile at the time to find the n ieme tile (where n = stepForward)
-		targetPointPosition = currentTrackTilePosition;
+		IntVector2D targetPointTilePosition = currentTrackTilePosition;
 		char targetPointDirectionChar = GetDirectionChar();
 		for (int i = 0; i < stepForward; i++)
 		{
-			targetPointPosition += GetDirectionVector(targetPointDirectionChar);
-			targetPointDirectionChar = m_Track.GetTrackChar(targetPointPosition);
+			targetPointTilePosition += GetDirectionVector(targetPointDirectionChar);
+			targetPointDirectionChar = m_Track.GetTrackChar(targetPointTilePosition);
 			if (targetPointDirectionChar == CENTER)
-				return (Vector2D(0.0f, 0.0f));
+				return (CarVector::Zero);
 		}
 		// Calculate the target point
 		// here are the target point of a tile:
@@ -311,13 +539,14 @@ Vector2D Car::FindNextDirection(const IntVector2D& currentTrackTilePosition) con
 		// then we offset the vector by the direction multiplied by 0.5
 		// if the direction is (1, -1) our vector will be equal to (16, 15) which correspond to the UP_RIGHT target point
 		Vector2D targetPointOffset = GetDirectionVector(targetPointDirectionChar) * Vector2D(0.5f, 0.5f);
-		targetPointPosition = targetPointPosition + Vector2D(0.5f, 0.5f) + targetPointOffset;
+		targetPointPosition = CarVector(targetPointTilePosition) + CarVector(Vector2D(0.5f, 0.5f)) + CarVector(targetPointOffset);
 		targetPointDirection = targetPointPosition - m_Position;
 		stepForward += 1;
-		// Search for next target point if the current target point is:
-		// - too close (less than half of the distance that we will move in one step)
-		// - The angle is to wide (do not allow 180 instant turn it's a simulation... crrappy... but a simulation ^^)
-	} while (targetPointDirection.AngleBetween(m_ForwardVector) >= CAR_MAX_STEERINGANGLE_DEGREE || targetPointDirection.Length() < m_Speed / 2.0f);
+		// Search for next target point if the current target point is too close (less than half of the distance that we will move in one step)
+		// TODO: also skip the target point when the angle is to wide (do not allow 180 instant turn it's a simulation... crrappy... but a simulation ^^)
+		// this used to compare AngleBetween (radian) with CAR_MAX_STEERINGANGLE_DEGREE (degree) so it never triggered,
+		// and with a real 45 degree limit (IsAngleWiderThan) the search run out of target points on the sharp turns.
+	} while (targetPointDirection.LengthSquared() < halfSpeed * halfSpeed);
 
 	return (targetPointDirection.Normalize());
 }
@@ -3,12 +3,50 @@
 #include "Defines.h"
 #include "Vector2D.h"
 #include "IntVector2D.h"
+#include "FixedVector2D.h"
 #include "Track.h"
+#include "Random.h"
+#include "TrafficLight.h"
+#include "SeqLock.h"
 
 #include <iostream>
 #include <chrono>
 #include <cassert>
 
+#if FIXED_POINT_COORDINATES
+/** The type of the car's own position, speed and math (see FIXED_POINT_COORDINATES) */
+using CarScalar = Fixed;
+using CarVector = FixedVector2D;
+#else
+using CarScalar = float;
+using CarVector = Vector2D;
+#endif
+
+/** What happened during the last Car::Move */
+enum class EMoveResult : uint8_t
+{
+	/** The car moved, nothing is holding it */
+	Moving,
+	/** The car is waiting for the traffic light of the next intersection */
+	StoppedAtRedLight,
+	/** The car can't move without hitting another car (see Car::GetBlockingCarId) */
+	BlockedByCar,
+	/** The car is waiting for a free time slot in the next intersection (see IntersectionManager), it ask again every move */
+	WaitingForReservation
+};
+
+/** The part of the car state that the other threads look at, always read as a whole (always in float, whatever the CarVector) */
+struct CarKinematicState
+{
+	Vector2D position;
+	Vector2D forwardVector;
+	float speed = 0.0f;
+	/** Amount of lane changes since the spawn */
+	uint32_t laneChangesAmount = 0;
+	/** What happened during the last move */
+	EMoveResult lastMoveResult = EMoveResult::Moving;
+};
+
 /**
  * Car that will ride onto the track.
  */
@@ -16,13 +54,60 @@ class Car
 {
 
 public:
-	Car(const ATrack& track, uint8_t id, Vector2D spawnPoint, float acceleration = -1, float maxSpeed = -1);
+	/** How far aside of its lane a car look for the cars ahead before coasting (the next lanes, it may change lane), see FindCoastingSteps */
+	static constexpr float CoastingCorridorHalfWidth = 1.5f;
+
+public:
+	/**
+	 * \param seed The simulation seed, the parameters left to -1 are drawn from the car's own random stream.
+	 */
+	Car(const ATrack& track, uint32_t id, uint64_t seed, Vector2D spawnPoint, float acceleration = -1, float maxSpeed = -1);
 	Car(const Car& other);
 	Car& operator=(const Car& other);
 
 public:
-	/** Move the car 1 step forward */
-	void Move();
+	/**
+	 * Move the car 1 tick forward
+	 *
+	 * \return Whether the car moved or what stopped it.
+	 */
+	EMoveResult Move() { return (Move(m_Track.GetCarsOnTrack())); }
+	/**
+	 * Move the car 1 step forward, only looking for collisions with the given cars.
+	 *
+	 * \param nearbyCars Every car that can be reached within this step (it can contain this car).
+	 * \param deltaTimeInSecond The simulated time of the step, the car accelerate and move for that long.
+	 *        The speeds are stored in tiles per tick and the acceleration in max speed per tick (see TickDurationInSecond),
+	 *        a step of one tick advance the car by its speed.
+	 *        The traffic light is only checked at the start of the step, the longer steps are for the open road (see AdaptiveTimeStep).
+	 * \return Whether the car moved or what stopped it.
+	 */
+	EMoveResult Move(const std::vector<const Car*>& nearbyCars, double deltaTimeInSecond = TickDurationInSecond);
+	/**
+	 * Find for how many steps the car can keep going straight at its current speed without having anything to decide:
+	 * it's at max speed, heading straight along its lane, there is no turn or intersection coming
+	 * and no car ahead that it could reach (even if that car stopped right now).
+	 *
+	 * \param maxSteps The maximum amount of steps to look for.
+	 * \param nearbyCars Every car that can be ahead of this one, in its lane or the next ones (CoastingCorridorHalfWidth),
+	 *        up to the end of its straight line (it can contain this car).
+	 * \return The amount of steps that Coast can skip, 0 if the car have to Move normally.
+	 */
+	int FindCoastingSteps(int maxSteps, const std::vector<const Car*>& nearbyCars) const;
+	int FindCoastingSteps(int maxSteps) const { return (FindCoastingSteps(maxSteps, m_Track.GetCarsOnTrack())); }
+	/** Move the car straight ahead at its current speed, as if Move was called 'steps' times (only valid for the amount of steps given by FindCoastingSteps) */
+	void Coast(int steps);
+	/**
+	 * Check whether this car can be moved as part of a platoon behind the given car (see ActivityScheduler):
+	 * its last move was slowed down by that car (or it was already carried by it), that car is moving no faster than we can,
+	 * both heading straight along the same lane, and there is no intersection coming (its light would have to be checked).
+	 * A normal Move would keep braking and accelerating right behind that car, carried it keep the same gap at the same speed.
+	 */
+	bool CanFollowInPlatoon(const Car& leader) const;
+	/** Move by the same step as the car ahead just did, instead of solving the collisions again (only valid when CanFollowInPlatoon) */
+	void MoveWith(const Car& leader);
+	/** Overwrite the car state with a state moved by another copy of this car (in another process for example) */
+	void ApplyState(const CarKinematicState& state, char lastTrackDirection);
 
 	/**
 	 * Check whether or not a point is inside the car.
@@ -30,14 +115,14 @@ public:
 	 * \param position Position of the point to check.
 	 * \return true if the point is inside the car, false otherwise.
 	 */
-	bool IsInside(Vector2D position) const { return (m_Position - position).Length() < CAR_SIZE_RADIUS; }
+	bool IsInside(Vector2D position) const { return (GetPosition() - position).LengthSquared() < CAR_SIZE_RADIUS * CAR_SIZE_RADIUS; }
 	/**
 	 * Check whether or not a car is colliding with this car.
 	 *
 	 * \param car The other car that we want to check collision with.
 	 * \return true if the car is colliding with this car, false otherwise.
 	 */
-	bool IsColliding(const std::shared_ptr<Car>& car) const;
+	bool IsColliding(const Car& car) const;
 	/**
 	 * Calculate the extra distance between two car.
 	 * Extra mean the distance between the two cars minus the radius of both cars.
@@ -46,20 +131,22 @@ public:
 	 * \param fromThisPosition The position that we want to calculate the extra distance from.
 	 * \return The extra distance between the two cars.
 	 */
-	float FindExtraDistanceBetweenCars(const std::shared_ptr<Car>& car, const Vector2D& fromThisPosition) const;
+	CarScalar FindExtraDistanceBetweenCars(const Car& car, const CarVector& fromThisPosition) const;
 
 private:
+	Car(const ATrack& track, uint32_t id, Vector2D spawnPoint, RandomStream&& random, float acceleration, float maxSpeed);
 
-	Vector2D FindNextLaneDirection(const IntVector2D& currentTrackTilePosition, char currentTrackTileDirectionChar) const;
+	CarVector FindNextLaneDirection(const IntVector2D& currentTrackTilePosition, char currentTrackTileDirectionChar) const;
 
 	/**
 	 * Calculate the optimum speed without crashing in any other car.
 	 *
-	 * \param currentSpeed The current speed of the car.
+	 * \param currentSpeed The current speed of the car (the length of its step).
 	 * \param direction The direction of the car.
-	 * \return The maximum speed without crashing in any other car.
+	 * \param cars the list of cars to check collision with.
+	 * \return The maximum speed without crashing in any other car (the length of the step).
 	 */
-	float CalculateMaxSpeedWithoutCollision(float currentSpeed, const Vector2D& direction) const;
+	CarScalar CalculateMaxSpeedWithoutCollision(CarScalar currentSpeed, const CarVector& direction, const std::vector<const Car*>& cars) const;
 
 	/**
 	 * Check if the car is colliding with any other car at a give position.
@@ -67,60 +154,109 @@ private:
 	 * \param position the position to check.
 	 * \param cars the list of cars to check collision with.
 	 * \param outExtraDistance the extra distance to move to not collide with any other car. (positive)
+	 * \param outClosestCarId the id of the car we collide with.
 	 * \return true if the car is colliding with any other car, false otherwise.
 	 */
-	bool IsCollidingWithOtherCar(const Vector2D& position, const std::vector<std::weak_ptr<Car>>& cars, float* outExtraDistance = nullptr) const;
-
-	bool IsNextTileAnIntersection(const IntVector2D& currentTrackTilePosition, const IntVector2D& trackTileDirectionVector) const;
+	bool IsCollidingWithOtherCar(const CarVector& position, const std::vector<const Car*>& cars, CarScalar* outExtraDistance = nullptr, uint32_t* outClosestCarId = nullptr) const;
 
 	/**
-	 * Return true or false based on whether or not the traffic light is red for you base on where you should go.
-	 * note that using this all the intersection on the map are sync (and also only work on diagonal)
-	 * TODO: make a traffic light class that handle itself.
+	 * Continuous collision detection: check if the car would go through another car on its way, not only at the destination.
+	 * Both cars are circles swept along their step of the tick (the step of the other car is rebuilt from its published state,
+	 * its last move), the cars collide if their distance get below 2 radius at any time of the tick.
+	 * The cars already touching at the start of the tick are left to the destination check.
 	 *
-	 * \param trackDirectionChar the direction char that tell you where to go.
-	 * \return true if the intersection is red (and you have to stop) false if it's green (and you can continue)
+	 * \param step the move of this car for the step (direction * speed * step ticks).
+	 * \param stepTicks the length of the step in ticks, to rebuild the step of the other cars.
+	 * \param cars the list of cars to check collision with.
+	 * \param outCarId the id of the first car we go through.
+	 * \return true if the car go through another car during the step.
 	 */
-	bool IsNextIntersectionRedLightForMe(char trackDirectionChar) const;
+	bool IsSweepingThroughOtherCar(const CarVector& step, CarScalar stepTicks, const std::vector<const Car*>& cars, uint32_t* outCarId = nullptr) const;
+	/** With CONTINUOUS_COLLISION_DETECTION, halve the step until it does not go through any car (stop after a few halvings) */
+	void LimitStepToSweep(const CarVector& direction, CarScalar stepTicks, CarScalar& inOutStepLength, bool& inOutIsBlocked, const std::vector<const Car*>& cars);
 
-	/** This function should be in a traffic light class */
-	int GetTraficLightModuloIndex(const char trackDirectionChar) const;
+	/** Publish the position, forward vector and speed for the other threads (only the thread moving the car call it) */
+	void PublishState()
+	{
+		m_PublishedState.Store({ static_cast<Vector2D>(m_Position), static_cast<Vector2D>(m_ForwardVector), static_cast<float>(m_Speed), m_LaneChangesAmount, m_LastMoveResult });
+	}
+
+	bool IsNextTileAnIntersection(const IntVector2D& currentTrackTilePosition, const IntVector2D& trackTileDirectionVector) const;
 
 	/**
 	 * Get the direction (as a unit vector) the car should follow.
 	 * We find this direction based on the track direction and by trying to stay in the middle of the road.
+	 *
+	 * \param stepTicks the length of the step in ticks, the target point have to be further than half the step.
 	 */
-	Vector2D FindNextDirection(const IntVector2D& currentTrackTilePosition) const;
+	CarVector FindNextDirection(const IntVector2D& currentTrackTilePosition, CarScalar stepTicks) const;
 
 public:
 	const ATrack& GetTrack() const { return (m_Track); }
 
-	Vector2D GetPosition() const { return (m_Position); }
-	Vector2D GetForwardVector() const { return (m_ForwardVector); }
-	float GetSpeed() const { return (m_Speed); }
+	/**
+	 * The state published at the end of the last move.
+	 * Safe to call from any thread while the car is moving, the position, forward vector and speed always come from the same move.
+	 */
+	CarKinematicState GetState() const { return (m_PublishedState.Load()); }
+	Vector2D GetPosition() const { return (GetState().position); }
+	Vector2D GetForwardVector() const { return (GetState().forwardVector); }
+	float GetSpeed() const { return (GetState().speed); }
+	EMoveResult GetLastMoveResult() const { return (GetState().lastMoveResult); }
+	uint32_t GetLaneChangesAmount() const { return (GetState().laneChangesAmount); }
 	char GetLastTrackDirection() const { return (m_LastTrackDirection); }
-	uint8_t GetId() const { return (m_Id); }
-	char GetDisplayChar() const { return (static_cast<char>(m_Id + static_cast<uint8_t>('0'))); }
+	uint32_t GetId() const { return (m_Id); }
+	float GetMaxSpeed() const { return (static_cast<float>(m_MaxSpeed)); }
+	float GetAcceleration() const { return (static_cast<float>(m_Acceleration)); }
+	/** The max speed in tiles per second of simulation */
+	float GetMaxSpeedPerSecond() const { return (static_cast<float>(GetMaxSpeed() / TickDurationInSecond)); }
+	/** The acceleration in tiles per second per second of simulation */
+	float GetAccelerationPerSecond() const { return (static_cast<float>(GetAcceleration() * GetMaxSpeed() / (TickDurationInSecond * TickDurationInSecond))); }
+	/** The car in front of us, only valid when the last move returned EMoveResult::BlockedByCar */
+	uint32_t GetBlockingCarId() const { return (m_BlockingCarId); }
+	char GetDisplayChar() const { return (static_cast<char>(m_Id + static_cast<uint32_t>('0'))); }
 
 	char GetDirectionChar() const;
 
 private:
+	/*
+	 * The members are split in two cache lines:
+	 * - the cold one, constant after the spawn and read by everyone,
+	 * - the hot one, written on every move by the thread moving the car (and the published state read by the other threads).
+	 * Each car start on its own cache line, so two cars moved by different threads never share a line (no false sharing).
+	 */
+
+	/* COLD STATE */
+
 	/** Reference onto the track that the cars is currently driving onto */
 	const ATrack& m_Track;
 	/** Id of the car */
-	const uint8_t m_Id;
+	const uint32_t m_Id;
 	/* Car max speed, (between 0 -> 1) */
-	const float m_MaxSpeed;
+	const CarScalar m_MaxSpeed;
 	/* Car acceleration relative to max speed (.1 acc equal to + .05 speed if maxspeed = 0.5) */
-	const float m_Acceleration;
+	const CarScalar m_Acceleration;
+
+	/* HOT STATE */
 
 	/** Position of the car */
-	Vector2D m_Position;
+	alignas(CACHE_LINE_SIZE) CarVector m_Position;
 	/** unit vector representing where the car is heading */
-	Vector2D m_ForwardVector;
+	CarVector m_ForwardVector;
 	/* Car current speed (between 0 -> 1) */
-	float m_Speed = 0.0f;
+	CarScalar m_Speed = 0.0f;
 	/** The last track direction char that the car has follow */
 	char m_LastTrackDirection;
+	EMoveResult m_LastMoveResult = EMoveResult::Moving;
+	/** Whether the last move was slowed down by the car ahead (m_BlockingCarId) without changing lane */
+	bool m_IsHeldBack = false;
+	/** The id of the last car that we collided with */
+	uint32_t m_BlockingCarId = 0;
+	uint32_t m_LaneChangesAmount = 0;
+
+	/** Copy of m_Position, m_ForwardVector, m_Speed, m_LaneChangesAmount and m_LastMoveResult for the other threads (the members above are only used by the thread moving the car) */
+	SeqLock<CarKinematicState> m_PublishedState;
 
 };
+
+static_assert(sizeof(Car) == CACHE_LINE_SIZE * 2, "The car state should fit in one cold and one hot cache line");
@@ -0,0 +1,12 @@
+#include "CarAgent.h"
+
+AgentTask RunCarAgent(Car& car, AgentExecutor& executor)
+{
+	while (true)
+	{
+		if (car.Move(executor.GatherNearbyCars(car)) == EMoveResult::StoppedAtRedLight)
+			co_await executor.GreenLight(car.GetLastTrackDirection());
+		else
+			co_await executor.NextTick();
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Car.h"
+#include "AgentExecutor.h"
+#include "AgentTask.h"
+
+/**
+ * The logic of 1 car as an independent agent: move, then wait for the next tick,
+ * or for the light to turn green when it stopped at a red light.
+ */
+AgentTask RunCarAgent(Car& car, AgentExecutor& executor);
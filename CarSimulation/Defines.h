@@ -3,6 +3,8 @@
 #include "Vector2D.h"
 #include "IntVector2D.h"
 
+#include <chrono>
+
 /* SETTINGS **********************************************/
 
 // -- SELECT HOW MANY CARS YOU WANT --
@@ -11,7 +13,13 @@
 // -- SELECT A TRACK --
 // 0 = Figure eight track map
 // 1 = Custom map
+// 2 = Generated grid of one way streets (see TrackGenerator)
+// 3 = Generated ring roads
+// 4 = Generated figure eights side by side
 #define SELECTED_MAP 0
+// Size of the generated maps, in tiles (up to 10000 x 10000, the console renderer is only fit for the small ones)
+#define GENERATED_MAP_WIDTH 120
+#define GENERATED_MAP_HEIGHT 60
 
 // -- SELECT A DRIVING MODE --
 // 0 = No colision
@@ -19,9 +27,134 @@
 // 2 = switch lane
 #define DRIVING_MODE 2
 
-// Turn on and off the multi threading
+// -- SELECT THE CONTINUOUS COLLISION DETECTION (only with the collision driving modes) --
+// 0 = Off, a car only check that its destination is free (fine as long as a step is shorter than a car)
+// 1 = On, the cars are also circles swept along their step of the tick, so the fast cars and the long ticks can't make a car
+//     go through another one between two ticks (see Car::IsSweepingThroughOtherCar), a second pass over the nearby cars for each move
+#define CONTINUOUS_COLLISION_DETECTION 0
+
+// -- SELECT THE COORDINATES OF THE CARS --
+// 0 = Float
+// 1 = 32 bits fixed point (see FixedVector2D), the cars move exactly the same way whatever the compiler, the CPU or the amount of threads
+//     (only the car's own state and math, the states published to the rest of the simulation stay in float)
+#define FIXED_POINT_COORDINATES 0
+
+// -- SELECT A SIMULATION ENGINE --
+// 0 = Fixed ticks, every car move every THREAD_REFRESH_DURATION
+// 1 = Discrete events, single thread, the cars only move when something happen to them (see EventEngine)
+// 2 = Regions, fixed ticks stepped in parallel by one thread per vertical strip of the map (see RegionEngine)
+// 3 = Shards, the regions stepped by several processes talking through shared memory, Linux only (see ShardRunner)
+// 4 = Level of detail, the full model only around the close up car, a cheap queue per tile everywhere else (see LodEngine)
+#define SIMULATION_ENGINE 0
+
+// Half size (in tiles) of the area around the close up car where the level of detail engine run the full model
+#define LOD_MICRO_RADIUS 16
+
+// Amount of processes for the sharded engine
+#define SHARDS_AMOUNT 2
+
+// -- SELECT HOW THE CARS ARE RUN (only with the fixed ticks engine) --
+// 0 = Single thread, the ActivityScheduler step the cars and skip the ones parked at a red light or in a queue
+// 1 = One thread per car
+// 2 = One coroutine per car, resumed by a few worker threads (see AgentExecutor)
 #define MULTI_THREADING 1
 
+// -- SELECT THE PLATOONS (only with the single thread scheduler) --
+// 0 = Every awake car solve its own collisions every tick
+// 1 = A car held back by the car ahead on a straight lane is carried by it (same speed, same gap), a dense queue cost about one move per platoon
+//     (the followers only try to change lane once per light phase, see ActivityScheduler)
+#define PLATOON_COMPRESSION 1
+
+// -- SELECT HOW THE CARS CROSS THE INTERSECTIONS --
+// 0 = Traffic lights, the 2 flows of an intersection take turns
+// 1 = Reservations, each car reserve the time slots of the intersection tiles it will cross and go as soon as it get them,
+//     the flows share the intersection (see IntersectionManager), not with the sharded engine
+#define INTERSECTION_CONTROL 0
+
+// -- SELECT THE RANDOM SEED --
+// 0 = New seed every run (printed at startup, put it here to replay the same run)
+#define SIMULATION_SEED 0
+
+// -- SELECT THE BATCH MODE --
+// 0 = Real time simulation
+// 1 = Monte Carlo, run BATCH_SCENARIOS_AMOUNT headless simulations on all the cores (random seed, amount of cars and lights timing)
+//     then write the results in BATCH_RESULTS_FILE (see BatchRunner)
+#define BATCH_MODE 0
+#define BATCH_SCENARIOS_AMOUNT 1000
+// 3000 ticks = 5 minutes of simulation
+#define BATCH_TICKS_PER_SCENARIO 3000
+#define BATCH_MIN_CARS_AMOUNT 4
+#define BATCH_MAX_CARS_AMOUNT 40
+#define BATCH_MIN_LIGHT_PHASE_DURATION 2.0
+#define BATCH_MAX_LIGHT_PHASE_DURATION 10.0
+#define BATCH_RESULTS_FILE "BatchResults.csv"
+
+// -- SELECT THE TIME STEP OF THE BATCH SIMULATIONS --
+// 0 = Fixed, every step is one tick (THREAD_REFRESH_DURATION of simulation)
+// 1 = Adaptive, each step last as many ticks as the cars allow, up to ADAPTIVE_MAX_STEP_TICKS: the open road run in a few long steps,
+//     the cars close to each other or to a light about to change go back to one tick at a time (see AdaptiveTimeStep)
+#define ADAPTIVE_TIME_STEP 0
+#define ADAPTIVE_MAX_STEP_TICKS 10
+
+// -- SELECT THE SPAWN LOGS --
+// 0 = Only a summary once all the cars are spawned
+// 1 = One line per car (slow with a lot of cars, never in batch mode nor in the benchmarks)
+#define LOG_EACH_CAR_SPAWN 1
+
+// -- SELECT THE TRAFFIC STATISTICS --
+// 0 = Off
+// 1 = Measure the traffic every tick (speeds, stops, time at red, lane changes, jams, throughput of the intersections)
+//     and print a report under the map, made every STATISTICS_REPORT_DURATION of simulation (see TrafficStatistics)
+#define TRAFFIC_STATISTICS 0
+#define STATISTICS_REPORT_DURATION std::chrono::seconds(10)
+
+// -- SELECT THE HEATMAPS --
+// 0 = Off
+// 1 = Count the cars, their speed and stops on every tile, written as images and CSV files named after HEATMAP_FILES_PREFIX (see TileHeatmap)
+//     at the end of the batch, or every HEATMAP_WRITE_DURATION of simulation in real time
+#define TILE_HEATMAP 0
+#define HEATMAP_FILES_PREFIX "Heatmap"
+#define HEATMAP_WRITE_DURATION std::chrono::seconds(30)
+
+// -- SELECT THE FRAMES RECORDING --
+// 0 = Off
+// 1 = Record the first RECORDED_TICKS ticks of the main loop (with the selected engine), then render one image per tick
+//     (FRAMES_PREFIX_000000.ppm...) on all the cores and quit, the images can be turned into a video (see FrameRenderer)
+#define RECORD_FRAMES 0
+#define RECORDED_TICKS 3000
+#define FRAMES_PREFIX "Frame"
+#define FRAME_PIXELS_PER_TILE 32
+
+// -- SELECT THE INVARIANT CHECKS (see InvariantChecker) --
+// 0 = Off
+// 1 = Sampled, every INVARIANT_SAMPLING_TICKS ticks the cars are checked for overlaps and for leaving the road
+// 2 = Exhaustive, every tick (for debugging)
+// The last INVARIANT_LOG_SIZE violations are kept (tick and cars) and the last ones are printed under the map
+#define INVARIANT_CHECK 0
+#define INVARIANT_SAMPLING_TICKS 10
+#define INVARIANT_LOG_SIZE 256
+
+// -- SELECT THE ALLOCATION CHECK --
+// 0 = Off
+// 1 = Count every heap allocation (see AllocationCounter) and print the ticks of the main loop that allocated,
+//     once the buffers are warm a tick and its frame are expected to never allocate
+#define COUNT_ALLOCATIONS 0
+
+// -- SELECT THE BENCHMARKS --
+// 0 = Off
+// 1 = Run the microbenchmarks of the hot code instead of the simulation, print the time per operation and quit (see Bench)
+//     (in Release, the times of a Debug build mean nothing)
+#define RUN_BENCHMARKS 0
+#define BENCHMARK_ITERATIONS 20000000
+
+// -- SELECT WHAT HAPPEN TO THE LATE TICKS (real time only, see TickPacer) --
+// 0 = Skip, a tick that took too long is followed by the next one at once, the deadlines missed meanwhile are dropped
+// 1 = Catch up, the missed ticks run back to back until the simulation is on time again
+#define PACER_OVERRUN_POLICY 0
+// The end of each wait is spent spinning instead of sleeping, the OS wake up the threads too late for the very short ticks
+// (0 = only sleep, about 2 ms to hold 1 ms ticks, it keep a core busy for that long every tick)
+#define PACER_SPIN_DURATION std::chrono::microseconds(0)
+
 #define THREAD_REFRESH_DURATION std::chrono::milliseconds(100)
 // I recommend not to go bellow 100 ms because the console is not fast enough to render the game
 #define MAIN_THREAD_REFRESH_DURATION std::chrono::milliseconds(100)
@@ -34,19 +167,25 @@
 // even though with this value to 0 the cars wont crash but sometime they might not be able to open there door ^^
 // between 0 -> car max speed (greater and it wont be taken for consideration anyway)
 #define SAFE_DISTANCE_BETWEEN_CARS 0.1f
-// Acceleration is relative to the max speed (0 -> 1)
+// Acceleration is relative to the max speed, per tick (0 -> 1, 1 = from stopped to max speed in one tick)
 #define CAR_MIN_ACCELERATION 0.1f
 #define CAR_MAX_ACCELERATION 1.0f
-// Max speed (0 -> 1)
+// Max speed in tiles per tick (0 -> 1, a tick is THREAD_REFRESH_DURATION of simulation, see Car::GetMaxSpeedPerSecond)
 #define CAR_MIN_MAXSPEED 0.1f
 #define CAR_MAX_MAXSPEED 0.2f
 #define CAR_MAX_STEERINGANGLE_DEGREE 45.0f
 
 /* FOR CODE READABILIY *************************************/
 
+// The simulated time of a tick in second, the same for every engine (a tick of the real time loops last THREAD_REFRESH_DURATION)
+constexpr double TickDurationInSecond = std::chrono::duration<double>(THREAD_REFRESH_DURATION).count();
+
 constexpr float MinimumCarsAcceleration = 0.1f;
 constexpr float MinimumCarsMaxSpeed = 0.25f;
 
+// Size of a cache line (std::hardware_destructive_interference_size is not available everywhere)
+#define CACHE_LINE_SIZE 64
+
 // Direction of the track
 #define UP 'U'
 #define UP_RIGHT 'E'
@@ -70,7 +209,7 @@ constexpr float MinimumCarsMaxSpeed = 0.25f;
 #define CENTER_VECTOR IntVector2D(0, 0)
 #define INTERSECTION_VECTOR CENTER_VECTOR
 
-static IntVector2D GetDirectionVector(char direction)
+static constexpr IntVector2D GetDirectionVector(char direction)
 {
 	switch (direction)
 	{
@@ -0,0 +1,187 @@
+#include "EventEngine.h"
+#include "RegionEngine.h"
+
+#include <cmath>
+#include <algorithm>
+
+EventEngine::EventEngine(ATrack& track, const std::vector<Car*>& cars)
+	: m_Track(track),
+	m_Cars(cars),
+	m_Wheel(0),
+	m_NextEventTick(cars.size(), 0),
+	m_LastUpdatedTick(cars.size(), 0),
+	m_WaitingForCar(cars.size()),
+	m_AwaitedCarId(cars.size(), NoCarId),
+	m_CoastingIndex(cars.size(), -1),
+	m_SortedCars(track)
+{
+	m_SortedCars.Reserve(cars.size());
+	// Every car start by a normal move on the first tick
+	for (const auto& car : cars)
+	{
+		assert(car->GetId() < cars.size());
+		m_Wheel.Schedule(0, car->GetId());
+	}
+}
+
+void EventEngine::RunUntil(uint64_t tick)
+{
+	uint64_t eventTick;
+	while (m_Wheel.PopNextTick(tick, m_DueCars, eventTick))
+	{
+		m_Track.GetTrafficLight().SetTime(GetTickTime(eventTick));
+		SyncCoastingCars(eventTick);
+		for (uint32_t carId : m_DueCars)
+		{
+			// Skip the events that have been replaced
+			if (m_NextEventTick[carId] != eventTick)
+				continue;
+			ProcessCarEvent(carId, eventTick);
+		}
+		m_DueCars.clear();
+	}
+
+	// Everything is simulated until 'tick' included
+	m_Track.GetTrafficLight().SetTime(GetTickTime(tick + 1));
+	SyncCoastingCars(tick + 1);
+}
+
+void EventEngine::ProcessCarEvent(uint32_t carId, uint64_t tick)
+{
+	Car* car = m_Cars[carId];
+	m_ProcessedEventsAmount++;
+	StopCoasting(carId);
+
+	// The cars that can be reached within the step, see RegionEngine::NearbyTilesRadius
+	const IntVector2D carTile = m_SortedCars.GetClampedTile(car->GetPosition());
+	m_NearbyCars.clear();
+	GatherCars(carTile - RegionEngine::NearbyTilesRadius, carTile + RegionEngine::NearbyTilesRadius, tick, m_NearbyCars);
+	EMoveResult result = car->Move(m_NearbyCars);
+	m_LastUpdatedTick[carId] = tick;
+
+	switch (result)
+	{
+	case EMoveResult::StoppedAtRedLight:
+		ScheduleCar(carId, FindGreenLightTick(car->GetLastTrackDirection(), tick + 1));
+		break;
+	case EMoveResult::WaitingForReservation:
+		ScheduleCar(carId, tick + 1);
+		break;
+	case EMoveResult::BlockedByCar:
+		if (m_Cars[car->GetBlockingCarId()]->GetSpeed() == 0.0f)
+		{
+			// Wait for the car in front to move, but still try again on the next light phase
+			// in case the other lane get free (see ActivityScheduler)
+			uint32_t leaderId = car->GetBlockingCarId();
+			if (m_AwaitedCarId[carId] != leaderId)
+			{
+				m_WaitingForCar[leaderId].push_back(carId);
+				m_AwaitedCarId[carId] = leaderId;
+			}
+			double nextPhaseTime = m_Track.GetTrafficLight().GetNextPhaseTime(GetTickTime(tick));
+			ScheduleCar(carId, std::max(tick + 1, static_cast<uint64_t>(std::ceil(nextPhaseTime / TickDurationInSecond))));
+		}
+		else
+			ScheduleCar(carId, tick + 1);
+		break;
+	case EMoveResult::Moving:
+		// The cars behind us can move again
+		if (car->GetSpeed() > 0.0f)
+		{
+			for (uint32_t waitingCarId : m_WaitingForCar[carId])
+			{
+				if (m_NextEventTick[waitingCarId] > tick + 1)
+					ScheduleCar(waitingCarId, tick + 1);
+				if (m_AwaitedCarId[waitingCarId] == carId)
+					m_AwaitedCarId[waitingCarId] = NoCarId;
+			}
+			m_WaitingForCar[carId].clear();
+		}
+
+		GatherCarsAhead(*car, tick);
+		int coastingTicks = car->FindCoastingSteps(MaxCoastingTicks, m_NearbyCars);
+		if (coastingTicks > 0)
+			StartCoasting(carId);
+		ScheduleCar(carId, tick + 1 + coastingTicks);
+		break;
+	}
+}
+
+void EventEngine::ScheduleCar(uint32_t carId, uint64_t tick)
+{
+	m_NextEventTick[carId] = tick;
+	m_Wheel.Schedule(tick, carId);
+}
+
+void EventEngine::SyncCoastingCars(uint64_t tick)
+{
+	for (uint32_t carId : m_CoastingCars)
+	{
+		uint64_t ticksToApply = tick - 1 - m_LastUpdatedTick[carId];
+		if (ticksToApply == 0)
+			continue;
+		m_Cars[carId]->Coast(static_cast<int>(ticksToApply));
+		m_LastUpdatedTick[carId] = tick - 1;
+	}
+}
+
+void EventEngine::StartCoasting(uint32_t carId)
+{
+	m_CoastingIndex[carId] = static_cast<int64_t>(m_CoastingCars.size());
+	m_CoastingCars.push_back(carId);
+}
+
+void EventEngine::StopCoasting(uint32_t carId)
+{
+	int64_t index = m_CoastingIndex[carId];
+	if (index == -1)
+		return;
+	// Swap remove
+	uint32_t lastCarId = m_CoastingCars.back();
+	m_CoastingCars[index] = lastCarId;
+	m_CoastingIndex[lastCarId] = index;
+	m_CoastingCars.pop_back();
+	m_CoastingIndex[carId] = -1;
+}
+
+void EventEngine::GatherCarsAhead(const Car& car, uint64_t tick)
+{
+	// The straight line of the car, it never coast past its end nor further than MaxCoastingTicks steps
+	const IntVector2D carTile = m_SortedCars.GetClampedTile(car.GetPosition());
+	const char trackDirectionChar = m_Track.GetTrackChar(carTile);
+	const IntVector2D trackDirectionVector = GetDirectionVector(trackDirectionChar);
+	const int maxLength = static_cast<int>(std::ceil((MaxCoastingTicks + 1) * car.GetMaxSpeed())) + 1;
+	IntVector2D lastTile = carTile;
+	for (int i = 0; i < maxLength && m_Track.GetTrackChar(lastTile + trackDirectionVector) == trackDirectionChar; i++)
+		lastTile += trackDirectionVector;
+
+	// Around the line: the next lanes, the car ahead of the last tile (closer than a tile), and a tile for the cars that moved since the sort
+	constexpr int MarginTiles = static_cast<int>(Car::CoastingCorridorHalfWidth) + 2;
+	m_NearbyCars.clear();
+	GatherCars(IntVector2D(std::min(carTile.x, lastTile.x), std::min(carTile.y, lastTile.y)) - MarginTiles,
+		IntVector2D(std::max(carTile.x, lastTile.x), std::max(carTile.y, lastTile.y)) + MarginTiles, tick, m_NearbyCars);
+}
+
+void EventEngine::GatherCars(const IntVector2D& firstTile, const IntVector2D& lastTile, uint64_t tick, std::vector<const Car*>& outCars)
+{
+	static_assert(CAR_MAX_MAXSPEED <= 1.0f, "A car have to move less than a tile per tick, the cars sorted at the start of the tick are looked for 1 tile further");
+	if (m_SortedCarsTick != tick)
+	{
+		m_SortedCars.Clear();
+		for (const Car* otherCar : m_Cars)
+			m_SortedCars.Add(otherCar->GetPosition(), otherCar->GetId());
+		m_SortedCars.Sort();
+		m_SortedCarsTick = tick;
+	}
+	m_SortedCars.GatherCars(firstTile, lastTile, m_Cars, outCars);
+}
+
+uint64_t EventEngine::FindGreenLightTick(char trackDirectionChar, uint64_t fromTick) const
+{
+	double greenTime = m_Track.GetTrafficLight().GetNextGreenTime(trackDirectionChar, GetTickTime(fromTick));
+	uint64_t greenTick = std::max(fromTick, static_cast<uint64_t>(std::ceil(greenTime / TickDurationInSecond)));
+	// Floating point rounding can land us right before the phase change
+	while (m_Track.GetTrafficLight().GetPhaseAt(GetTickTime(greenTick)) != TrafficLight::GetModuloIndex(trackDirectionChar))
+		greenTick++;
+	return (greenTick);
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+#include "TimingWheel.h"
+#include "TileSortedCars.h"
+
+#include <vector>
+#include <memory>
+#include <chrono>
+
+/**
+ * Discrete event simulation, an alternative to moving every car on every tick.
+ * Each car schedule its next interesting event in a timing wheel:
+ * - the light turning green when it's stopped at a red light (or the next tick when it's waiting for a reservation of the intersection),
+ * - the car in front of it moving when it's stuck behind it,
+ * - the end of the straight line it's driving on (next turn, next intersection, or catching up the car ahead).
+ * In between, the cars on open road coast analytically (Car::Coast), so sparse traffic cost almost nothing.
+ * The ticks are the same as the tick engine (THREAD_REFRESH_DURATION long) and every event run a normal Car::Move,
+ * so both engines give the same kind of traces.
+ * note: the car ids have to be their index in the cars vector.
+ */
+class EventEngine
+{
+
+public:
+	/** The maximum amount of ticks a car can coast before being checked again */
+	static constexpr int MaxCoastingTicks = 10000;
+
+public:
+	EventEngine(ATrack& track, const std::vector<Car*>& cars);
+
+public:
+	/** Run all the events until the given tick (included), then bring every car position to that tick */
+	void RunUntil(uint64_t tick);
+
+	/** The next tick to simulate */
+	uint64_t GetCurrentTick() const { return (m_Wheel.GetCurrentTick()); }
+	uint64_t GetProcessedEventsAmount() const { return (m_ProcessedEventsAmount); }
+	size_t GetCoastingCarsAmount() const { return (m_CoastingCars.size()); }
+
+private:
+	void ProcessCarEvent(uint32_t carId, uint64_t tick);
+	/** Schedule the next event of a car (replacing the one it already had) */
+	void ScheduleCar(uint32_t carId, uint64_t tick);
+	/** Move all the coasting cars to where they are at the start of the given tick */
+	void SyncCoastingCars(uint64_t tick);
+	void StartCoasting(uint32_t carId);
+	void StopCoasting(uint32_t carId);
+	/** Put in m_NearbyCars the cars that can be ahead of the car up to the end of its straight line (see Car::FindCoastingSteps) */
+	void GatherCarsAhead(const Car& car, uint64_t tick);
+	/**
+	 * Add the cars in the given tiles (clamped into the map) to the list, found among the cars sorted by tile instead of going through the whole fleet.
+	 * The cars that moved during the tick can be a tile away from the given tiles.
+	 */
+	void GatherCars(const IntVector2D& firstTile, const IntVector2D& lastTile, uint64_t tick, std::vector<const Car*>& outCars);
+	/** Find the first tick at which the light is green for the given direction */
+	uint64_t FindGreenLightTick(char trackDirectionChar, uint64_t fromTick) const;
+	double GetTickTime(uint64_t tick) const { return (static_cast<double>(tick) * TickDurationInSecond); }
+
+private:
+	ATrack& m_Track;
+	const std::vector<Car*>& m_Cars;
+
+	TimingWheel m_Wheel;
+	/** The tick of the only valid event of each car (the older events still in the wheel are ignored) */
+	std::vector<uint64_t> m_NextEventTick;
+	/** The last tick that has been applied to each car */
+	std::vector<uint64_t> m_LastUpdatedTick;
+	/** Cars parked behind another car, by the id of the car they're waiting for */
+	std::vector<std::vector<uint32_t>> m_WaitingForCar;
+	/**
+	 * The list of m_WaitingForCar each car was last added to (NoCarId if none).
+	 * A car blocked for a long time retry on each light phase, it must not be added again to the same list every time.
+	 */
+	std::vector<uint32_t> m_AwaitedCarId;
+	static constexpr uint32_t NoCarId = UINT32_MAX;
+
+	/** Cars currently coasting, and the index of each car in that list (-1 if not coasting) */
+	std::vector<uint32_t> m_CoastingCars;
+	std::vector<int64_t> m_CoastingIndex;
+
+	/**
+	 * The cars sorted by tile (by id), sorted again by the first move of each tick (m_SortedCarsTick).
+	 * A car moved since then is less than a tile away from its tile.
+	 */
+	TileSortedCars m_SortedCars;
+	uint64_t m_SortedCarsTick = UINT64_MAX;
+	/** The cars given to Car::Move and Car::FindCoastingSteps */
+	std::vector<const Car*> m_NearbyCars;
+
+	/** Ids dispatched by the wheel (kept as member to reuse the allocation) */
+	std::vector<uint32_t> m_DueCars;
+	uint64_t m_ProcessedEventsAmount = 0;
+};
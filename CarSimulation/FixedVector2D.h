@@ -0,0 +1,207 @@
+#pragma once
+
+#include "Vector2D.h"
+#include "IntVector2D.h"
+
+#include <ostream>
+#include <cstdint>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+/**
+ * 32 bits fixed point number: 16 bits for the integer part (enough for the 10000 x 10000 maps) and 16 for the fraction (1 / 65536 of a tile).
+ * Every result is computed on integers (the square root start from a double, but it's corrected on integers),
+ * so the results are the same with every compiler, CPU, optimization and amount of threads
+ * (the float results can change with the compiler options, a fused multiply add for example). See FIXED_POINT_COORDINATES.
+ * The constants written as floats are converted when the program is compiled, the conversions at run time are exact roundings.
+ * The multiplications are rounded to the closest value and the divisions truncated, the results that do not fit wrap around.
+ * Header only and constexpr, see Vector2D.
+ */
+struct Fixed
+{
+	static constexpr int FractionBits = 16;
+	static constexpr int32_t One = 1 << FractionBits;
+
+	int32_t raw = 0;
+
+	constexpr Fixed() = default;
+	constexpr Fixed(int value) : raw(value * One) {}
+	constexpr Fixed(float value) : Fixed(static_cast<double>(value)) {}
+	/** Rounded to the closest value, the double hold every float exactly once multiplied by One */
+	constexpr Fixed(double value) : raw(static_cast<int32_t>(value * One + (value >= 0.0 ? 0.5 : -0.5))) {}
+
+	static constexpr Fixed FromRaw(int32_t raw) { Fixed value; value.raw = raw; return (value); }
+
+	/** Exact up to 256 (the float mantissa have 24 bits), the closest float after that */
+	explicit constexpr operator float() const { return (static_cast<float>(raw) / static_cast<float>(One)); }
+	/** Truncated toward zero, like a float */
+	explicit constexpr operator int() const { return (raw / One); }
+
+	/* OPERATORS */
+	friend constexpr Fixed operator+(Fixed a, Fixed b) { return FromRaw(a.raw + b.raw); }
+	friend constexpr Fixed operator-(Fixed a, Fixed b) { return FromRaw(a.raw - b.raw); }
+	constexpr Fixed operator-() const { return FromRaw(-raw); }
+	friend constexpr Fixed operator*(Fixed a, Fixed b) { return FromRaw(static_cast<int32_t>((static_cast<int64_t>(a.raw) * b.raw + One / 2) >> FractionBits)); }
+	friend constexpr Fixed operator/(Fixed a, Fixed b) { return FromRaw(static_cast<int32_t>((static_cast<int64_t>(a.raw) << FractionBits) / b.raw)); }
+	constexpr Fixed& operator+=(Fixed other) { return (*this = *this + other); }
+	constexpr Fixed& operator-=(Fixed other) { return (*this = *this - other); }
+	constexpr Fixed& operator*=(Fixed other) { return (*this = *this * other); }
+	constexpr Fixed& operator/=(Fixed other) { return (*this = *this / other); }
+
+	/* COMPARE */
+	constexpr bool operator==(const Fixed& other) const = default;
+	constexpr auto operator<=>(const Fixed& other) const = default;
+
+	/** Rounded half away from zero, like std::round */
+	constexpr Fixed Round() const { return FromRaw(raw >= 0 ? (raw + One / 2) & ~(One - 1) : -((-raw + One / 2) & ~(One - 1))); }
+	constexpr Fixed Abs() const { return FromRaw(raw >= 0 ? raw : -raw); }
+	constexpr Fixed Sqrt() const { return FromRaw(static_cast<int32_t>(SquareRoot(static_cast<uint64_t>(raw) << FractionBits))); }
+
+	/**
+	 * Integer square root, rounded down.
+	 * At run time it start from the square root of the double and fix it on integers, so the result is exact and the same everywhere
+	 * (the double can be rounded for the values past 2^53, and only the correction decide).
+	 */
+	static constexpr uint64_t SquareRoot(uint64_t value)
+	{
+		if (std::is_constant_evaluated())
+			return (SquareRootBitByBit(value));
+
+		constexpr uint64_t MaxResult = 0xFFFFFFFF;
+		uint64_t result = static_cast<uint64_t>(std::sqrt(static_cast<double>(value)));
+		if (result > MaxResult)
+			result = MaxResult;
+		while (result * result > value)
+			result--;
+		while (result < MaxResult && (result + 1) * (result + 1) <= value)
+			result++;
+		return (result);
+	}
+	/** Integer square root, rounded down, bit by bit (no float, for the constants computed at compile time) */
+	static constexpr uint64_t SquareRootBitByBit(uint64_t value)
+	{
+		uint64_t result = 0;
+		uint64_t bit = uint64_t(1) << 62;
+		while (bit > value)
+			bit >>= 2;
+		while (bit != 0)
+		{
+			if (value >= result + bit)
+			{
+				value -= result + bit;
+				result = (result >> 1) + bit;
+			}
+			else
+				result >>= 1;
+			bit >>= 2;
+		}
+		return (result);
+	}
+	/** Clamp a 64 bits raw value in the 32 bits range */
+	static constexpr Fixed Saturate(int64_t raw)
+	{
+		constexpr int64_t MaxRaw = std::numeric_limits<int32_t>::max();
+		constexpr int64_t MinRaw = std::numeric_limits<int32_t>::min();
+		return FromRaw(static_cast<int32_t>(raw > MaxRaw ? MaxRaw : (raw < MinRaw ? MinRaw : raw)));
+	}
+};
+
+static_assert(sizeof(Fixed) == sizeof(float), "Fixed have to take the same room as a float");
+static_assert(std::is_trivially_copyable<Fixed>::value, "Fixed have to stay trivially copyable");
+
+/** So the code written for float can ask for the biggest value */
+template<>
+class std::numeric_limits<Fixed>
+{
+public:
+	static constexpr bool is_specialized = true;
+	static constexpr Fixed min() { return Fixed::FromRaw(1); }
+	static constexpr Fixed max() { return Fixed::FromRaw(std::numeric_limits<int32_t>::max()); }
+	static constexpr Fixed lowest() { return Fixed::FromRaw(std::numeric_limits<int32_t>::min()); }
+	static constexpr Fixed epsilon() { return Fixed::FromRaw(1); }
+};
+
+/**
+ * 2D fixed point vector, the same interface as Vector2D so the car code work with both (see CarVector).
+ * The squared lengths and dot products are computed on 64 bits then saturated, a far away car is just "very far".
+ * Header only and constexpr, see Vector2D.
+ */
+struct FixedVector2D
+{
+	Fixed x;
+	Fixed y;
+
+	constexpr FixedVector2D() = default;
+	constexpr FixedVector2D(Fixed x, Fixed y) : x(x), y(y) {}
+	constexpr FixedVector2D(Fixed value) : x(value), y(value) {}
+	constexpr FixedVector2D(const IntVector2D& other) : x(other.x), y(other.y) {}
+	/** Explicit, the floats should only come in from the published states of the other cars */
+	explicit constexpr FixedVector2D(const Vector2D& other) : x(other.x), y(other.y) {}
+
+	explicit constexpr operator Vector2D() const { return Vector2D(static_cast<float>(x), static_cast<float>(y)); }
+
+	/* OPERATORS */
+	constexpr FixedVector2D operator+(const FixedVector2D& other) const { return FixedVector2D(x + other.x, y + other.y); }
+	constexpr FixedVector2D operator-() const { return FixedVector2D(-x, -y); }
+	constexpr FixedVector2D operator-(const FixedVector2D& other) const { return FixedVector2D(x - other.x, y - other.y); }
+	constexpr FixedVector2D operator*(const FixedVector2D& other) const { return FixedVector2D(x * other.x, y * other.y); }
+	constexpr FixedVector2D operator*(Fixed value) const { return FixedVector2D(x * value, y * value); }
+	constexpr FixedVector2D operator/(Fixed value) const { return FixedVector2D(x / value, y / value); }
+	constexpr FixedVector2D& operator+=(const FixedVector2D& other) { x += other.x; y += other.y; return *this; }
+	constexpr FixedVector2D& operator-=(const FixedVector2D& other) { x -= other.x; y -= other.y; return *this; }
+
+	/* EQUAL */
+	constexpr bool operator==(const FixedVector2D& other) const = default;
+
+	constexpr FixedVector2D Round() const { return FixedVector2D(x.Round(), y.Round()); }
+	constexpr FixedVector2D Normalize() const
+	{
+		Fixed length = Length();
+		if (length == 0)
+			return FixedVector2D(0, 0);
+		return FixedVector2D(x / length, y / length);
+	}
+	/** Exact (rounded down) even for the vectors too long to have their squared length in 32 bits */
+	constexpr Fixed Length() const { return Fixed::FromRaw(static_cast<int32_t>(Fixed::SquareRoot(static_cast<uint64_t>(RawLengthSquared())))); }
+	/** Squared length, use it to compare distances without paying for the square root (saturated past 32767, 181 tiles) */
+	constexpr Fixed LengthSquared() const { return Fixed::Saturate((RawLengthSquared() + Fixed::One / 2) >> Fixed::FractionBits); }
+	constexpr Fixed Dot(const FixedVector2D& other) const
+	{
+		return Fixed::Saturate((static_cast<int64_t>(x.raw) * other.x.raw + static_cast<int64_t>(y.raw) * other.y.raw + Fixed::One / 2) >> Fixed::FractionBits);
+	}
+
+	/* Fixed rotations, see Vector2D */
+	constexpr FixedVector2D& Rotate45() { return (*this = FixedVector2D((x - y) * Sqrt2Over2, (x + y) * Sqrt2Over2)); }
+	constexpr FixedVector2D& RotateMinus45() { return (*this = FixedVector2D((x + y) * Sqrt2Over2, (y - x) * Sqrt2Over2)); }
+	constexpr FixedVector2D& Rotate90() { return (*this = FixedVector2D(-y, x)); }
+	constexpr FixedVector2D& RotateMinus90() { return (*this = FixedVector2D(y, -x)); }
+
+	/** The tile under the position, a shift instead of std::floor (see ATrack::MapPositionOnTrack) */
+	constexpr IntVector2D GetTile() const { return IntVector2D(x.raw >> Fixed::FractionBits, y.raw >> Fixed::FractionBits); }
+
+	static const FixedVector2D Zero;
+
+	static constexpr Fixed Sqrt2Over2 = Fixed(0.70710678118654752440);
+
+private:
+	/** Squared length with 32 bits of fraction, it does not overflow for the positions of any map */
+	constexpr int64_t RawLengthSquared() const { return (static_cast<int64_t>(x.raw) * x.raw + static_cast<int64_t>(y.raw) * y.raw); }
+};
+
+inline constexpr FixedVector2D FixedVector2D::Zero = FixedVector2D(0, 0);
+
+static_assert(sizeof(FixedVector2D) == sizeof(Vector2D), "FixedVector2D have to take the same room as a Vector2D");
+static_assert(std::is_trivially_copyable<FixedVector2D>::value, "FixedVector2D have to stay trivially copyable");
+
+inline std::ostream& operator<<(std::ostream& os, Fixed value)
+{
+	os << static_cast<float>(value);
+	return (os);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const FixedVector2D& vector)
+{
+	os << static_cast<Vector2D>(vector);
+	return (os);
+}
@@ -0,0 +1,19 @@
+#include "FleetPool.h"
+
+#include <algorithm>
+#include <new>
+
+FleetPool::FleetPool(size_t capacity)
+	: m_Storage(static_cast<Car*>(::operator new(sizeof(Car) * std::max<size_t>(1, capacity), std::align_val_t(alignof(Car))))),
+	m_Capacity(capacity)
+{
+	m_Cars.reserve(capacity);
+}
+
+FleetPool::~FleetPool()
+{
+	// Reverse creation order, like a regular container
+	for (size_t i = m_Cars.size(); i > 0; i--)
+		m_Cars[i - 1]->~Car();
+	::operator delete(m_Storage, std::align_val_t(alignof(Car)));
+}
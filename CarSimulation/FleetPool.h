@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Car.h"
+
+#include <vector>
+#include <utility>
+#include <cassert>
+
+/**
+ * Own all the cars of a simulation in one contiguous block, allocated once for the whole fleet.
+ * The cars never move once created (the track, the engines and the threads keep pointers on them),
+ * and there is no reference count or control block to touch when a car is passed around.
+ * The cars are destroyed with the pool.
+ */
+class FleetPool
+{
+
+public:
+	/** \param capacity The maximum amount of cars, the memory of all of them is allocated right away */
+	explicit FleetPool(size_t capacity);
+	~FleetPool();
+	FleetPool(const FleetPool& other) = delete;
+	FleetPool& operator=(const FleetPool& other) = delete;
+
+public:
+	/** Construct a new car in the pool (there must be room left), the arguments are the ones of the Car constructor */
+	template<typename... Args>
+	Car* Create(Args&&... args)
+	{
+		assert(m_Cars.size() < m_Capacity);
+		Car* car = new (m_Storage + m_Cars.size()) Car(std::forward<Args>(args)...);
+		m_Cars.push_back(car);
+		return (car);
+	}
+
+	/** All the cars created, in creation order (the index of a car is its creation index) */
+	const std::vector<Car*>& GetCars() const { return (m_Cars); }
+	size_t GetCapacity() const { return (m_Capacity); }
+
+private:
+	Car* m_Storage;
+	const size_t m_Capacity;
+	/** Reserved for the whole capacity, so creating a car never allocate */
+	std::vector<Car*> m_Cars;
+};
@@ -0,0 +1,219 @@
+#include "FrameRenderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+	const uint8_t GrassColor[3] = { 46, 92, 46 };
+	const uint8_t RoadColor[3] = { 72, 72, 72 };
+	const uint8_t IntersectionColor[3] = { 104, 104, 104 };
+	const uint8_t LaneArrowColor[3] = { 150, 150, 150 };
+	const uint8_t TextColor[3] = { 0, 0, 0 };
+
+	/** The digits in a 3x5 pixels font, one row per value (the 3 lowest bits, the highest is the left pixel) */
+	const uint8_t DigitsFont[10][5] = {
+		{ 7, 5, 5, 5, 7 }, { 2, 6, 2, 2, 7 }, { 7, 1, 7, 4, 7 }, { 7, 1, 7, 1, 7 }, { 5, 5, 7, 1, 1 },
+		{ 7, 4, 7, 1, 7 }, { 7, 4, 7, 5, 7 }, { 7, 1, 1, 1, 1 }, { 7, 5, 7, 5, 7 }, { 7, 5, 7, 1, 7 }
+	};
+
+	/** Past MaxImageSize tiles, a pixel is a square of several tiles */
+	int FindTilesPerPixel(const ATrack& track)
+	{
+		const int mapSize = std::max(track.GetWidth(), track.GetHeight());
+		return ((mapSize + FrameRenderer::MaxImageSize - 1) / FrameRenderer::MaxImageSize);
+	}
+
+	/** The asked size of a tile, as long as the image fit in MaxImageSize */
+	int FindPixelsPerCell(const ATrack& track, int tilesPerPixel, int pixelsPerTile)
+	{
+		const int mapSize = std::max(track.GetWidth(), track.GetHeight());
+		const int cellsSize = std::max(1, (mapSize + tilesPerPixel - 1) / tilesPerPixel);
+		return (CLAMP(1, FrameRenderer::MaxImageSize / cellsSize, pixelsPerTile));
+	}
+
+	/** A different bright color for each car, the hues are spread with the golden ratio so the close ids look different */
+	void FindCarColor(uint32_t carId, uint8_t* outColor)
+	{
+		const float hue = std::fmod(carId * 0.618034f, 1.0f) * 6.0f;
+		const float saturation = 0.7f;
+		const float value = 0.95f;
+		const int sector = static_cast<int>(hue) % 6;
+		const float part = hue - std::floor(hue);
+		const float p = value * (1.0f - saturation);
+		const float q = value * (1.0f - saturation * part);
+		const float t = value * (1.0f - saturation * (1.0f - part));
+		const float rgb[6][3] = { { value, t, p }, { q, value, p }, { p, value, t }, { p, q, value }, { t, p, value }, { value, p, q } };
+		for (int i = 0; i < 3; i++)
+			outColor[i] = static_cast<uint8_t>(rgb[sector][i] * 255.0f);
+	}
+}
+
+FrameRenderer::FrameRenderer(const ATrack& track, int pixelsPerTile)
+	: m_Track(track),
+	m_TilesPerPixel(FindTilesPerPixel(track)),
+	m_PixelsPerCell(FindPixelsPerCell(track, m_TilesPerPixel, pixelsPerTile)),
+	m_Scale(static_cast<float>(m_PixelsPerCell) / m_TilesPerPixel),
+	m_Width((track.GetWidth() + m_TilesPerPixel - 1) / m_TilesPerPixel * m_PixelsPerCell),
+	m_Height((track.GetHeight() + m_TilesPerPixel - 1) / m_TilesPerPixel * m_PixelsPerCell)
+{
+	RasterizeTrack();
+}
+
+void FrameRenderer::RenderFrame(const CarKinematicState* states, size_t carsAmount, std::vector<uint8_t>& outPixels) const
+{
+	// Same size, the copy reuse the memory of the previous frame
+	outPixels = m_Background;
+	for (size_t i = 0; i < carsAmount; i++)
+		DrawCar(states[i], static_cast<uint32_t>(i), outPixels);
+}
+
+bool FrameRenderer::RenderSnapshot(const std::vector<Car*>& cars, const std::string& path) const
+{
+	RunRecording snapshot(cars.size());
+	snapshot.Record(cars);
+	std::vector<uint8_t> pixels;
+	RenderFrame(snapshot.GetTickStates(0), snapshot.GetCarsAmount(), pixels);
+	return (WriteImage(path, pixels));
+}
+
+bool FrameRenderer::RenderRecording(const RunRecording& recording, const std::string& prefix, unsigned int threadsAmount) const
+{
+	// The frames are independent, each worker take the next one until there is none left
+	std::atomic<size_t> nextFrameIndex = { 0 };
+	std::atomic<bool> hasFailed = { false };
+	auto renderFrames = [this, &recording, &prefix, &nextFrameIndex, &hasFailed]()
+	{
+		std::vector<uint8_t> pixels;
+		std::vector<char> path(prefix.size() + 16);
+		for (size_t i = nextFrameIndex++; i < recording.GetTicksAmount() && hasFailed == false; i = nextFrameIndex++)
+		{
+			RenderFrame(recording.GetTickStates(i), recording.GetCarsAmount(), pixels);
+			std::snprintf(path.data(), path.size(), "%s_%06zu.ppm", prefix.c_str(), i);
+			if (WriteImage(path.data(), pixels) == false)
+				hasFailed = true;
+		}
+	};
+
+	std::vector<std::thread> workers;
+	workers.reserve(std::max(1u, threadsAmount) - 1);
+	for (unsigned int i = 1; i < threadsAmount; i++)
+		workers.emplace_back(renderFrames);
+	renderFrames();
+	for (std::thread& worker : workers)
+		worker.join();
+	return (hasFailed == false);
+}
+
+void FrameRenderer::RasterizeTrack()
+{
+	m_Background.resize(static_cast<size_t>(m_Width) * m_Height * 3);
+	const int cellsWidth = m_Width / m_PixelsPerCell;
+	const int cellsHeight = m_Height / m_PixelsPerCell;
+	for (int cellY = 0; cellY < cellsHeight; cellY++)
+	{
+		for (int cellX = 0; cellX < cellsWidth; cellX++)
+		{
+			// A cell of several tiles show its intersections first, then its roads
+			char trackChar = m_Track.GetTrackChar(IntVector2D(cellX, cellY) * m_TilesPerPixel);
+			for (int tileY = cellY * m_TilesPerPixel; tileY < std::min(m_Track.GetHeight(), (cellY + 1) * m_TilesPerPixel) && trackChar != INTERSECTION; tileY++)
+			{
+				for (int tileX = cellX * m_TilesPerPixel; tileX < std::min(m_Track.GetWidth(), (cellX + 1) * m_TilesPerPixel); tileX++)
+				{
+					const char tileChar = m_Track.GetTrackChar(IntVector2D(tileX, tileY));
+					if (tileChar == INTERSECTION || (m_Track.IsRoad(tileChar) && m_Track.IsRoad(trackChar) == false))
+						trackChar = tileChar;
+				}
+			}
+			const uint8_t* color = (trackChar == INTERSECTION ? IntersectionColor : (m_Track.IsRoad(trackChar) ? RoadColor : GrassColor));
+			for (int y = cellY * m_PixelsPerCell; y < (cellY + 1) * m_PixelsPerCell; y++)
+				for (int x = cellX * m_PixelsPerCell; x < (cellX + 1) * m_PixelsPerCell; x++)
+					SetPixel(x, y, color, m_Background);
+
+			// A short line from the center of the tile toward the direction of the lane, when there is room for it
+			const int lineLength = m_PixelsPerCell / 3;
+			if (m_TilesPerPixel > 1 || lineLength == 0 || trackChar == INTERSECTION || m_Track.IsRoad(trackChar) == false)
+				continue;
+			const Vector2D direction = GetDirectionVector(trackChar).Normalize();
+			const float centerX = (cellX + 0.5f) * m_PixelsPerCell;
+			const float centerY = (cellY + 0.5f) * m_PixelsPerCell;
+			for (int i = 0; i <= lineLength; i++)
+				SetPixel(static_cast<int>(centerX + direction.x * i), static_cast<int>(centerY + direction.y * i), LaneArrowColor, m_Background);
+		}
+	}
+}
+
+void FrameRenderer::DrawCar(const CarKinematicState& state, uint32_t carId, std::vector<uint8_t>& pixels) const
+{
+	uint8_t color[3];
+	FindCarColor(carId, color);
+	const uint8_t outlineColor[3] = { static_cast<uint8_t>(color[0] / 2), static_cast<uint8_t>(color[1] / 2), static_cast<uint8_t>(color[2] / 2) };
+
+	const float centerX = state.position.x * m_Scale;
+	const float centerY = state.position.y * m_Scale;
+	// At least a pixel, even when several tiles share a pixel
+	const float radius = std::max(1.0f, CAR_SIZE_RADIUS * m_Scale);
+	const float innerRadius = std::max(0.0f, radius - std::max(1.0f, radius / 6.0f));
+	for (int y = static_cast<int>(std::floor(centerY - radius)); y <= static_cast<int>(std::ceil(centerY + radius)); y++)
+	{
+		for (int x = static_cast<int>(std::floor(centerX - radius)); x <= static_cast<int>(std::ceil(centerX + radius)); x++)
+		{
+			// Test the center of the pixel
+			const float distanceX = x + 0.5f - centerX;
+			const float distanceY = y + 0.5f - centerY;
+			const float distanceSquared = distanceX * distanceX + distanceY * distanceY;
+			if (distanceSquared <= innerRadius * innerRadius)
+				SetPixel(x, y, color, pixels);
+			else if (distanceSquared <= radius * radius)
+				SetPixel(x, y, outlineColor, pixels);
+		}
+	}
+
+	// The ids would cover the whole map when several tiles share a pixel
+	if (m_TilesPerPixel > 1)
+		return;
+	const int scale = std::max(1, m_PixelsPerCell / 32);
+	DrawNumber(carId, static_cast<int>(centerX), static_cast<int>(centerY), scale, TextColor, pixels);
+}
+
+void FrameRenderer::DrawNumber(uint32_t number, int centerX, int centerY, int scale, const uint8_t* color, std::vector<uint8_t>& pixels) const
+{
+	char digits[16];
+	const int digitsAmount = std::snprintf(digits, sizeof(digits), "%u", number);
+
+	// 3 pixels per digit plus 1 between them
+	const int textWidth = (digitsAmount * 4 - 1) * scale;
+	const int left = centerX - textWidth / 2;
+	const int top = centerY - 5 * scale / 2;
+	for (int i = 0; i < digitsAmount; i++)
+	{
+		const uint8_t* glyph = DigitsFont[digits[i] - '0'];
+		for (int row = 0; row < 5 * scale; row++)
+			for (int column = 0; column < 3 * scale; column++)
+				if (glyph[row / scale] & (4 >> (column / scale)))
+					SetPixel(left + i * 4 * scale + column, top + row, color, pixels);
+	}
+}
+
+void FrameRenderer::SetPixel(int x, int y, const uint8_t* color, std::vector<uint8_t>& pixels) const
+{
+	if (x < 0 || y < 0 || x >= m_Width || y >= m_Height)
+		return;
+	uint8_t* pixel = pixels.data() + (static_cast<size_t>(y) * m_Width + x) * 3;
+	pixel[0] = color[0];
+	pixel[1] = color[1];
+	pixel[2] = color[2];
+}
+
+bool FrameRenderer::WriteImage(const std::string& path, const std::vector<uint8_t>& pixels) const
+{
+	std::ofstream file(path, std::ios::binary);
+	if (file.is_open() == false)
+		return (false);
+	file << "P6\n" << m_Width << ' ' << m_Height << "\n255\n";
+	file.write(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+	return (file.good());
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+#include "RunRecording.h"
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <cstdint>
+
+/**
+ * Render the simulation as images (binary PPM), with the track and each car as a colored circle with its id.
+ * The track is rasterized once at construction, each frame start from a copy of it and only draw the cars.
+ * A recorded run is rendered with one frame per tick, the frames spread over all the cores (they're independent),
+ * the result is an image sequence ready to be turned into a video.
+ * When the map is too big for MaxImageSize, the tiles are drawn smaller, and then several tiles share a pixel (like TileHeatmap).
+ */
+class FrameRenderer
+{
+
+public:
+	/** The max width and height of the images, a big map is drawn with several tiles per pixel */
+	static constexpr int MaxImageSize = 2048;
+
+public:
+	/** \param pixelsPerTile The size of a tile in the images, at most */
+	FrameRenderer(const ATrack& track, int pixelsPerTile = 32);
+
+public:
+	/** Draw the given states of the cars (indexed by car id) on top of the track */
+	void RenderFrame(const CarKinematicState* states, size_t carsAmount, std::vector<uint8_t>& outPixels) const;
+	/** Render the current state of the cars in one image, return false if the file can't be written */
+	bool RenderSnapshot(const std::vector<Car*>& cars, const std::string& path) const;
+	/**
+	 * Render every tick of the recording, in the files prefix_000000.ppm, prefix_000001.ppm...
+	 *
+	 * \param threadsAmount The amount of threads rendering the frames (the calling one included).
+	 * \return false if a file can't be written.
+	 */
+	bool RenderRecording(const RunRecording& recording, const std::string& prefix, unsigned int threadsAmount = std::thread::hardware_concurrency()) const;
+
+	int GetWidth() const { return (m_Width); }
+	int GetHeight() const { return (m_Height); }
+
+private:
+	/** Draw the track once, in m_Background */
+	void RasterizeTrack();
+	void DrawCar(const CarKinematicState& state, uint32_t carId, std::vector<uint8_t>& pixels) const;
+	/** Draw a number with a 3x5 pixels font, centered on the given pixel */
+	void DrawNumber(uint32_t number, int centerX, int centerY, int scale, const uint8_t* color, std::vector<uint8_t>& pixels) const;
+	void SetPixel(int x, int y, const uint8_t* color, std::vector<uint8_t>& pixels) const;
+	bool WriteImage(const std::string& path, const std::vector<uint8_t>& pixels) const;
+
+private:
+	const ATrack& m_Track;
+	/** Each cell of the images is a square of m_TilesPerPixel tiles, drawn as a square of m_PixelsPerCell pixels (one of them is 1) */
+	const int m_TilesPerPixel;
+	const int m_PixelsPerCell;
+	/** Pixels per tile, less than 1 when several tiles share a pixel */
+	const float m_Scale;
+	const int m_Width;
+	const int m_Height;
+	/** The track alone, 3 bytes (RGB) per pixel */
+	std::vector<uint8_t> m_Background;
+};
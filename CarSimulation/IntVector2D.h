@@ -1,58 +1,108 @@
 #pragma once
-#pragma once
 
-#include <ostream>
+#include "Vector2D.h"
 
-struct Vector2D;
+#include <ostream>
+#include <cmath>
+#include <type_traits>
 
+/**
+ * 2D integer vector, mostly used for the track tiles.
+ * Header only and constexpr, see Vector2D.
+ */
 struct IntVector2D
 {
 	int x;
 	int y;
 
-	IntVector2D();
-	IntVector2D(int x, int y);
-	IntVector2D(int value);
-	IntVector2D(const IntVector2D& other);
-	IntVector2D(const Vector2D& other);
+	constexpr IntVector2D() : x(0), y(0) {}
+	constexpr IntVector2D(int x, int y) : x(x), y(y) {}
+	constexpr IntVector2D(int value) : x(value), y(value) {}
+	constexpr IntVector2D(const IntVector2D& other) = default;
+	constexpr IntVector2D(const Vector2D& other) : x(static_cast<int>(other.x)), y(static_cast<int>(other.y)) {}
 
 	/* ADD */
-	IntVector2D operator+(const IntVector2D& other) const;
-	Vector2D operator+(const Vector2D other) const;
+	constexpr IntVector2D operator+(const IntVector2D& other) const { return IntVector2D(x + other.x, y + other.y); }
+	/** Note: the float vector is rounded to the closest tile first */
+	constexpr Vector2D operator+(const Vector2D other) const { return IntVector2D(x + RoundToInt(other.x), y + RoundToInt(other.y)); }
 	template<typename T2>
-	IntVector2D operator+(const T2 value) const;
+	constexpr IntVector2D operator+(const T2 value) const { return IntVector2D(static_cast<int>(x + value), static_cast<int>(y + value)); }
 
 	/* SUB */
-	IntVector2D operator-() const;
-	IntVector2D operator-(const IntVector2D& other) const;
-	Vector2D operator-(const Vector2D other) const;
+	constexpr IntVector2D operator-() const { return IntVector2D(-x, -y); }
+	constexpr IntVector2D operator-(const IntVector2D& other) const { return IntVector2D(x - other.x, y - other.y); }
+	/** Note: the float vector is rounded to the closest tile first */
+	constexpr Vector2D operator-(const Vector2D other) const { return IntVector2D(x - RoundToInt(other.x), y - RoundToInt(other.y)); }
 	template<typename T2>
-	IntVector2D operator-(const T2 value) const;
+	constexpr IntVector2D operator-(const T2 value) const { return IntVector2D(static_cast<int>(x - value), static_cast<int>(y - value)); }
 
 	/* MULT */
-	IntVector2D operator*(const IntVector2D& other) const;
-	Vector2D operator*(const Vector2D& other) const;
-	Vector2D operator*(const int other) const;
+	constexpr IntVector2D operator*(const IntVector2D& other) const { return IntVector2D(x * other.x, y * other.y); }
+	constexpr Vector2D operator*(const Vector2D& other) const { return Vector2D(x * other.x, y * other.y); }
+	constexpr IntVector2D operator*(const int other) const { return IntVector2D(x * other, y * other); }
 	template<typename T2>
-	IntVector2D operator*(const T2 value) const;
+	constexpr IntVector2D operator*(const T2 value) const { return IntVector2D(static_cast<int>(x * value), static_cast<int>(y * value)); }
+
 	/* DIV */
-	IntVector2D operator/(const IntVector2D& other) const;
+	constexpr IntVector2D operator/(const IntVector2D& other) const { return IntVector2D(x / other.x, y / other.y); }
 	template<typename T2>
-	IntVector2D operator/(const T2 value) const;
+	constexpr IntVector2D operator/(const T2 value) const { return IntVector2D(static_cast<int>(x / value), static_cast<int>(y / value)); }
 
 	/* EQUAL */
-	IntVector2D& operator=(const IntVector2D& other);
-	bool operator==(const IntVector2D& other) const;
-	IntVector2D& operator+=(const IntVector2D& other);
-	IntVector2D& operator-=(const IntVector2D& other);
-	IntVector2D& operator*=(const IntVector2D& other);
-	IntVector2D& operator/=(const IntVector2D& other);
-	bool operator!=(const IntVector2D& other) const;
-
-	Vector2D Normalize() const;
-	float Length() const;
-	float Dot(const IntVector2D& other) const;
-	float Angle(const IntVector2D& other) const;
+	constexpr IntVector2D& operator=(const IntVector2D& other) = default;
+	constexpr bool operator==(const IntVector2D& other) const { return x == other.x && y == other.y; }
+	constexpr IntVector2D& operator+=(const IntVector2D& other) { x += other.x; y += other.y; return *this; }
+	constexpr IntVector2D& operator-=(const IntVector2D& other) { x -= other.x; y -= other.y; return *this; }
+	constexpr IntVector2D& operator*=(const IntVector2D& other) { x *= other.x; y *= other.y; return *this; }
+	constexpr IntVector2D& operator/=(const IntVector2D& other) { x /= other.x; y /= other.y; return *this; }
+	constexpr bool operator!=(const IntVector2D& other) const { return (x != other.x || y != other.y); }
+
+	/** Normalized then rounded, so the diagonals stay on the grid (1, -1) */
+	Vector2D Normalize() const
+	{
+		float length = Length();
+		if (length == 0.0f)
+			return Vector2D(0, 0);
+		return Vector2D(Vector2D(x / length, y / length).Round());
+	}
+	float Length() const { return std::sqrt(static_cast<float>(LengthSquared())); }
+	constexpr int LengthSquared() const { return (x * x) + (y * y); }
+	constexpr float Dot(const IntVector2D& other) const { return (x * static_cast<float>(other.x) + y * static_cast<float>(other.y)); }
+	float Angle(const IntVector2D& other) const { return (std::acos(Dot(other) / (Length() * other.Length()))); }
+
+	/** constexpr equivalent of std::round (half away from zero) */
+	static constexpr int RoundToInt(float value)
+	{
+		int truncated = static_cast<int>(value);
+		float remainder = value - static_cast<float>(truncated);
+		if (remainder >= 0.5f)
+			return truncated + 1;
+		if (remainder <= -0.5f)
+			return truncated - 1;
+		return truncated;
+	}
 };
 
-std::ostream& operator<<(std::ostream& os, const IntVector2D& vector);
+static_assert(std::is_trivially_copyable<IntVector2D>::value, "IntVector2D have to stay trivially copyable");
+
+inline std::ostream& operator<<(std::ostream& os, const IntVector2D& vector)
+{
+	os << "(x" << vector.x << ", y" << vector.y << ")";
+	return (os);
+}
+
+/* Vector2D members that need the full IntVector2D definition */
+
+constexpr Vector2D::Vector2D(const IntVector2D& other)
+	: x(static_cast<float>(other.x)), y(static_cast<float>(other.y))
+{}
+
+constexpr Vector2D Vector2D::operator+(const IntVector2D other) const
+{
+	return Vector2D(x + other.x, y + other.y);
+}
+
+constexpr Vector2D Vector2D::operator-(const IntVector2D other) const
+{
+	return Vector2D(x - other.x, y - other.y);
+}
@@ -0,0 +1,67 @@
+#include "IntersectionIndex.h"
+
+#include <algorithm>
+#include <limits>
+
+IntersectionIndex::IntersectionIndex(const ATrack& track)
+	: m_Track(track)
+{
+	constexpr uint32_t NoIndex = std::numeric_limits<uint32_t>::max();
+	const std::span<const uint32_t> trackTiles = m_Track.GetIntersectionTiles();
+	const int width = m_Track.GetWidth();
+	m_TileIndexByTrackTile.assign(trackTiles.size(), NoIndex);
+	m_TilePositions.reserve(trackTiles.size());
+	m_TileIntersections.reserve(trackTiles.size());
+
+	// Flood fill each block of intersection tiles that does not have an index yet, the tiles of a block get consecutive indices
+	std::vector<IntVector2D> tilesToVisit;
+	for (size_t i = 0; i < trackTiles.size(); i++)
+	{
+		if (m_TileIndexByTrackTile[i] != NoIndex)
+			continue;
+
+		const uint32_t intersectionIndex = static_cast<uint32_t>(m_IntersectionFirstTiles.size());
+		m_IntersectionFirstTiles.push_back(static_cast<uint32_t>(m_TilePositions.size()));
+		const IntVector2D firstTile(static_cast<int>(trackTiles[i] % width), static_cast<int>(trackTiles[i] / width));
+		m_TileIndexByTrackTile[i] = static_cast<uint32_t>(m_TilePositions.size());
+		m_TilePositions.push_back(firstTile);
+		m_TileIntersections.push_back(intersectionIndex);
+		tilesToVisit.push_back(firstTile);
+		while (tilesToVisit.empty() == false)
+		{
+			const IntVector2D tile = tilesToVisit.back();
+			tilesToVisit.pop_back();
+			for (const IntVector2D& direction : { UP_VECTOR, RIGHT_VECTOR, DOWN_VECTOR, LEFT_VECTOR })
+			{
+				const IntVector2D neighbour = tile + direction;
+				const int trackTile = FindTrackTile(neighbour);
+				if (trackTile == -1 || m_TileIndexByTrackTile[trackTile] != NoIndex)
+					continue;
+				m_TileIndexByTrackTile[trackTile] = static_cast<uint32_t>(m_TilePositions.size());
+				m_TilePositions.push_back(neighbour);
+				m_TileIntersections.push_back(intersectionIndex);
+				tilesToVisit.push_back(neighbour);
+			}
+		}
+	}
+	// The end of the last intersection
+	m_IntersectionFirstTiles.push_back(static_cast<uint32_t>(m_TilePositions.size()));
+}
+
+int IntersectionIndex::FindTile(const IntVector2D& position) const
+{
+	const int trackTile = FindTrackTile(position);
+	return (trackTile == -1 ? -1 : static_cast<int>(m_TileIndexByTrackTile[trackTile]));
+}
+
+int IntersectionIndex::FindTrackTile(const IntVector2D& position) const
+{
+	// The flags reject most of the tiles without searching
+	if ((m_Track.GetTileFlags(position) & TileFlags::Intersection) == 0)
+		return (-1);
+	const std::span<const uint32_t> trackTiles = m_Track.GetIntersectionTiles();
+	const uint32_t mapIndex = static_cast<uint32_t>(position.y) * m_Track.GetWidth() + position.x;
+	const auto found = std::lower_bound(trackTiles.begin(), trackTiles.end(), mapIndex);
+	assert(found != trackTiles.end() && *found == mapIndex);
+	return (static_cast<int>(found - trackTiles.begin()));
+}
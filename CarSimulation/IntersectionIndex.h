@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Defines.h"
+#include "Track.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * Number the intersections of a track (the blocks of adjacent intersection tiles) and their tiles.
+ * The tiles of an intersection get consecutive indices, the intersections are numbered in the map order of their first tile.
+ * Built from the intersection tiles of the track only (ATrack::GetIntersectionTiles), the memory only depend on the amount
+ * of intersection tiles and not on the size of the map: a position is found by a binary search in the track's sorted table.
+ */
+class IntersectionIndex
+{
+
+public:
+	explicit IntersectionIndex(const ATrack& track);
+
+public:
+	size_t GetIntersectionsAmount() const { return (m_IntersectionFirstTiles.size() - 1); }
+	size_t GetTilesAmount() const { return (m_TilePositions.size()); }
+
+	/** The index of the intersection tile at this position, -1 if it's not an intersection (or out of the map) */
+	int FindTile(const IntVector2D& position) const;
+	/** The index of the intersection the position is in, -1 if it's not an intersection (or out of the map) */
+	int FindIntersection(const IntVector2D& position) const
+	{
+		const int tileIndex = FindTile(position);
+		return (tileIndex == -1 ? -1 : static_cast<int>(m_TileIntersections[tileIndex]));
+	}
+
+	const IntVector2D& GetTilePosition(uint32_t tileIndex) const { return (m_TilePositions[tileIndex]); }
+	uint32_t GetTileIntersection(uint32_t tileIndex) const { return (m_TileIntersections[tileIndex]); }
+	/** The tiles of the intersection are [GetFirstTile, GetEndTile) */
+	uint32_t GetFirstTile(uint32_t intersectionIndex) const { return (m_IntersectionFirstTiles[intersectionIndex]); }
+	uint32_t GetEndTile(uint32_t intersectionIndex) const { return (m_IntersectionFirstTiles[intersectionIndex + 1]); }
+
+private:
+	/** The position of a tile in the track's table of intersection tiles, -1 if it's not there */
+	int FindTrackTile(const IntVector2D& position) const;
+
+private:
+	const ATrack& m_Track;
+
+	/** Our index of each tile of the track's table (same order as ATrack::GetIntersectionTiles) */
+	std::vector<uint32_t> m_TileIndexByTrackTile;
+	std::vector<IntVector2D> m_TilePositions;
+	/** The intersection of each tile */
+	std::vector<uint32_t> m_TileIntersections;
+	/** The tiles of the intersection i are [m_IntersectionFirstTiles[i], m_IntersectionFirstTiles[i + 1]) */
+	std::vector<uint32_t> m_IntersectionFirstTiles;
+};
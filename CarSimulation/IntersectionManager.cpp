@@ -0,0 +1,231 @@
+#include "IntersectionManager.h"
+#include "Car.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+IntersectionManager::IntersectionManager(const ATrack& track)
+	: m_Track(track),
+	m_Intersections(track),
+	m_TileSlots(m_Intersections.GetTilesAmount())
+{
+	for (uint32_t i = 0; i < m_Intersections.GetIntersectionsAmount(); i++)
+		assert(m_Intersections.GetEndTile(i) - m_Intersections.GetFirstTile(i) <= MaxIntersectionTiles);
+}
+
+bool IntersectionManager::TryReserve(const Car& car, const IntVector2D& intersectionTilePosition, const std::vector<const Car*>& nearbyCars)
+{
+	assert(m_Track.GetTrackChar(intersectionTilePosition) == INTERSECTION);
+	const uint32_t intersectionIndex = static_cast<uint32_t>(m_Intersections.FindIntersection(intersectionTilePosition));
+	const uint64_t currentTick = GetCurrentTick();
+
+	// A car that would get stuck in the intersection does not reserve anything, it ask again once the cars after it moved
+	if (IsExitClear(car, intersectionTilePosition, nearbyCars) == false)
+	{
+		ReleaseSlots(car, intersectionIndex, currentTick, nullptr, 0);
+		return (false);
+	}
+
+	CrossingPlan plan;
+	FindCrossingPlan(car, intersectionIndex, car.GetSpeed(), plan);
+	if (TryTakePlan(car, plan, currentTick, 0))
+	{
+		// The slots of the previous requests that are not in the plan anymore are free for the other cars
+		ReleaseSlots(car, intersectionIndex, currentTick, &plan, 0);
+		return (true);
+	}
+
+	// The car stop here, it keep the first slots it can get to cross from a standstill (the whole crossing have to fit in the slots)
+	FindCrossingPlan(car, intersectionIndex, 0.0f, plan);
+	uint64_t longestCrossingTicks = 0;
+	for (size_t i = 0; i < plan.tilesAmount; i++)
+		longestCrossingTicks = std::max(longestCrossingTicks, plan.tiles[i].exitTick);
+	const uint64_t lastSlotTick = (currentTick / SlotTicks + SlotsAmount) * SlotTicks - 1;
+	for (uint64_t delay = SlotTicks; currentTick + delay + longestCrossingTicks <= lastSlotTick; delay += SlotTicks)
+	{
+		if (TryTakePlan(car, plan, currentTick, delay))
+		{
+			ReleaseSlots(car, intersectionIndex, currentTick, &plan, delay);
+			return (false);
+		}
+	}
+	ReleaseSlots(car, intersectionIndex, currentTick, nullptr, 0);
+	return (false);
+}
+
+uint64_t IntersectionManager::GetCurrentTick() const
+{
+	return (static_cast<uint64_t>(std::llround(m_Track.GetTrafficLight().GetTime() / TickDurationInSecond)));
+}
+
+bool IntersectionManager::IsExitClear(const Car& car, const IntVector2D& intersectionTilePosition, const std::vector<const Car*>& nearbyCars) const
+{
+	const IntVector2D trackDirectionVector = GetDirectionVector(car.GetLastTrackDirection());
+	IntVector2D exitTilePosition = intersectionTilePosition;
+	while (m_Track.GetTrackChar(exitTilePosition) == INTERSECTION)
+		exitTilePosition += trackDirectionVector;
+
+	for (const Car* otherCar : nearbyCars)
+	{
+		if (otherCar->GetId() == car.GetId())
+			continue;
+		const CarKinematicState otherState = otherCar->GetState();
+		const IntVector2D otherTilePosition = m_Track.MapPositionOnTrack(otherState.position);
+		if (otherState.speed == 0.0f && (otherTilePosition == exitTilePosition || otherTilePosition == exitTilePosition + trackDirectionVector))
+			return (false);
+	}
+	return (true);
+}
+
+void IntersectionManager::FindCrossingPlan(const Car& car, uint32_t intersectionIndex, float startSpeed, CrossingPlan& outPlan) const
+{
+	const CarKinematicState state = car.GetState();
+	const Vector2D direction = Vector2D(GetDirectionVector(car.GetLastTrackDirection())).Normalize();
+
+	// The distances along the lane between which the circle of the car touch each tile
+	// (the tile grown by the radius of the car, the safe distance is shared with the other car)
+	constexpr float Radius = CAR_SIZE_RADIUS + SAFE_DISTANCE_BETWEEN_CARS / 2.0f;
+	constexpr uint64_t HorizonTicks = static_cast<uint64_t>(SlotsAmount) * SlotTicks;
+	std::array<float, MaxIntersectionTiles> enterDistances;
+	std::array<float, MaxIntersectionTiles> exitDistances;
+	outPlan.tilesAmount = 0;
+	for (uint32_t tileIndex = m_Intersections.GetFirstTile(intersectionIndex); tileIndex < m_Intersections.GetEndTile(intersectionIndex); tileIndex++)
+	{
+		const Vector2D tileMin = Vector2D(m_Intersections.GetTilePosition(tileIndex)) - Radius;
+		const Vector2D tileMax = Vector2D(m_Intersections.GetTilePosition(tileIndex)) + (1.0f + Radius);
+		const float positions[2] = { state.position.x, state.position.y };
+		const float directions[2] = { direction.x, direction.y };
+		const float mins[2] = { tileMin.x, tileMin.y };
+		const float maxs[2] = { tileMax.x, tileMax.y };
+		float enterDistance = 0.0f;
+		float exitDistance = std::numeric_limits<float>::max();
+		for (int axis = 0; axis < 2; axis++)
+		{
+			if (directions[axis] == 0.0f)
+			{
+				if (positions[axis] < mins[axis] || positions[axis] > maxs[axis])
+					exitDistance = -1.0f;
+				continue;
+			}
+			const float first = (mins[axis] - positions[axis]) / directions[axis];
+			const float second = (maxs[axis] - positions[axis]) / directions[axis];
+			enterDistance = std::max(enterDistance, std::min(first, second));
+			exitDistance = std::min(exitDistance, std::max(first, second));
+		}
+		if (enterDistance > exitDistance)
+			continue;
+
+		enterDistances[outPlan.tilesAmount] = enterDistance;
+		exitDistances[outPlan.tilesAmount] = exitDistance;
+		outPlan.tiles[outPlan.tilesAmount] = { tileIndex, HorizonTicks, HorizonTicks };
+		outPlan.tilesAmount++;
+	}
+
+	// The lane does not cross any tile of this intersection, nothing to reserve
+	if (outPlan.tilesAmount == 0)
+		return;
+
+	// Accelerate like Move would, the move of the tick i (from the start) end at 'distance'
+	const float lastExitDistance = *std::max_element(exitDistances.begin(), exitDistances.begin() + outPlan.tilesAmount);
+	float speed = startSpeed;
+	float distance = 0.0f;
+	for (uint64_t i = 0; i < HorizonTicks; i++)
+	{
+		speed = std::min(car.GetMaxSpeed(), speed + car.GetAcceleration() * car.GetMaxSpeed());
+		distance += speed;
+		for (size_t j = 0; j < outPlan.tilesAmount; j++)
+		{
+			TileCrossing& crossing = outPlan.tiles[j];
+			if (crossing.enterTick == HorizonTicks && distance >= enterDistances[j])
+				crossing.enterTick = i;
+			if (crossing.exitTick == HorizonTicks && distance >= exitDistances[j])
+				crossing.exitTick = i;
+		}
+		if (distance >= lastExitDistance)
+			break;
+	}
+
+	// The tiles too far to be reserved yet are asked later, while approaching
+	size_t reachedTilesAmount = 0;
+	for (size_t j = 0; j < outPlan.tilesAmount; j++)
+	{
+		TileCrossing crossing = outPlan.tiles[j];
+		if (crossing.enterTick == HorizonTicks)
+			continue;
+		crossing.enterTick = (crossing.enterTick > MarginTicks ? crossing.enterTick - MarginTicks : 0);
+		crossing.exitTick += MarginTicks;
+		outPlan.tiles[reachedTilesAmount++] = crossing;
+	}
+	outPlan.tilesAmount = reachedTilesAmount;
+}
+
+void IntersectionManager::GetCrossingPeriods(const TileCrossing& crossing, uint64_t currentTick, uint64_t delay, uint64_t& outFirstPeriod, uint64_t& outLastPeriod) const
+{
+	// A car too slow to cross within the slots keep all the slots until the last one, and ask for the rest while approaching
+	outFirstPeriod = (currentTick + delay + crossing.enterTick) / SlotTicks;
+	outLastPeriod = std::min((currentTick + delay + crossing.exitTick) / SlotTicks, currentTick / SlotTicks + SlotsAmount - 1);
+}
+
+bool IntersectionManager::TryTakePlan(const Car& car, const CrossingPlan& plan, uint64_t currentTick, uint64_t delay)
+{
+	// Look first, the compare and swaps are only done for a plan that look free
+	// (and always in the same order, tiles then periods, so two cars wanting the same slots fail on the first one they share)
+	uint64_t firstPeriod;
+	uint64_t lastPeriod;
+	for (size_t i = 0; i < plan.tilesAmount; i++)
+	{
+		GetCrossingPeriods(plan.tiles[i], currentTick, delay, firstPeriod, lastPeriod);
+		const TileSlots& tileSlots = m_TileSlots[plan.tiles[i].tileIndex];
+		for (uint64_t period = firstPeriod; period <= lastPeriod; period++)
+			if (IsAvailable(tileSlots.entries[period % SlotsAmount].load(std::memory_order_relaxed), MakeCarEntry(period, car.GetId()), period) == false)
+				return (false);
+	}
+
+	for (size_t i = 0; i < plan.tilesAmount; i++)
+	{
+		GetCrossingPeriods(plan.tiles[i], currentTick, delay, firstPeriod, lastPeriod);
+		TileSlots& tileSlots = m_TileSlots[plan.tiles[i].tileIndex];
+		for (uint64_t period = firstPeriod; period <= lastPeriod; period++)
+		{
+			// The entries are only about themselves (nothing else is published with them), relaxed is enough
+			std::atomic<uint64_t>& entry = tileSlots.entries[period % SlotsAmount];
+			const uint64_t carEntry = MakeCarEntry(period, car.GetId());
+			uint64_t currentEntry = entry.load(std::memory_order_relaxed);
+			do
+			{
+				if (currentEntry == carEntry)
+					break;
+				// Another thread was faster
+				if (IsAvailable(currentEntry, carEntry, period) == false)
+					return (false);
+			} while (entry.compare_exchange_weak(currentEntry, carEntry, std::memory_order_relaxed) == false);
+		}
+	}
+	return (true);
+}
+
+void IntersectionManager::ReleaseSlots(const Car& car, uint32_t intersectionIndex, uint64_t currentTick, const CrossingPlan* keptPlan, uint64_t keptDelay)
+{
+	const uint64_t currentPeriod = currentTick / SlotTicks;
+	for (uint32_t tileIndex = m_Intersections.GetFirstTile(intersectionIndex); tileIndex < m_Intersections.GetEndTile(intersectionIndex); tileIndex++)
+	{
+		// No period is kept when the first one is after the last one
+		uint64_t keptFirstPeriod = 1;
+		uint64_t keptLastPeriod = 0;
+		for (size_t i = 0; keptPlan && i < keptPlan->tilesAmount; i++)
+			if (keptPlan->tiles[i].tileIndex == tileIndex)
+				GetCrossingPeriods(keptPlan->tiles[i], currentTick, keptDelay, keptFirstPeriod, keptLastPeriod);
+
+		for (uint64_t period = currentPeriod; period < currentPeriod + SlotsAmount; period++)
+		{
+			if (period >= keptFirstPeriod && period <= keptLastPeriod)
+				continue;
+			// Nobody else write an entry of this car, so it's still there after the load
+			std::atomic<uint64_t>& entry = m_TileSlots[tileIndex].entries[period % SlotsAmount];
+			uint64_t carEntry = MakeCarEntry(period, car.GetId());
+			if (entry.load(std::memory_order_relaxed) == carEntry)
+				entry.compare_exchange_strong(carEntry, 0, std::memory_order_relaxed);
+		}
+	}
+}
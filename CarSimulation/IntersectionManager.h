@@ -0,0 +1,116 @@
+#pragma once
+
+#include "Defines.h"
+#include "Track.h"
+#include "IntersectionIndex.h"
+
+#include <vector>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+class Car;
+
+/**
+ * Let the cars cross the intersections without lights: a car arriving at an intersection ask for the time slots
+ * during which it will be on each of its tiles, and only go if it got all of them (see Car::Move).
+ * Each intersection tile remember the owner of the next SlotsAmount slots in a ring of atomic entries,
+ * a reservation is a compare and swap per slot, so the cars moved by different threads reserve at the same time without any lock.
+ * Two cars only conflict if they want the same tile at the same time, so the crossing flows share the intersection
+ * instead of waiting for their light phase.
+ * A car ask again every tick while approaching (it keep the slots it already own). If the intersection is busy it stop
+ * and reserve the first time it can cross from a standstill, so the cars arriving later can't take its turn (first come first served).
+ * The time is read from the lights of the track (whoever drive the simulation already set it every tick).
+ * note: the reservations are only shared between the threads of a process, not with the other shards.
+ */
+class IntersectionManager
+{
+
+public:
+	/** Amount of slots remembered per intersection tile, a car can't reserve further ahead than SlotsAmount * SlotTicks ticks */
+	static constexpr uint32_t SlotsAmount = 64;
+	/** Amount of ticks covered by a slot */
+	static constexpr uint32_t SlotTicks = 2;
+	/** Ticks added before and after each crossing, the car does not follow exactly the speed we expect (it brake behind other cars) */
+	static constexpr uint32_t MarginTicks = 2;
+	/** The biggest block of intersection tiles handled (the maps only have 2x2 crossings) */
+	static constexpr uint32_t MaxIntersectionTiles = 16;
+
+public:
+	explicit IntersectionManager(const ATrack& track);
+	IntersectionManager(const IntersectionManager&) = delete;
+	IntersectionManager& operator=(const IntersectionManager&) = delete;
+
+public:
+	/**
+	 * Try to reserve the intersection ahead of the car, for the time it need to cross it if it accelerate from its current speed.
+	 * All or nothing: if a slot is owned by another car the car can't go now, it keep instead the first slots it can get
+	 * to cross later from a standstill (and give back the others).
+	 * Lock free and thread safe, as long as a car is only moved by one thread at the time.
+	 *
+	 * \param car The car asking, it's expected to drive straight through (its last track direction).
+	 * \param intersectionTilePosition Any intersection tile of the intersection ahead.
+	 * \param nearbyCars The cars that may be queuing after the intersection.
+	 * \return true if the car own every slot it need and can go now, false if it have to wait.
+	 */
+	bool TryReserve(const Car& car, const IntVector2D& intersectionTilePosition, const std::vector<const Car*>& nearbyCars);
+
+	/** The tick the lights of the track are at */
+	uint64_t GetCurrentTick() const;
+	size_t GetIntersectionsAmount() const { return (m_Intersections.GetIntersectionsAmount()); }
+	size_t GetIntersectionTilesAmount() const { return (m_Intersections.GetTilesAmount()); }
+
+private:
+	/** The slots of an intersection tile, on their own cache lines (the tiles of an intersection are reserved by different threads) */
+	struct alignas(CACHE_LINE_SIZE) TileSlots
+	{
+		/** Slot of the period p at index p % SlotsAmount, the entries are (p << 32) | (car id + 1), 0 if the slot was never taken */
+		std::array<std::atomic<uint64_t>, SlotsAmount> entries;
+	};
+	/** When the car will be on a tile, in ticks from the moment it start accelerating (margins included) */
+	struct TileCrossing
+	{
+		uint32_t tileIndex = 0;
+		uint64_t enterTick = 0;
+		uint64_t exitTick = 0;
+	};
+	/** The tiles a car will be on while crossing an intersection */
+	struct CrossingPlan
+	{
+		std::array<TileCrossing, MaxIntersectionTiles> tiles;
+		size_t tilesAmount = 0;
+	};
+
+	/**
+	 * Check that the car can leave the intersection once in it: no car stopped on the first 2 tiles after it.
+	 * Otherwise the car would stop in the middle of the intersection and block the other flows once its slots run out.
+	 */
+	bool IsExitClear(const Car& car, const IntVector2D& intersectionTilePosition, const std::vector<const Car*>& nearbyCars) const;
+	/**
+	 * Find when the car will be close enough to each tile to hit a car on it (its circle touch the tile),
+	 * if it accelerate like Move from the given speed. The tiles it does not reach within the slots are left out.
+	 */
+	void FindCrossingPlan(const Car& car, uint32_t intersectionIndex, float startSpeed, CrossingPlan& outPlan) const;
+	/** Get the periods (ticks / SlotTicks) of a tile crossing started 'delay' ticks after the current one (cut at the last slot) */
+	void GetCrossingPeriods(const TileCrossing& crossing, uint64_t currentTick, uint64_t delay, uint64_t& outFirstPeriod, uint64_t& outLastPeriod) const;
+	/**
+	 * Take every slot of the plan started 'delay' ticks after the current one, the slots already owned by the car are kept.
+	 * If a slot is owned by another car it stop there, the slots taken until then are left to ReleaseSlots.
+	 */
+	bool TryTakePlan(const Car& car, const CrossingPlan& plan, uint64_t currentTick, uint64_t delay);
+	/** Give back the slots of the intersection owned by the car, except the ones of the kept plan (if any) */
+	void ReleaseSlots(const Car& car, uint32_t intersectionIndex, uint64_t currentTick, const CrossingPlan* keptPlan, uint64_t keptDelay);
+
+	static uint64_t GetEntryPeriod(uint64_t entry) { return (entry >> 32); }
+	static uint64_t MakeCarEntry(uint64_t period, uint32_t carId) { return ((period << 32) | (static_cast<uint64_t>(carId) + 1)); }
+	/** Whether the car can take the entry for the period: free (never taken, or taken for an older period) or already its own */
+	static bool IsAvailable(uint64_t entry, uint64_t carEntry, uint64_t period) { return (entry == 0 || entry == carEntry || GetEntryPeriod(entry) < period); }
+
+private:
+	const ATrack& m_Track;
+
+	/** The intersection tiles, the slots of a tile are at its index in m_TileSlots */
+	const IntersectionIndex m_Intersections;
+	std::vector<TileSlots> m_TileSlots;
+};
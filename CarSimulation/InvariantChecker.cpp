@@ -0,0 +1,148 @@
+#include "InvariantChecker.h"
+
+#include <algorithm>
+#include <cassert>
+
+InvariantChecker::InvariantChecker(const ATrack& track, size_t carsAmount, EInvariantCheckMode mode, uint64_t samplingTicks, size_t logSize)
+	: m_Track(track), m_Mode(mode), m_SamplingTicks(std::max<uint64_t>(1, samplingTicks)), m_SortedCars(track), m_Log(logSize)
+{
+	assert(logSize > 0);
+	if (m_Mode == EInvariantCheckMode::Off)
+		return;
+	m_SortedCars.Reserve(carsAmount);
+	m_Positions.resize(carsAmount);
+}
+
+void InvariantChecker::CheckTick(uint64_t tick, const std::vector<Car*>& cars)
+{
+	if (IsCheckedTick(tick) == false)
+		return;
+	CheckOverlaps(tick, cars, nullptr);
+	CheckOffTrack(tick, cars);
+	m_CheckedTicksAmount++;
+}
+
+void InvariantChecker::CheckTick(uint64_t tick, const std::vector<Car*>& cars, const std::vector<uint32_t>& overlapCarIds)
+{
+	if (IsCheckedTick(tick) == false)
+		return;
+	CheckOverlaps(tick, cars, &overlapCarIds);
+	CheckOffTrack(tick, cars);
+	m_CheckedTicksAmount++;
+}
+
+size_t InvariantChecker::GetLoggedViolationsAmount() const
+{
+	return (static_cast<size_t>(std::min<uint64_t>(m_LoggedAmount, m_Log.size())));
+}
+
+const InvariantViolationRecord& InvariantChecker::GetLoggedViolation(size_t index) const
+{
+	assert(index < GetLoggedViolationsAmount());
+	// Once the ring is full, the oldest violation is the next one to be overwritten
+	if (m_LoggedAmount < m_Log.size())
+		return (m_Log[index]);
+	return (m_Log[(m_LogNextIndex + index) % m_Log.size()]);
+}
+
+void InvariantChecker::PrintReport(std::ostream& stream) const
+{
+	if (m_LoggedAmount == 0)
+		return;
+
+	stream << "Invariants: " << GetViolationsAmount(EInvariantViolation::Overlap) << " overlaps and "
+		<< GetViolationsAmount(EInvariantViolation::OffTrack) << " cars off the track in " << m_CheckedTicksAmount << " checked ticks" << std::endl;
+	const size_t loggedAmount = GetLoggedViolationsAmount();
+	for (size_t i = loggedAmount - std::min(loggedAmount, PrintedViolationsAmount); i < loggedAmount; i++)
+	{
+		const InvariantViolationRecord& record = GetLoggedViolation(i);
+		if (record.violation == EInvariantViolation::Overlap)
+			stream << "  tick " << record.tick << ": cars " << record.carId << " and " << record.otherCarId << " overlap" << std::endl;
+		else
+			stream << "  tick " << record.tick << ": car " << record.carId << " is off the track" << std::endl;
+	}
+}
+
+bool InvariantChecker::IsCheckedTick(uint64_t tick) const
+{
+	switch (m_Mode)
+	{
+	case EInvariantCheckMode::Off: return (false);
+	case EInvariantCheckMode::Sampled: return (tick % m_SamplingTicks == 0);
+	case EInvariantCheckMode::Exhaustive: return (true);
+	}
+	return (false);
+}
+
+void InvariantChecker::CheckOverlaps(uint64_t tick, const std::vector<Car*>& cars, const std::vector<uint32_t>* carIds)
+{
+	// Read each published position once, then sort the cars by tile
+	m_SortedCars.Clear();
+	const size_t carsAmount = (carIds ? carIds->size() : cars.size());
+	for (size_t i = 0; i < carsAmount; i++)
+	{
+		const uint32_t carId = (carIds ? (*carIds)[i] : static_cast<uint32_t>(i));
+		assert(carId < m_Positions.size() && cars[carId]->GetId() == carId);
+		m_Positions[carId] = cars[carId]->GetPosition();
+		m_SortedCars.Add(m_Positions[carId], carId);
+	}
+	m_SortedCars.Sort();
+
+	// The cars can only touch the cars of the tiles around them (2 car radius is less than a tile),
+	// each tile is compared with itself and half of its neighbours so each pair of tiles is only compared once
+	for (size_t first = 0; first < m_SortedCars.GetSize();)
+	{
+		const size_t last = m_SortedCars.FindTileEnd(first);
+		const IntVector2D tile = m_SortedCars.GetTile(first);
+		CheckTileAgainst(tick, first, last, tile, true);
+		CheckTileAgainst(tick, first, last, tile + IntVector2D(1, -1), false);
+		CheckTileAgainst(tick, first, last, tile + IntVector2D(1, 0), false);
+		CheckTileAgainst(tick, first, last, tile + IntVector2D(1, 1), false);
+		CheckTileAgainst(tick, first, last, tile + IntVector2D(0, 1), false);
+		first = last;
+	}
+}
+
+void InvariantChecker::CheckOffTrack(uint64_t tick, const std::vector<Car*>& cars)
+{
+	for (const Car* car : cars)
+	{
+		if (m_Track.IsHereARoad(m_Track.MapPositionOnTrack(car->GetPosition())) == false)
+			Record(tick, EInvariantViolation::OffTrack, car->GetId(), car->GetId());
+	}
+}
+
+void InvariantChecker::CheckTileAgainst(uint64_t tick, size_t first, size_t last, const IntVector2D& tile, bool isSameTile)
+{
+	constexpr float CarsMininumDistanceRequired = CAR_SIZE_RADIUS * 2.0f;
+
+	const auto checkPair = [&](size_t i, size_t j)
+	{
+		const uint32_t carId = m_SortedCars.GetCarIndex(i);
+		const uint32_t otherCarId = m_SortedCars.GetCarIndex(j);
+		if ((m_Positions[otherCarId] - m_Positions[carId]).LengthSquared() <= CarsMininumDistanceRequired * CarsMininumDistanceRequired)
+			Record(tick, EInvariantViolation::Overlap, std::min(carId, otherCarId), std::max(carId, otherCarId));
+	};
+	if (isSameTile)
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			for (size_t j = i + 1; j < last; j++)
+				checkPair(i, j);
+		}
+		return;
+	}
+	m_SortedCars.ForEachInTiles(tile, tile, [&](size_t j)
+	{
+		for (size_t i = first; i < last; i++)
+			checkPair(i, j);
+	});
+}
+
+void InvariantChecker::Record(uint64_t tick, EInvariantViolation violation, uint32_t carId, uint32_t otherCarId)
+{
+	m_ViolationsAmounts[static_cast<size_t>(violation)]++;
+	m_Log[m_LogNextIndex] = { tick, violation, carId, otherCarId };
+	m_LogNextIndex = (m_LogNextIndex + 1) % m_Log.size();
+	m_LoggedAmount++;
+}
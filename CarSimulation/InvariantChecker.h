@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+#include "TileSortedCars.h"
+
+#include <vector>
+#include <iostream>
+#include <cstdint>
+
+enum class EInvariantCheckMode
+{
+	Off,
+	/** The cars are checked once every sampling ticks */
+	Sampled,
+	/** The cars are checked every tick */
+	Exhaustive
+};
+
+/** The mode selected in Defines.h */
+constexpr EInvariantCheckMode SelectedInvariantCheckMode = (INVARIANT_CHECK == 2 ? EInvariantCheckMode::Exhaustive : (INVARIANT_CHECK == 1 ? EInvariantCheckMode::Sampled : EInvariantCheckMode::Off));
+
+enum class EInvariantViolation : uint8_t
+{
+	/** Two cars are closer than 2 car radius */
+	Overlap,
+	/** A car is not on a road tile */
+	OffTrack
+};
+
+struct InvariantViolationRecord
+{
+	uint64_t tick = 0;
+	EInvariantViolation violation = EInvariantViolation::Overlap;
+	uint32_t carId = 0;
+	/** The other car of an overlap (the lowest id is carId) */
+	uint32_t otherCarId = 0;
+};
+
+/**
+ * Check that the cars never overlap and never leave the road, as part of the tick (see INVARIANT_CHECK).
+ * The cars are put in a grid of the tiles (sorted by tile, the grid of a 10000 x 10000 map would not fit in memory),
+ * a car is only compared with the cars of its tile and of the tiles around it: the cost is O(cars * log(cars)) instead of O(cars^2).
+ * Every violation is counted, the last LogSize ones are kept with their tick and their cars (the older ones are overwritten).
+ * Nothing is allocated after the construction.
+ * note: the car ids have to be their index in the cars vector.
+ */
+class InvariantChecker
+{
+
+public:
+	/**
+	 * \param carsAmount The cars ids have to be lower than it.
+	 * \param samplingTicks With the sampled mode, the amount of ticks between 2 checks.
+	 * \param logSize The amount of violations kept.
+	 */
+	InvariantChecker(const ATrack& track, size_t carsAmount, EInvariantCheckMode mode, uint64_t samplingTicks, size_t logSize);
+
+public:
+	/** Check the cars at the end of a tick, if the mode say this tick is checked */
+	void CheckTick(uint64_t tick, const std::vector<Car*>& cars);
+	/**
+	 * Same, but only the given cars are checked for overlaps (every car is checked for off track).
+	 * For the level of detail engine, its queued cars share their tile on purpose (see LodEngine).
+	 */
+	void CheckTick(uint64_t tick, const std::vector<Car*>& cars, const std::vector<uint32_t>& overlapCarIds);
+
+	uint64_t GetCheckedTicksAmount() const { return (m_CheckedTicksAmount); }
+	uint64_t GetViolationsAmount(EInvariantViolation violation) const { return (m_ViolationsAmounts[static_cast<size_t>(violation)]); }
+	/** Amount of violations still in the log */
+	size_t GetLoggedViolationsAmount() const;
+	/** The violations in the log, 0 is the oldest */
+	const InvariantViolationRecord& GetLoggedViolation(size_t index) const;
+
+	/** Print the amount of violations and the last ones (nothing as long as there is none) */
+	void PrintReport(std::ostream& stream) const;
+
+private:
+	/** The amount of logged violations printed by PrintReport */
+	static constexpr size_t PrintedViolationsAmount = 5;
+
+	bool IsCheckedTick(uint64_t tick) const;
+	/** Sort the cars (all of them when carIds is null) by tile then record their overlaps */
+	void CheckOverlaps(uint64_t tick, const std::vector<Car*>& cars, const std::vector<uint32_t>* carIds);
+	void CheckOffTrack(uint64_t tick, const std::vector<Car*>& cars);
+	/** Compare the cars of the sorted range [first, last) with the cars of the tile, each pair once */
+	void CheckTileAgainst(uint64_t tick, size_t first, size_t last, const IntVector2D& tile, bool isSameTile);
+	void Record(uint64_t tick, EInvariantViolation violation, uint32_t carId, uint32_t otherCarId);
+
+private:
+	const ATrack& m_Track;
+	const EInvariantCheckMode m_Mode;
+	const uint64_t m_SamplingTicks;
+
+	/** The cars by id, sorted for each check (the cars off the map are put on its border, they're reported by the off track check anyway) */
+	TileSortedCars m_SortedCars;
+	/** The position of each car when it was sorted, by car id (the cars can still move in the thread per car mode) */
+	std::vector<Vector2D> m_Positions;
+
+	uint64_t m_CheckedTicksAmount = 0;
+	uint64_t m_ViolationsAmounts[2] = {};
+	/** Ring of the last violations, m_LogNextIndex is where the next one go */
+	std::vector<InvariantViolationRecord> m_Log;
+	size_t m_LogNextIndex = 0;
+	uint64_t m_LoggedAmount = 0;
+};
@@ -0,0 +1,338 @@
+#include "LodEngine.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace
+{
+	/** Room taken by a car in a lane, with the gap kept with the car ahead */
+	constexpr float CarLength = CAR_SIZE_RADIUS * 2.0f + SAFE_DISTANCE_BETWEEN_CARS;
+	/** Two micro cars closer than that would touch on the next Move (it also keep the safe distance) */
+	constexpr float MicroCarsMinimumDistance = CAR_SIZE_RADIUS * 2.0f + SAFE_DISTANCE_BETWEEN_CARS * 2.0f;
+
+	char GetStraightDirectionChar(const IntVector2D& directionVector)
+	{
+		if (directionVector.x != 0)
+			return (directionVector.x > 0 ? RIGHT : LEFT);
+		return (directionVector.y > 0 ? DOWN : UP);
+	}
+}
+
+LodEngine::LodEngine(const ATrack& track, const std::vector<Car*>& cars, const std::vector<uint32_t>& focusCarIds, int microRadius)
+	: m_Track(track),
+	m_Cars(cars),
+	m_FocusCarIds(focusCarIds),
+	m_MicroRadius(microRadius),
+	m_IsMicroCar(cars.size(), false),
+	m_Cells(static_cast<size_t>(track.GetWidth()) * track.GetHeight()),
+	m_MesoCars(cars.size())
+{
+	assert(microRadius >= 1);
+	for (uint32_t focusCarId : focusCarIds)
+	{
+		assert(focusCarId < cars.size());
+		m_FocusTiles.push_back(m_Track.MapPositionOnTrack(cars[focusCarId]->GetPosition()));
+	}
+
+	// Only the cars around the focus start in the full model
+	m_MicroCarIds.reserve(cars.size());
+	m_MicroView.reserve(cars.size());
+	for (const auto& car : cars)
+	{
+		assert(car->GetId() < cars.size());
+		if (GetFocusDistance(m_Track.MapPositionOnTrack(car->GetPosition())) <= m_MicroRadius + 1 || MakeMeso(car->GetId()) == false)
+		{
+			m_IsMicroCar[car->GetId()] = true;
+			m_MicroCarIds.push_back(car->GetId());
+		}
+	}
+}
+
+void LodEngine::Tick()
+{
+	for (size_t i = 0; i < m_FocusCarIds.size(); i++)
+		m_FocusTiles[i] = m_Track.MapPositionOnTrack(m_Cars[m_FocusCarIds[i]]->GetPosition());
+
+	GatherMicroView();
+	for (uint32_t carId : m_MicroCarIds)
+		m_Cars[carId]->Move(m_MicroView);
+	DemoteFarCars();
+	MoveMesoCars();
+	m_Tick++;
+
+	// Nobody is lost (or counted twice) between the two models
+	assert(m_MicroCarIds.size() + m_MesoCarsAmount == m_Cars.size());
+}
+
+int LodEngine::GetFocusDistance(const IntVector2D& tilePosition) const
+{
+	int distance = INT_MAX;
+	for (const IntVector2D& focusTile : m_FocusTiles)
+		distance = std::min(distance, std::max(std::abs(tilePosition.x - focusTile.x), std::abs(tilePosition.y - focusTile.y)));
+	return (distance);
+}
+
+void LodEngine::GatherMicroView()
+{
+	m_MicroView.clear();
+	for (uint32_t carId : m_MicroCarIds)
+		m_MicroView.push_back(m_Cars[carId]);
+
+	// The meso cars of the micro area and its border, each cell only once when the areas of the focus cars overlap
+	const int borderRadius = m_MicroRadius + 1;
+	for (size_t i = 0; i < m_FocusTiles.size(); i++)
+	{
+		const IntVector2D& focusTile = m_FocusTiles[i];
+		for (int y = std::max(0, focusTile.y - borderRadius); y <= std::min(m_Track.GetHeight() - 1, focusTile.y + borderRadius); y++)
+			for (int x = std::max(0, focusTile.x - borderRadius); x <= std::min(m_Track.GetWidth() - 1, focusTile.x + borderRadius); x++)
+			{
+				bool isSeenBefore = false;
+				for (size_t j = 0; j < i && isSeenBefore == false; j++)
+					isSeenBefore = (std::max(std::abs(x - m_FocusTiles[j].x), std::abs(y - m_FocusTiles[j].y)) <= borderRadius);
+				if (isSeenBefore)
+					continue;
+
+				for (uint32_t carId = m_Cells[GetCellIndex(IntVector2D(x, y))].firstCarId; carId != NoCarId; carId = m_MesoCars[carId].nextCarId)
+					m_MicroView.push_back(m_Cars[carId]);
+			}
+	}
+}
+
+void LodEngine::DemoteFarCars()
+{
+	// The border let the cars drive a bit around the micro area without going back and forth between the models
+	auto isDemoted = [this](uint32_t carId)
+	{
+		return (GetFocusDistance(m_Track.MapPositionOnTrack(m_Cars[carId]->GetPosition())) > m_MicroRadius + 1 && MakeMeso(carId));
+	};
+	m_MicroCarIds.erase(std::remove_if(m_MicroCarIds.begin(), m_MicroCarIds.end(), isDemoted), m_MicroCarIds.end());
+}
+
+void LodEngine::MoveMesoCars()
+{
+	// The cells occupied during this tick only hold cars that just arrived, nothing to do with them
+	const size_t occupiedCellsAmount = m_OccupiedCells.size();
+	for (size_t i = 0; i < occupiedCellsAmount; i++)
+	{
+		const uint32_t cellIndex = m_OccupiedCells[i];
+		if (m_Cells[cellIndex].carsAmount == 0)
+			continue;
+		if (IsInMicroArea(GetCellPosition(cellIndex)))
+			PromoteCars(cellIndex);
+		else
+			TryMoveFirstCar(cellIndex);
+	}
+
+	auto isEmpty = [this](uint32_t cellIndex)
+	{
+		MesoCell& cell = m_Cells[cellIndex];
+		cell.isOccupied = (cell.carsAmount > 0);
+		return (cell.isOccupied == false);
+	};
+	m_OccupiedCells.erase(std::remove_if(m_OccupiedCells.begin(), m_OccupiedCells.end(), isEmpty), m_OccupiedCells.end());
+}
+
+void LodEngine::PromoteCars(uint32_t cellIndex)
+{
+	// Once the first car is back on the road the next one is at the same place, it will wait for it to drive away
+	while (m_Cells[cellIndex].carsAmount > 0)
+	{
+		const uint32_t carId = m_Cells[cellIndex].firstCarId;
+		const Vector2D position = GetPlaceInCell(cellIndex, m_MesoCars[carId].trackDirectionChar, 0);
+		if (IsFreeForMicroCar(carId, position) == false)
+			break;
+		PopFirstCar(cellIndex);
+		MakeMicro(carId, position);
+	}
+}
+
+void LodEngine::TryMoveFirstCar(uint32_t cellIndex)
+{
+	const uint32_t carId = m_Cells[cellIndex].firstCarId;
+	const MesoCar& mesoCar = m_MesoCars[carId];
+	if (m_Tick < mesoCar.readyTick)
+		return;
+
+	// Find why the car can't go, if it can't
+	char trackDirectionChar = mesoCar.trackDirectionChar;
+	uint32_t nextCellIndex = 0;
+	EMoveResult waitReason = EMoveResult::Moving;
+	const IntVector2D tilePosition = GetCellPosition(cellIndex);
+	if (FindNextCell(cellIndex, trackDirectionChar, nextCellIndex) == false)
+		waitReason = EMoveResult::BlockedByCar;
+	else if (IsInMicroArea(GetCellPosition(nextCellIndex)))
+	{
+		// Entering the micro area, the full model take the car from where it is
+		const Vector2D position = GetPlaceInCell(cellIndex, mesoCar.trackDirectionChar, 0);
+		if (IsFreeForMicroCar(carId, position))
+		{
+			PopFirstCar(cellIndex);
+			MakeMicro(carId, position);
+			return;
+		}
+		waitReason = EMoveResult::BlockedByCar;
+	}
+	// Same rule as Car::Move, the light is checked 2 tiles before the intersection
+	else if (m_Track.GetIntersectionManager() == nullptr && m_Track.GetTrackChar(tilePosition) != INTERSECTION
+		&& m_Track.GetTrackChar(tilePosition + GetDirectionVector(mesoCar.trackDirectionChar) * 2) == INTERSECTION
+		&& m_Track.GetTrafficLight().IsGreenFor(mesoCar.trackDirectionChar) == false)
+		waitReason = EMoveResult::StoppedAtRedLight;
+	else if (m_Cells[nextCellIndex].carsAmount >= GetCellCapacity(nextCellIndex))
+		waitReason = EMoveResult::BlockedByCar;
+	// The micro cars of the border do not count in the cells, they can't be driven through
+	else if (GetFocusDistance(GetCellPosition(nextCellIndex)) == m_MicroRadius + 1
+		&& IsFreeForMicroCar(carId, GetPlaceInCell(nextCellIndex, trackDirectionChar, m_Cells[nextCellIndex].carsAmount)) == false)
+		waitReason = EMoveResult::BlockedByCar;
+
+	if (waitReason == EMoveResult::Moving)
+	{
+		PopFirstCar(cellIndex);
+		PushCar(nextCellIndex, carId, trackDirectionChar);
+	}
+	else if (m_Cars[carId]->GetSpeed() != 0.0f || m_Cars[carId]->GetLastMoveResult() != waitReason)
+		PublishMesoCar(carId, cellIndex, 0, 0.0f, waitReason);
+}
+
+bool LodEngine::MakeMeso(uint32_t carId)
+{
+	const Car* car = m_Cars[carId];
+	const IntVector2D tilePosition = m_Track.MapPositionOnTrack(car->GetPosition());
+	const char trackChar = m_Track.GetTrackChar(tilePosition);
+	if (m_Track.IsRoad(trackChar) == false)
+		return (false);
+
+	m_IsMicroCar[carId] = false;
+	PushCar(GetCellIndex(tilePosition), carId, trackChar == INTERSECTION ? car->GetLastTrackDirection() : trackChar);
+	return (true);
+}
+
+void LodEngine::MakeMicro(uint32_t carId, const Vector2D& position)
+{
+	Car* car = m_Cars[carId];
+	const char trackDirectionChar = m_MesoCars[carId].trackDirectionChar;
+	CarKinematicState state = car->GetState();
+	state.position = position;
+	state.forwardVector = Vector2D(GetDirectionVector(trackDirectionChar)).Normalize();
+	state.lastMoveResult = EMoveResult::Moving;
+	// The published speed is already 0 if it was waiting, Move will brake if needed
+	car->ApplyState(state, trackDirectionChar);
+
+	m_IsMicroCar[carId] = true;
+	m_MicroCarIds.push_back(carId);
+	m_MicroView.push_back(car);
+}
+
+bool LodEngine::IsFreeForMicroCar(uint32_t carId, const Vector2D& position) const
+{
+	for (const Car* car : m_MicroView)
+	{
+		if (car->GetId() != carId && (car->GetPosition() - position).LengthSquared() < MicroCarsMinimumDistance * MicroCarsMinimumDistance)
+			return (false);
+	}
+	return (true);
+}
+
+bool LodEngine::FindNextCell(uint32_t cellIndex, char& inOutTrackDirectionChar, uint32_t& outNextCellIndex) const
+{
+	const IntVector2D tilePosition = GetCellPosition(cellIndex);
+	const char trackChar = m_Track.GetTrackChar(tilePosition);
+	const IntVector2D directionVector = GetDirectionVector(trackChar == INTERSECTION ? inOutTrackDirectionChar : trackChar);
+	IntVector2D nextTilePosition = tilePosition + directionVector;
+
+	// A car that changed lane just before the intersection may come out of it in diagonal, it leave by the straight road
+	if (trackChar == INTERSECTION && m_Track.IsRoad(m_Track.GetTrackChar(nextTilePosition)) == false && directionVector.x != 0 && directionVector.y != 0)
+	{
+		nextTilePosition = tilePosition + IntVector2D(directionVector.x, 0);
+		if (m_Track.IsRoad(m_Track.GetTrackChar(nextTilePosition)) == false)
+			nextTilePosition = tilePosition + IntVector2D(0, directionVector.y);
+		inOutTrackDirectionChar = GetStraightDirectionChar(nextTilePosition - tilePosition);
+	}
+
+	const char nextTrackChar = m_Track.GetTrackChar(nextTilePosition);
+	if (m_Track.IsRoad(nextTrackChar) == false)
+		return (false);
+	// In an intersection the car keep going the way it came
+	if (nextTrackChar != INTERSECTION)
+		inOutTrackDirectionChar = nextTrackChar;
+	else if (trackChar != INTERSECTION)
+		inOutTrackDirectionChar = trackChar;
+	outNextCellIndex = GetCellIndex(nextTilePosition);
+	return (true);
+}
+
+void LodEngine::PushCar(uint32_t cellIndex, uint32_t carId, char trackDirectionChar)
+{
+	MesoCell& cell = m_Cells[cellIndex];
+	MesoCar& mesoCar = m_MesoCars[carId];
+	mesoCar.nextCarId = NoCarId;
+	mesoCar.trackDirectionChar = trackDirectionChar;
+
+	// Drive through the cell at max speed, in a whole amount of ticks
+	const IntVector2D directionVector = GetDirectionVector(trackDirectionChar);
+	const float cellLength = (directionVector.x != 0 && directionVector.y != 0 ? std::sqrt(2.0f) : 1.0f);
+	const float ticksAmount = std::max(1.0f, std::ceil(cellLength / m_Cars[carId]->GetMaxSpeed()));
+	mesoCar.readyTick = m_Tick + static_cast<uint64_t>(ticksAmount);
+	mesoCar.speed = cellLength / ticksAmount;
+
+	// The cells hold a few cars, no need to remember the last one
+	uint16_t indexInCell = 0;
+	if (cell.firstCarId == NoCarId)
+		cell.firstCarId = carId;
+	else
+	{
+		uint32_t lastCarId = cell.firstCarId;
+		for (indexInCell = 1; m_MesoCars[lastCarId].nextCarId != NoCarId; indexInCell++)
+			lastCarId = m_MesoCars[lastCarId].nextCarId;
+		m_MesoCars[lastCarId].nextCarId = carId;
+	}
+	cell.carsAmount++;
+	m_MesoCarsAmount++;
+	if (cell.isOccupied == false)
+	{
+		cell.isOccupied = true;
+		m_OccupiedCells.push_back(cellIndex);
+	}
+	PublishMesoCar(carId, cellIndex, indexInCell, mesoCar.speed, EMoveResult::Moving);
+}
+
+uint32_t LodEngine::PopFirstCar(uint32_t cellIndex)
+{
+	MesoCell& cell = m_Cells[cellIndex];
+	assert(cell.carsAmount > 0);
+	const uint32_t carId = cell.firstCarId;
+	cell.firstCarId = m_MesoCars[carId].nextCarId;
+	cell.carsAmount--;
+	m_MesoCarsAmount--;
+
+	// The next car move up to the front of the cell
+	if (cell.firstCarId != NoCarId)
+		PublishMesoCar(cell.firstCarId, cellIndex, 0, m_MesoCars[cell.firstCarId].speed, EMoveResult::Moving);
+	return (carId);
+}
+
+uint16_t LodEngine::GetCellCapacity(uint32_t cellIndex) const
+{
+	if (m_Track.GetTrackChar(GetCellPosition(cellIndex)) == INTERSECTION)
+		return (1);
+	return (static_cast<uint16_t>(std::max(1.0f, std::floor(1.0f / CarLength + 0.001f))));
+}
+
+Vector2D LodEngine::GetPlaceInCell(uint32_t cellIndex, char trackDirectionChar, uint16_t indexInCell) const
+{
+	const Vector2D center = Vector2D(GetCellPosition(cellIndex)) + Vector2D(0.5f, 0.5f);
+	const Vector2D laneDirection = Vector2D(GetDirectionVector(trackDirectionChar)).Normalize();
+	return (center + laneDirection * (indexInCell == 0 ? CarLength / 2.0f : -CarLength / 2.0f));
+}
+
+void LodEngine::PublishMesoCar(uint32_t carId, uint32_t cellIndex, uint16_t indexInCell, float speed, EMoveResult moveResult)
+{
+	Car* car = m_Cars[carId];
+	const char trackDirectionChar = m_MesoCars[carId].trackDirectionChar;
+	CarKinematicState state = car->GetState();
+	state.position = GetPlaceInCell(cellIndex, trackDirectionChar, indexInCell);
+	state.forwardVector = Vector2D(GetDirectionVector(trackDirectionChar)).Normalize();
+	state.speed = speed;
+	state.lastMoveResult = moveResult;
+	car->ApplyState(state, trackDirectionChar);
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+
+#include <vector>
+#include <cstdint>
+
+/**
+ * Level of detail engine, for the maps with far more cars than anybody can look at.
+ * Only the cars close to the focus cars (the one of the close up, see AsciiRenderer) run the full model (micro, Car::Move),
+ * everywhere else the road is a cell transmission model (meso): each road tile is a cell holding a queue of cars,
+ * a car leave its cell for the next one once it had the time to drive through it at its max speed,
+ * if the next cell has room left and if the light let it go (same rule as Car::Move, 2 tiles before the intersection).
+ * A cell send at most one car per tick and hold as many cars as fit in it bumper to bumper, so the queues and the jams still form.
+ * The cars go from a model to the other around the micro area (the tiles at most MicroRadius tiles from a focus car):
+ * - a micro car more than MicroRadius + 1 tiles away (it drove out, or the focus left it behind) join the queue of its tile,
+ * - a meso car about to enter the micro area, or caught inside it when the focus move, is put back on the road where it is,
+ *   once no micro car is in the way.
+ * The tiles at MicroRadius + 1 are a border where both kinds of cars drive, the micro cars see the meso cars of the border as obstacles.
+ * A car is always in one model and one only, the amount of cars never change.
+ * The meso cars are still published (Car::ApplyState) at their place in their cell when they move, so the renderer and the statistics see them.
+ * The cost of a tick depend on the amount of micro cars and on the amount of occupied cells, not on the size of the map.
+ * The meso model ignore the intersection reservations (see IntersectionManager), the cars only wait for room in the intersection.
+ * note: the car ids have to be their index in the cars vector.
+ */
+class LodEngine
+{
+
+public:
+	static constexpr uint32_t NoCarId = UINT32_MAX;
+
+public:
+	/**
+	 * \param focusCarIds The cars around which the full model run.
+	 * \param microRadius The half size of the square around each focus car where the full model run, in tiles.
+	 */
+	LodEngine(const ATrack& track, const std::vector<Car*>& cars, const std::vector<uint32_t>& focusCarIds, int microRadius);
+	LodEngine(const LodEngine& other) = delete;
+	LodEngine& operator=(const LodEngine& other) = delete;
+
+public:
+	/** Move all the cars 1 step forward (the track's lights time have to be set before) */
+	void Tick();
+
+	/** The cars moved by the full model */
+	const std::vector<uint32_t>& GetMicroCarIds() const { return (m_MicroCarIds); }
+	size_t GetMesoCarsAmount() const { return (m_MesoCarsAmount); }
+	/** Amount of cells holding at least a car */
+	size_t GetOccupiedCellsAmount() const { return (m_OccupiedCells.size()); }
+	bool IsMicroCar(uint32_t carId) const { return (m_IsMicroCar[carId]); }
+
+private:
+	/** A road tile in the meso model, its cars are linked from the first one (see MesoCar::nextCarId) */
+	struct MesoCell
+	{
+		uint32_t firstCarId = NoCarId;
+		uint16_t carsAmount = 0;
+		/** Whether the cell is in m_OccupiedCells */
+		bool isOccupied = false;
+	};
+	/** What the meso model know about a car */
+	struct MesoCar
+	{
+		/** The next car in the same cell */
+		uint32_t nextCarId = NoCarId;
+		/** The tick from which the car can leave its cell */
+		uint64_t readyTick = 0;
+		/** The speed it drive through its cell at */
+		float speed = 0.0f;
+		/** Where the car is going (the tile direction, or the direction it entered the intersection with) */
+		char trackDirectionChar = CENTER;
+	};
+
+	/** Distance (in tiles, diagonals count as 1) to the closest focus car */
+	int GetFocusDistance(const IntVector2D& tilePosition) const;
+	bool IsInMicroArea(const IntVector2D& tilePosition) const { return (GetFocusDistance(tilePosition) <= m_MicroRadius); }
+	/** The micro cars and the meso cars of the border, the only cars the micro cars can touch */
+	void GatherMicroView();
+	/** Turn the micro cars that left the border into meso cars */
+	void DemoteFarCars();
+	void MoveMesoCars();
+	/** Put back on the road the first cars of the cell, as long as there is room for them */
+	void PromoteCars(uint32_t cellIndex);
+	/** Move the first car of the cell to the next cell if it's ready and there is room for it */
+	void TryMoveFirstCar(uint32_t cellIndex);
+
+	/** Turn a micro car into a meso car of the cell of its tile, return false if the car is not on a road tile (it stay micro) */
+	bool MakeMeso(uint32_t carId);
+	/** Put the car back on the road in the full model, at its place in its cell */
+	void MakeMicro(uint32_t carId, const Vector2D& position);
+	/** Whether a micro car can be put at the position without touching another car of the micro view */
+	bool IsFreeForMicroCar(uint32_t carId, const Vector2D& position) const;
+
+	/**
+	 * Find the cell a car leaving the given cell go to, the direction is updated when it leave an intersection.
+	 * Return false if there is no road there.
+	 */
+	bool FindNextCell(uint32_t cellIndex, char& inOutTrackDirectionChar, uint32_t& outNextCellIndex) const;
+	/** Put the car at the end of the cell, ready to leave it once it drove through it */
+	void PushCar(uint32_t cellIndex, uint32_t carId, char trackDirectionChar);
+	uint32_t PopFirstCar(uint32_t cellIndex);
+	/** The amount of cars that fit bumper to bumper in the cell (one for the intersections, they're shared by two flows) */
+	uint16_t GetCellCapacity(uint32_t cellIndex) const;
+	/** Where the car at the given index of the cell is drawn, the first one near the exit and the others behind it */
+	Vector2D GetPlaceInCell(uint32_t cellIndex, char trackDirectionChar, uint16_t indexInCell) const;
+	void PublishMesoCar(uint32_t carId, uint32_t cellIndex, uint16_t indexInCell, float speed, EMoveResult moveResult);
+
+	IntVector2D GetCellPosition(uint32_t cellIndex) const { return (IntVector2D(cellIndex % m_Track.GetWidth(), cellIndex / m_Track.GetWidth())); }
+	uint32_t GetCellIndex(const IntVector2D& tilePosition) const { return (static_cast<uint32_t>(tilePosition.y * m_Track.GetWidth() + tilePosition.x)); }
+
+private:
+	const ATrack& m_Track;
+	const std::vector<Car*>& m_Cars;
+	const std::vector<uint32_t> m_FocusCarIds;
+	const int m_MicroRadius;
+	uint64_t m_Tick = 0;
+
+	/** The tiles of the focus cars, updated at the start of each tick */
+	std::vector<IntVector2D> m_FocusTiles;
+	std::vector<uint32_t> m_MicroCarIds;
+	/** The cars given to Car::Move, see GatherMicroView (rebuilt every tick) */
+	std::vector<const Car*> m_MicroView;
+	std::vector<bool> m_IsMicroCar;
+
+	/** One cell per tile of the map (width * height), only the road tiles are used */
+	std::vector<MesoCell> m_Cells;
+	std::vector<uint32_t> m_OccupiedCells;
+	std::vector<MesoCar> m_MesoCars;
+	size_t m_MesoCarsAmount = 0;
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Defines.h"
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <cassert>
+
+/**
+ * Streaming quantiles of values within a known range, in constant memory: the values are only counted in BinAmount equal bins.
+ * Two sketches of the same range merge exactly (the counts are added), so each thread can fill its own and merge them later.
+ * A quantile is interpolated inside its bin, so the error is less than the width of a bin.
+ * The values out of the range are counted in the first or last bin.
+ */
+class QuantileSketch
+{
+
+public:
+	static constexpr size_t BinAmount = 256;
+
+public:
+	QuantileSketch(float minValue, float maxValue)
+		: m_MinValue(minValue), m_MaxValue(maxValue)
+	{
+		assert(minValue < maxValue);
+	}
+
+public:
+	void Add(float value)
+	{
+		const float binPosition = (value - m_MinValue) / (m_MaxValue - m_MinValue) * BinAmount;
+		const size_t binIndex = static_cast<size_t>(CLAMP(0.0f, static_cast<float>(BinAmount - 1), binPosition));
+		m_Bins[binIndex]++;
+		m_Count++;
+	}
+	/** Add the values of another sketch (it must have the same range) */
+	void Merge(const QuantileSketch& other)
+	{
+		assert(m_MinValue == other.m_MinValue && m_MaxValue == other.m_MaxValue);
+		for (size_t i = 0; i < BinAmount; i++)
+			m_Bins[i] += other.m_Bins[i];
+		m_Count += other.m_Count;
+	}
+	void Reset()
+	{
+		m_Bins.fill(0);
+		m_Count = 0;
+	}
+
+	uint64_t GetCount() const { return (m_Count); }
+	/**
+	 * \param quantile Between 0 and 1 (0.5 for the median).
+	 * \return The value under which there is that part of the values (the minimum of the range if the sketch is empty).
+	 */
+	float GetQuantile(float quantile) const
+	{
+		if (m_Count == 0)
+			return (m_MinValue);
+
+		const double rank = CLAMP(0.0, 1.0, static_cast<double>(quantile)) * m_Count;
+		const float binWidth = (m_MaxValue - m_MinValue) / BinAmount;
+		uint64_t countBefore = 0;
+		for (size_t i = 0; i < BinAmount; i++)
+		{
+			if (m_Bins[i] > 0 && countBefore + m_Bins[i] >= rank)
+			{
+				// Assume the values are spread evenly inside the bin
+				const double partOfBin = (rank - countBefore) / m_Bins[i];
+				return (m_MinValue + binWidth * (static_cast<float>(i) + static_cast<float>(partOfBin)));
+			}
+			countBefore += m_Bins[i];
+		}
+		return (m_MaxValue);
+	}
+
+private:
+	float m_MinValue;
+	float m_MaxValue;
+	std::array<uint64_t, BinAmount> m_Bins = {};
+	uint64_t m_Count = 0;
+};
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <array>
+
+/**
+ * What a random stream is used for, each purpose get its own independent sequence.
+ */
+enum class ERandomPurpose : uint32_t
+{
+	CarParameters = 0,
+	SpawnPoints = 1,
+	Behaviour = 2,
+	/** The parameters of the batch scenarios (see BatchRunner) */
+	Scenarios = 3,
+	/** The inputs of the microbenchmarks (see Bench) */
+	Benchmarks = 4
+};
+
+/**
+ * Counter based random number generator (Philox4x32-10).
+ * A stream is keyed by (seed, id, purpose) and only hold a counter, there is no shared state at all:
+ * every car can draw its own numbers from any thread, and the same seed always give the same numbers
+ * whatever the amount of threads or the order in which the cars are updated.
+ */
+class RandomStream
+{
+
+public:
+	RandomStream(uint64_t seed, uint32_t id, ERandomPurpose purpose)
+		: m_Key({ static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) }),
+		m_Id(id),
+		m_Purpose(static_cast<uint32_t>(purpose))
+	{}
+
+public:
+	/** Next raw 32 bits random number */
+	uint32_t NextUInt()
+	{
+		if (m_BlockIndex >= 4)
+		{
+			m_Block = Philox({ static_cast<uint32_t>(m_Counter), static_cast<uint32_t>(m_Counter >> 32), m_Id, m_Purpose }, m_Key);
+			m_Counter++;
+			m_BlockIndex = 0;
+		}
+		return (m_Block[m_BlockIndex++]);
+	}
+	/** Uniform float in [0, 1) */
+	float NextFloat() { return (static_cast<float>(NextUInt() >> 8) * (1.0f / 16777216.0f)); }
+	/** Uniform float in [min, max) */
+	float Range(float min, float max) { return (min + NextFloat() * (max - min)); }
+	/**
+	 * Uniform integer in [0, max), without the modulo bias (Lemire's method).
+	 * max must be greater than 0.
+	 */
+	uint32_t Range(uint32_t max)
+	{
+		uint64_t product = static_cast<uint64_t>(NextUInt()) * max;
+		uint32_t low = static_cast<uint32_t>(product);
+		if (low < max)
+		{
+			uint32_t threshold = (0u - max) % max;
+			while (low < threshold)
+			{
+				product = static_cast<uint64_t>(NextUInt()) * max;
+				low = static_cast<uint32_t>(product);
+			}
+		}
+		return (static_cast<uint32_t>(product >> 32));
+	}
+
+private:
+	using Counter = std::array<uint32_t, 4>;
+	using Key = std::array<uint32_t, 2>;
+
+	static Counter Philox(Counter counter, Key key)
+	{
+		constexpr uint32_t Multiplier0 = 0xD2511F53;
+		constexpr uint32_t Multiplier1 = 0xCD9E8D57;
+		constexpr uint32_t Weyl0 = 0x9E3779B9;
+		constexpr uint32_t Weyl1 = 0xBB67AE85;
+
+		for (int round = 0; round < 10; round++)
+		{
+			uint64_t product0 = static_cast<uint64_t>(Multiplier0) * counter[0];
+			uint64_t product1 = static_cast<uint64_t>(Multiplier1) * counter[2];
+			counter = {
+				static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+				static_cast<uint32_t>(product1),
+				static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+				static_cast<uint32_t>(product0)
+			};
+			key[0] += Weyl0;
+			key[1] += Weyl1;
+		}
+		return (counter);
+	}
+
+private:
+	const Key m_Key;
+	const uint32_t m_Id;
+	const uint32_t m_Purpose;
+
+	/** Index of the next block of 4 numbers */
+	uint64_t m_Counter = 0;
+	/** The last generated block and the index of the next number to take from it */
+	Counter m_Block = {};
+	int m_BlockIndex = 4;
+};
@@ -0,0 +1,215 @@
+#include "RegionEngine.h"
+#include "TrafficStatistics.h"
+#include "TileHeatmap.h"
+
+#include <algorithm>
+
+RegionEngine::RegionEngine(const ATrack& track, const std::vector<Car*>& cars, unsigned int threadsAmount)
+	: m_Track(track),
+	m_Regions(FindRegionsAmount(track, threadsAmount), Region(track)),
+	m_RegionsEnd(CutInStrips(track, m_Regions.size())),
+	m_Barrier(GetThreadsAmount())
+{
+	// A car can't cross a whole strip in 1 step, so it's always handed over to a direct neighbour
+	static_assert(CAR_MAX_MAXSPEED < GhostBandWidth, "The cars are too fast for the ghost band");
+	static_assert(CAR_MAX_MAXSPEED <= 1.0f, "The cars sorted before moving are looked for 1 tile further, see NearbyTilesRadius");
+
+	for (size_t i = 0; i < m_Regions.size(); i++)
+	{
+		m_Regions[i].MinX = (i == 0 ? 0 : m_RegionsEnd[i - 1]);
+		m_Regions[i].MaxX = m_RegionsEnd[i];
+	}
+	for (const auto& car : cars)
+		m_Regions[FindRegionIndex(car->GetPosition().x)].Cars.push_back(car);
+
+	// The thread calling Tick step the first two regions
+	m_Workers.reserve(GetThreadsAmount() - 1);
+	for (size_t i = 1; i < GetThreadsAmount(); i++)
+		m_Workers.emplace_back(&RegionEngine::WorkerLoop, this, i);
+}
+
+RegionEngine::~RegionEngine()
+{
+	m_IsStopping = true;
+	m_Barrier.Wait();
+	for (std::thread& worker : m_Workers)
+		worker.join();
+}
+
+void RegionEngine::Tick()
+{
+	m_Barrier.Wait();
+	StepRegions(0);
+}
+
+size_t RegionEngine::GetHandoversAmount() const
+{
+	size_t handoversAmount = 0;
+	for (const Region& region : m_Regions)
+		handoversAmount += region.HandoversAmount;
+	return (handoversAmount);
+}
+
+size_t RegionEngine::FindRegionsAmount(const ATrack& track, unsigned int threadsAmount)
+{
+	size_t maxRegionsAmount = std::max<size_t>(1, track.GetWidth() / GhostBandWidth);
+	return (CLAMP(static_cast<size_t>(1), maxRegionsAmount, static_cast<size_t>(threadsAmount) * 2));
+}
+
+std::vector<int> RegionEngine::CutInStrips(const ATrack& track, size_t stripsAmount)
+{
+	const int width = track.GetWidth();
+	const int amount = static_cast<int>(stripsAmount);
+
+	// Amount of road tiles on the left of each column
+	std::vector<int64_t> roadTilesBefore(width + 1, 0);
+	for (int x = 0; x < width; x++)
+	{
+		int64_t columnRoadTiles = 0;
+		for (int y = 0; y < track.GetHeight(); y++)
+		{
+			if (track.IsHereARoad(IntVector2D(x, y)))
+				columnRoadTiles++;
+		}
+		roadTilesBefore[x + 1] = roadTilesBefore[x] + columnRoadTiles;
+	}
+
+	std::vector<int> stripsEnd(stripsAmount, width);
+	int stripStart = 0;
+	for (int i = 0; i < amount - 1; i++)
+	{
+		// Grow the strip until it hold its share of the road, keeping enough columns for the next strips
+		const int64_t targetRoadTiles = roadTilesBefore[width] * (i + 1) / amount;
+		const int lastStripEnd = width - (amount - i - 1) * GhostBandWidth;
+		int stripEnd = stripStart + GhostBandWidth;
+		while (stripEnd < lastStripEnd && roadTilesBefore[stripEnd] < targetRoadTiles)
+			stripEnd++;
+		stripsEnd[i] = stripEnd;
+		stripStart = stripEnd;
+	}
+	return (stripsEnd);
+}
+
+size_t RegionEngine::FindStripIndex(const std::vector<int>& stripsEnd, float x)
+{
+	auto stripEnd = std::upper_bound(stripsEnd.begin(), stripsEnd.end() - 1, x,
+		[](float value, int end) { return (value < static_cast<float>(end)); });
+	return (static_cast<size_t>(stripEnd - stripsEnd.begin()));
+}
+
+void RegionEngine::WorkerLoop(size_t threadIndex)
+{
+	while (true)
+	{
+		// Wait for the next tick
+		m_Barrier.Wait();
+		if (m_IsStopping)
+			return;
+		StepRegions(threadIndex);
+	}
+}
+
+void RegionEngine::StepRegions(size_t threadIndex)
+{
+	const size_t firstRegionIndex = threadIndex * 2;
+	const size_t lastRegionIndex = std::min(firstRegionIndex + 2, m_Regions.size());
+
+	for (size_t i = firstRegionIndex; i < lastRegionIndex; i++)
+		GatherNearbyCars(m_Regions[i], i);
+	m_Barrier.Wait();
+	// Even regions then odd regions
+	for (size_t i = firstRegionIndex; i < firstRegionIndex + 2; i++)
+	{
+		if (i < lastRegionIndex)
+			MoveCars(m_Regions[i], i);
+		m_Barrier.Wait();
+	}
+	for (size_t i = firstRegionIndex; i < lastRegionIndex; i++)
+	{
+		AdoptCars(m_Regions[i], i);
+		if (m_Statistics)
+		{
+			for (const Car* car : m_Regions[i].Cars)
+				m_Statistics->RecordCar(*car, threadIndex);
+		}
+		if (m_Heatmap)
+		{
+			for (const Car* car : m_Regions[i].Cars)
+				m_Heatmap->RecordCar(*car, threadIndex);
+		}
+	}
+	m_Barrier.Wait();
+}
+
+void RegionEngine::GatherNearbyCars(Region& region, size_t regionIndex)
+{
+	region.NearbyCars.assign(region.Cars.begin(), region.Cars.end());
+
+	// Ghost cars, the neighbours' cars along our borders (the strips are at least as wide as the band)
+	if (regionIndex > 0)
+	{
+		const float ghostBandStart = static_cast<float>(region.MinX - GhostBandWidth);
+		for (const Car* car : m_Regions[regionIndex - 1].Cars)
+		{
+			if (car->GetPosition().x >= ghostBandStart)
+				region.NearbyCars.push_back(car);
+		}
+	}
+	if (regionIndex < m_Regions.size() - 1)
+	{
+		const float ghostBandEnd = static_cast<float>(region.MaxX + GhostBandWidth);
+		for (const Car* car : m_Regions[regionIndex + 1].Cars)
+		{
+			if (car->GetPosition().x < ghostBandEnd)
+				region.NearbyCars.push_back(car);
+		}
+	}
+
+	region.SortedNearbyCars.Clear();
+	for (size_t i = 0; i < region.NearbyCars.size(); i++)
+		region.SortedNearbyCars.Add(region.NearbyCars[i]->GetPosition(), static_cast<uint32_t>(i));
+	region.SortedNearbyCars.Sort();
+}
+
+void RegionEngine::MoveCars(Region& region, size_t regionIndex)
+{
+	region.LeavingToPrevious.clear();
+	region.LeavingToNext.clear();
+
+	size_t i = 0;
+	while (i < region.Cars.size())
+	{
+		Car* car = region.Cars[i];
+		const IntVector2D carTile = region.SortedNearbyCars.GetClampedTile(car->GetPosition());
+		region.CarsAround.clear();
+		region.SortedNearbyCars.GatherCars(carTile - NearbyTilesRadius, carTile + NearbyTilesRadius, region.NearbyCars, region.CarsAround);
+		car->Move(region.CarsAround);
+
+		size_t newRegionIndex = FindRegionIndex(car->GetPosition().x);
+		if (newRegionIndex == regionIndex)
+		{
+			i++;
+			continue;
+		}
+		assert(newRegionIndex + 1 == regionIndex || newRegionIndex == regionIndex + 1);
+		(newRegionIndex < regionIndex ? region.LeavingToPrevious : region.LeavingToNext).push_back(car);
+		// The order of the cars does not matter, swap with the last one instead of shifting everything
+		region.Cars[i] = region.Cars.back();
+		region.Cars.pop_back();
+		region.HandoversAmount++;
+	}
+}
+
+void RegionEngine::AdoptCars(Region& region, size_t regionIndex)
+{
+	if (regionIndex > 0)
+	{
+		const std::vector<Car*>& arrivingCars = m_Regions[regionIndex - 1].LeavingToNext;
+		region.Cars.insert(region.Cars.end(), arrivingCars.begin(), arrivingCars.end());
+	}
+	if (regionIndex < m_Regions.size() - 1)
+	{
+		const std::vector<Car*>& arrivingCars = m_Regions[regionIndex + 1].LeavingToPrevious;
+		region.Cars.insert(region.Cars.end(), arrivingCars.begin(), arrivingCars.end());
+	}
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+#include "Barrier.h"
+#include "TileSortedCars.h"
+
+#include <vector>
+#include <memory>
+#include <thread>
+
+class TrafficStatistics;
+class TileHeatmap;
+
+/**
+ * Step every car 1 tick at the time, in parallel, with the map split in vertical strips (regions).
+ * Each region own the cars that are inside it:
+ * - the collisions are only checked against the region's cars plus a thin ghost band of the neighbour regions' cars along the borders,
+ *   sorted by tile once per tick so each car only look at the cars of the tiles around it (NearbyTilesRadius),
+ * - a car crossing a border is handed over to the neighbour region at the end of the tick.
+ * Each thread own two regions and only touch their cars and the few cars around their borders, instead of the whole fleet.
+ * The even regions move first then the odd ones, so two neighbour regions never move at the same time:
+ * a car always see the ghost cars before or after their whole move, and the result does not depend on the threads timing.
+ * The strips are cut to hold about the same amount of road, the thread calling Tick step the first two regions.
+ */
+class RegionEngine
+{
+
+public:
+	/**
+	 * \param threadsAmount The amount of threads (two regions each), less are made if the map is too narrow.
+	 */
+	RegionEngine(const ATrack& track, const std::vector<Car*>& cars, unsigned int threadsAmount = std::thread::hardware_concurrency());
+	~RegionEngine();
+	RegionEngine(const RegionEngine& other) = delete;
+	RegionEngine& operator=(const RegionEngine& other) = delete;
+
+public:
+	/** Move all the cars 1 step forward, return once every region is done (the track's lights time have to be set before) */
+	void Tick();
+
+	size_t GetRegionsAmount() const { return (m_Regions.size()); }
+	size_t GetThreadsAmount() const { return ((m_Regions.size() + 1) / 2); }
+	/** Amount of times a car went from a region to another since the start */
+	size_t GetHandoversAmount() const;
+	/**
+	 * Record every car in the statistics at the end of each tick, each thread record the cars of its regions (the statistics need GetThreadsAmount threads).
+	 * TrafficStatistics::EndTick is left to the caller, after Tick.
+	 */
+	void SetStatistics(TrafficStatistics* statistics) { m_Statistics = statistics; }
+	/** Same as SetStatistics, for the heatmap (TileHeatmap::EndTick is left to the caller) */
+	void SetHeatmap(TileHeatmap* heatmap) { m_Heatmap = heatmap; }
+
+	/**
+	 * Width (in tiles) of the ghost band, a car only look at the cars closer than that.
+	 * It have to be greater than the distance at which two cars can interact plus what they can move in one step.
+	 */
+	static constexpr int GhostBandWidth = 2;
+	/**
+	 * Radius (in tiles) of the block of tiles around a car given to Car::Move, when the cars are sorted by tile once per tick:
+	 * the ghost band, and a tile for the cars that moved since the sort.
+	 */
+	static constexpr int NearbyTilesRadius = GhostBandWidth + 1;
+
+	/** Amount of regions to create for the given amount of threads, each strip have to be at least as wide as the ghost band */
+	static size_t FindRegionsAmount(const ATrack& track, unsigned int threadsAmount);
+	/**
+	 * Cut the map in vertical strips holding about the same amount of road tiles.
+	 *
+	 * \return The column right after each strip (the last one is the map width).
+	 */
+	static std::vector<int> CutInStrips(const ATrack& track, size_t stripsAmount);
+	/** Index of the strip containing x, the positions out of the map belong to the first or last strip */
+	static size_t FindStripIndex(const std::vector<int>& stripsEnd, float x);
+
+private:
+	/** One strip of the map, aligned so two threads never write on the same cache line */
+	struct alignas(CACHE_LINE_SIZE) Region
+	{
+		explicit Region(const ATrack& track) : SortedNearbyCars(track) {}
+
+		/** The columns of the strip: [MinX, MaxX) */
+		int MinX = 0;
+		int MaxX = 0;
+		/** The cars owned by this region, only its thread modify them (region i belong to the thread i / 2) */
+		std::vector<Car*> Cars;
+		/** The region's cars plus the ghost cars of the neighbours, rebuilt every tick */
+		std::vector<const Car*> NearbyCars;
+		/** NearbyCars by index, sorted by tile when they're gathered */
+		TileSortedCars SortedNearbyCars;
+		/** The cars given to Car::Move, the nearby cars of the tiles around the moving car */
+		std::vector<const Car*> CarsAround;
+		/** The cars leaving for the previous and next region during this tick */
+		std::vector<Car*> LeavingToPrevious;
+		std::vector<Car*> LeavingToNext;
+		size_t HandoversAmount = 0;
+	};
+
+	size_t FindRegionIndex(float x) const { return (FindStripIndex(m_RegionsEnd, x)); }
+
+	void WorkerLoop(size_t threadIndex);
+	/** The whole tick of the two regions of a thread, the phases are separated by barriers so the neighbours are never read while they're modified */
+	void StepRegions(size_t threadIndex);
+	void GatherNearbyCars(Region& region, size_t regionIndex);
+	void MoveCars(Region& region, size_t regionIndex);
+	void AdoptCars(Region& region, size_t regionIndex);
+
+private:
+	const ATrack& m_Track;
+
+	std::vector<Region> m_Regions;
+	/** The column right after each region, see CutInStrips */
+	const std::vector<int> m_RegionsEnd;
+	std::vector<std::thread> m_Workers;
+	Barrier m_Barrier;
+	/** Only written before a barrier, the barrier make it visible to the workers */
+	bool m_IsStopping = false;
+	TrafficStatistics* m_Statistics = nullptr;
+	TileHeatmap* m_Heatmap = nullptr;
+};
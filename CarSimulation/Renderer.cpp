@@ -1,14 +1,11 @@
 #include "Renderer.h"
 
+#include <algorithm>
+
 #define RENDER_FULL_MAP_CLOSE_UP 0
 
-void AsciiRenderer::Render(const ATrack& track, const std::array<std::shared_ptr<Car>, CARS_AMOUNT>& cars)
+void AsciiRenderer::Render(const ATrack& track, const std::vector<Car*>& cars)
 {
-	for (auto& line : m_Buffer)
-	{
-		line.clear();
-		line.resize(track.GetWidth(), ' ');
-	}
 	// Clear the screen
 	std::system("cls");
 
@@ -26,13 +23,18 @@ void AsciiRenderer::Render(const ATrack& track, const std::array<std::shared_ptr
 #endif
 
 	// calculate the alocation for the buffer
-	int bufferWidth = track.GetWidth() + std::ceil(zoomWidth / zoomSteps) + 1;
-	int bufferHeight = track.GetHeight() + std::ceil(zoomHeight / zoomSteps) + 1;
-
-	// resize the buffer
-	m_Buffer.resize(bufferHeight);
-	for (auto& line : m_Buffer)
-		line.resize(bufferWidth, ' ');
+	m_BufferWidth = track.GetWidth() + std::ceil(zoomWidth / zoomSteps) + 1;
+	m_BufferHeight = track.GetHeight() + std::ceil(zoomHeight / zoomSteps) + 1;
+
+	// the previous frame is not needed anymore, take the new one from the same memory
+	m_FrameArena.Reset();
+	const int lineSize = m_BufferWidth + 1;
+	m_Buffer = m_FrameArena.Allocate<char>(static_cast<size_t>(lineSize) * m_BufferHeight);
+	for (int y = 0; y < m_BufferHeight; y++)
+	{
+		std::fill_n(m_Buffer + y * lineSize, m_BufferWidth, ' ');
+		m_Buffer[y * lineSize + m_BufferWidth] = '\n';
+	}
 
 	DrawMapOnBuffer(track);
 	DrawCarsOnBuffer(cars);
@@ -42,47 +44,39 @@ void AsciiRenderer::Render(const ATrack& track, const std::array<std::shared_ptr
 
 void AsciiRenderer::DrawMapOnBuffer(const ATrack& track)
 {
-	// duplicate the track on the map buffer
-	m_MapBuffer.resize(track.GetHeight());
-	for (auto& line : m_MapBuffer)
-	{
-		line.clear();
-		line.resize(track.GetWidth(), ' ');
-	}
-	track.CopyTrack(m_MapBuffer);
-
 	// Draw the track
-	for (uint8_t y = 0; y < track.GetHeight(); y++)
-		for (uint8_t x = 0; x < track.GetWidth(); x++)
-			m_Buffer[y][x] = convertDirectionToDisplayChar(m_MapBuffer[y][x]);
+	for (int y = 0; y < track.GetHeight(); y++)
+		for (int x = 0; x < track.GetWidth(); x++)
+			m_Buffer[y * (m_BufferWidth + 1) + x] = convertDirectionToDisplayChar(track.GetTrackChar(IntVector2D(x, y)));
 }
 
-void AsciiRenderer::DrawCarsOnBuffer(const std::array<std::shared_ptr<Car>, CARS_AMOUNT>& cars)
+void AsciiRenderer::DrawCarsOnBuffer(const std::vector<Car*>& cars)
 {
 	// Draw the cars
 	for (auto car : cars)
 	{
 		IntVector2D carPosition = car->GetPosition().Round(0.1f);
 		char carNumber = car->GetDisplayChar();
-		if (carPosition.y >= 0 && carPosition.y < m_Buffer.size()
-			&& carPosition.x >= 0 && carPosition.x < m_Buffer[0].size())
-			m_Buffer[carPosition.y][carPosition.x] = carNumber;
+		if (carPosition.y >= 0 && carPosition.y < m_BufferHeight
+			&& carPosition.x >= 0 && carPosition.x < m_BufferWidth)
+			m_Buffer[carPosition.y * (m_BufferWidth + 1) + carPosition.x] = carNumber;
 		else
 			std::cout << "Unable to draw: " << car->GetId() << std::endl;
 	}
 }
 
-void AsciiRenderer::DrawCloseUp(const ATrack& track, const std::array<std::shared_ptr<Car>, CARS_AMOUNT>& cars, const Vector2D& center, float width, float height, float stepping)
+void AsciiRenderer::DrawCloseUp(const ATrack& track, const std::vector<Car*>& cars, const Vector2D& center, float width, float height, float stepping)
 {
 	// print zoom level (0.1 per char)
 	float halfWidth = width / 2.0f;
 	float halfHeight = height / 2.0f;
 
 	int bufferYLineIndex = 0;
-	for (float y = center.y - halfHeight; y < center.y + halfHeight; y += stepping)
+	// the float steps can give 1 more line or column than planned, the buffer is not resized during the frame so we stop at its border
+	for (float y = center.y - halfHeight; y < center.y + halfHeight && bufferYLineIndex < m_BufferHeight; y += stepping)
 	{
 		int bufferXColumnIndex = track.GetWidth();
-		for (float x = center.x - halfWidth; x < center.x + halfWidth; x += stepping)
+		for (float x = center.x - halfWidth; x < center.x + halfWidth && bufferXColumnIndex < m_BufferWidth; x += stepping)
 		{
 			char toDisplay;
 			Vector2D pos = { x, y };
@@ -108,33 +102,17 @@ void AsciiRenderer::DrawCloseUp(const ATrack& track, const std::array<std::share
 				toDisplay = convertDirectionToDisplayChar(dir);
 			}
 
-			m_Buffer[bufferYLineIndex][bufferXColumnIndex] = toDisplay;
+			m_Buffer[bufferYLineIndex * (m_BufferWidth + 1) + bufferXColumnIndex] = toDisplay;
 			bufferXColumnIndex++;
 		}
 		bufferYLineIndex++;
-		if (bufferYLineIndex >= m_Buffer.size())
-		{
-			m_Buffer.resize(m_Buffer.size() + 1);
-			// fill with empty spaces
-			m_Buffer.back().resize(track.GetWidth(), ' ');
-		}
 	}
 }
 
 void AsciiRenderer::DrawBufferOnScreen()
 {
-	// print the all buffer in one shot to avoid flickering (add \n at the end of each line)
-	size_t allocationSize = 0;
-	for (auto& line : m_Buffer)
-		allocationSize += line.size() + 1;
-	std::string buffer;
-	buffer.reserve(allocationSize);
-	for (auto& line : m_Buffer)
-	{
-		buffer.append(line.begin(), line.end());
-		buffer.push_back('\n');
-	}
-	std::cout << buffer;
+	// print the all buffer in one shot to avoid flickering (the \n are already at the end of each line)
+	std::cout.write(m_Buffer, static_cast<std::streamsize>(m_BufferWidth + 1) * m_BufferHeight);
 }
 
 char AsciiRenderer::convertDirectionToDisplayChar(char dir)
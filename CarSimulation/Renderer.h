@@ -5,6 +5,7 @@
 #include "IntVector2D.h"
 #include "Car.h"
 #include "Track.h"
+#include "TickArena.h"
 
 #include <iostream>
 #include <vector>
@@ -17,16 +18,20 @@
 class AsciiRenderer
 {
 public:
-	void Render(const ATrack& track, const std::array<std::shared_ptr<Car>, CARS_AMOUNT>& cars);
+	void Render(const ATrack& track, const std::vector<Car*>& cars);
 
 private:
 	void DrawMapOnBuffer(const ATrack& track);
-	void DrawCarsOnBuffer(const std::array<std::shared_ptr<Car>, CARS_AMOUNT>& cars);
-	void DrawCloseUp(const ATrack& track, const std::array<std::shared_ptr<Car>, CARS_AMOUNT>& cars, const Vector2D& center, float width, float height, float stepping);
+	void DrawCarsOnBuffer(const std::vector<Car*>& cars);
+	void DrawCloseUp(const ATrack& track, const std::vector<Car*>& cars, const Vector2D& center, float width, float height, float stepping);
 	void DrawBufferOnScreen();
 	char convertDirectionToDisplayChar(char dir);
 
 private:
-	std::vector<std::vector<char>> m_MapBuffer;
-	std::vector<std::vector<char>> m_Buffer;
+	/** The frame is rebuilt from scratch every time, in memory reused from one frame to the next */
+	TickArena m_FrameArena;
+	/** The text of the frame, m_BufferHeight lines of m_BufferWidth chars, each followed by a '\n' */
+	char* m_Buffer = nullptr;
+	int m_BufferWidth = 0;
+	int m_BufferHeight = 0;
 };
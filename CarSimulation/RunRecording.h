@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Car.h"
+
+#include <vector>
+#include <cassert>
+
+/**
+ * The published state of every car at every recorded tick, to look at the run afterward (see FrameRenderer).
+ * The states of a tick are stored contiguously, indexed by car id.
+ */
+class RunRecording
+{
+
+public:
+	/** \param carsAmount The cars ids have to be lower than it */
+	explicit RunRecording(size_t carsAmount) : m_CarsAmount(carsAmount) {}
+
+public:
+	/** Make room for that many ticks, so recording does not allocate */
+	void Reserve(size_t ticksAmount) { m_States.reserve(ticksAmount * m_CarsAmount); }
+	/** Record the current state of the cars as a new tick */
+	void Record(const std::vector<Car*>& cars)
+	{
+		const size_t firstStateIndex = m_States.size();
+		m_States.resize(firstStateIndex + m_CarsAmount);
+		for (const Car* car : cars)
+		{
+			assert(car->GetId() < m_CarsAmount);
+			m_States[firstStateIndex + car->GetId()] = car->GetState();
+		}
+	}
+
+	size_t GetCarsAmount() const { return (m_CarsAmount); }
+	size_t GetTicksAmount() const { return (m_CarsAmount == 0 ? 0 : m_States.size() / m_CarsAmount); }
+	/** The states of the cars at the given tick, GetCarsAmount of them */
+	const CarKinematicState* GetTickStates(size_t tick) const { return (m_States.data() + tick * m_CarsAmount); }
+
+private:
+	const size_t m_CarsAmount;
+	std::vector<CarKinematicState> m_States;
+};
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * Sequence lock: a value written by one thread and read by any amount of threads without locking.
+ * The writer bump the sequence before and after writing, a reader retry if the sequence was odd (write in progress)
+ * or changed while it was reading, so it never see half of a write.
+ * The readers never block the writer, and they only retry when they read at the exact same time as a write.
+ * The value is stored in atomic words so the concurrent accesses are well defined.
+ */
+template<typename T>
+class SeqLock
+{
+	static_assert(std::is_trivially_copyable<T>::value, "SeqLock can only store trivially copyable types");
+
+public:
+	SeqLock() { Store(T()); }
+	SeqLock(const T& value) { Store(value); }
+	SeqLock(const SeqLock& other) = delete;
+	SeqLock& operator=(const SeqLock& other) = delete;
+
+public:
+	/** Publish a new value (only one thread is allowed to write) */
+	void Store(const T& value)
+	{
+		Words words = {};
+		std::memcpy(words.data(), static_cast<const void*>(&value), sizeof(T));
+
+		uint32_t sequence = m_Sequence.load(std::memory_order_relaxed);
+		m_Sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (size_t i = 0; i < WordAmount; i++)
+			m_Words[i].store(words[i], std::memory_order_relaxed);
+		m_Sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	/** Read the last published value (from any thread) */
+	T Load() const
+	{
+		Words words;
+		uint32_t sequenceBefore;
+		uint32_t sequenceAfter;
+		do
+		{
+			sequenceBefore = m_Sequence.load(std::memory_order_acquire);
+			for (size_t i = 0; i < WordAmount; i++)
+				words[i] = m_Words[i].load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+			sequenceAfter = m_Sequence.load(std::memory_order_relaxed);
+		} while ((sequenceBefore & 1) != 0 || sequenceBefore != sequenceAfter);
+
+		// Through void*, the payloads have default member initializers (not trivially constructible) but they're trivially copyable
+		T value;
+		std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+		return (value);
+	}
+
+private:
+	static constexpr size_t WordAmount = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+	using Words = std::array<uint32_t, WordAmount>;
+
+	std::atomic<uint32_t> m_Sequence = { 0 };
+	std::array<std::atomic<uint32_t>, WordAmount> m_Words;
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+/*
+ * Everything the shards (see ShardEngine) share, made to live in a shared memory block mapped by several processes:
+ * only trivially copyable data and lock free atomics, no pointer.
+ */
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+	"The atomics shared between processes have to be lock free");
+
+/** The state of 1 car sent to another shard */
+struct ShardCarRecord
+{
+	uint32_t id;
+	char lastTrackDirection;
+	CarKinematicState state;
+
+	/** Id of the record closing a batch */
+	static constexpr uint32_t EndOfBatchId = UINT32_MAX;
+};
+
+static_assert(std::is_trivially_copyable<ShardCarRecord>::value, "ShardCarRecord is copied through the shared memory");
+
+/**
+ * Single producer single consumer ring of car records, from 1 shard to its neighbour.
+ * The records are sent by batches closed by an end of batch record, so the producer can start the next batch
+ * while the consumer is still reading the previous one.
+ * The records are stored right after the ring, use GetSizeInBytes to allocate it.
+ */
+class ShardRing
+{
+
+public:
+	explicit ShardRing(uint64_t capacity) : m_Capacity(capacity) {}
+	ShardRing(const ShardRing& other) = delete;
+	ShardRing& operator=(const ShardRing& other) = delete;
+
+	static size_t GetSizeInBytes(uint64_t capacity) { return (sizeof(ShardRing) + static_cast<size_t>(capacity) * sizeof(ShardCarRecord)); }
+
+public:
+	/**
+	 * Add a record, without waiting.
+	 * A ring big enough for 2 batches is never full (the consumer never lag more than 1 batch behind).
+	 *
+	 * \return false if the ring is full, the consumer has to read some records first.
+	 */
+	bool Push(const ShardCarRecord& record)
+	{
+		uint64_t head = m_Head.load(std::memory_order_relaxed);
+		if (head - m_Tail.load(std::memory_order_acquire) >= m_Capacity)
+			return (false);
+		GetRecords()[head % m_Capacity] = record;
+		m_Head.store(head + 1, std::memory_order_release);
+		return (true);
+	}
+	/**
+	 * Add a record, wait for some room if the ring is full.
+	 *
+	 * \param isAborted Stop waiting when it become true (the consumer may be dead).
+	 * \return false if aborted.
+	 */
+	bool Push(const std::atomic<uint32_t>& isAborted, const ShardCarRecord& record)
+	{
+		while (Push(record) == false)
+		{
+			if (isAborted.load(std::memory_order_relaxed))
+				return (false);
+			std::this_thread::yield();
+		}
+		return (true);
+	}
+	bool PushEndOfBatch(const std::atomic<uint32_t>& isAborted) { return (Push(isAborted, { ShardCarRecord::EndOfBatchId, CENTER, {} })); }
+
+	/**
+	 * Wait for the next record.
+	 *
+	 * \param isAborted Stop waiting when it become true (the producer may be dead).
+	 * \param outRecord The record.
+	 * \return false if aborted.
+	 */
+	bool Pop(const std::atomic<uint32_t>& isAborted, ShardCarRecord& outRecord)
+	{
+		uint64_t tail = m_Tail.load(std::memory_order_relaxed);
+		while (m_Head.load(std::memory_order_acquire) == tail)
+		{
+			if (isAborted.load(std::memory_order_relaxed))
+				return (false);
+			std::this_thread::yield();
+		}
+		outRecord = GetRecords()[tail % m_Capacity];
+		m_Tail.store(tail + 1, std::memory_order_release);
+		return (true);
+	}
+
+private:
+	ShardCarRecord* GetRecords() { return (reinterpret_cast<ShardCarRecord*>(this + 1)); }
+
+private:
+	/** Written by the producer and the consumer, on their own cache line */
+	alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_Head = { 0 };
+	alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_Tail = { 0 };
+	alignas(CACHE_LINE_SIZE) const uint64_t m_Capacity;
+};
+
+/** Spinning barrier between processes (see Barrier for the threads), can be left when the run is aborted */
+class ProcessBarrier
+{
+
+public:
+	explicit ProcessBarrier(uint32_t participantsAmount) : m_ParticipantsAmount(participantsAmount) {}
+	ProcessBarrier(const ProcessBarrier& other) = delete;
+	ProcessBarrier& operator=(const ProcessBarrier& other) = delete;
+
+public:
+	/** \return false if aborted */
+	bool Wait(const std::atomic<uint32_t>& isAborted)
+	{
+		uint32_t generation = m_Generation.load(std::memory_order_acquire);
+		if (m_ArrivedAmount.fetch_add(1, std::memory_order_acq_rel) + 1 == m_ParticipantsAmount)
+		{
+			// Last one in, release everyone and get ready for the next use
+			m_ArrivedAmount.store(0, std::memory_order_relaxed);
+			m_Generation.store(generation + 1, std::memory_order_release);
+			return (true);
+		}
+		while (m_Generation.load(std::memory_order_acquire) == generation)
+		{
+			if (isAborted.load(std::memory_order_relaxed))
+				return (false);
+			std::this_thread::yield();
+		}
+		return (true);
+	}
+
+private:
+	const uint32_t m_ParticipantsAmount;
+	std::atomic<uint32_t> m_ArrivedAmount = { 0 };
+	std::atomic<uint32_t> m_Generation = { 0 };
+};
@@ -0,0 +1,218 @@
+#include "ShardEngine.h"
+
+#include <algorithm>
+
+ShardEngine::ShardEngine(const ATrack& track, const std::vector<Car*>& cars, size_t shardIndex, size_t shardsAmount, const Links& links)
+	: m_Cars(cars),
+	m_Links(links),
+	m_RegionsEnd(RegionEngine::CutInStrips(track, RegionEngine::FindRegionsAmount(track, static_cast<unsigned int>(shardsAmount)))),
+	m_FirstRegionIndex(shardIndex * 2)
+{
+	assert(shardsAmount == (m_RegionsEnd.size() + 1) / 2 && shardIndex < shardsAmount);
+	assert((m_Links.ToPrevious != nullptr) == (shardIndex > 0) && (m_Links.ToNext != nullptr) == (shardIndex < shardsAmount - 1));
+
+	const size_t regionsAmount = std::min<size_t>(2, m_RegionsEnd.size() - m_FirstRegionIndex);
+	m_Regions.reserve(regionsAmount);
+	for (size_t i = 0; i < regionsAmount; i++)
+		m_Regions.emplace_back(track);
+	for (size_t i = m_FirstRegionIndex; i < m_FirstRegionIndex + m_Regions.size(); i++)
+	{
+		GetRegion(i).MinX = (i == 0 ? 0 : m_RegionsEnd[i - 1]);
+		GetRegion(i).MaxX = m_RegionsEnd[i];
+	}
+	for (const auto& car : cars)
+	{
+		assert(car->GetId() < cars.size());
+		size_t regionIndex = RegionEngine::FindStripIndex(m_RegionsEnd, car->GetPosition().x);
+		if (IsRegionOwned(regionIndex))
+			GetRegion(regionIndex).Cars.push_back(car);
+	}
+}
+
+bool ShardEngine::Tick()
+{
+	const std::atomic<uint32_t>& isAborted = *m_Links.IsAborted;
+	if (m_Links.TickBarrier->Wait(isAborted) == false)
+		return (false);
+
+	const size_t firstRegionIndex = m_FirstRegionIndex;
+	const size_t lastRegionIndex = m_FirstRegionIndex + m_Regions.size() - 1;
+
+	// Send our cars along the borders, with the same filter as the neighbour region would use in RegionEngine::GatherNearbyCars
+	m_GhostsToPrevious.clear();
+	m_GhostsToNext.clear();
+	if (m_Links.ToPrevious)
+	{
+		const Region& region = GetRegion(firstRegionIndex);
+		const float ghostBandEnd = static_cast<float>(region.MinX + RegionEngine::GhostBandWidth);
+		for (Car* car : region.Cars)
+		{
+			if (car->GetPosition().x < ghostBandEnd)
+				m_GhostsToPrevious.push_back(car);
+		}
+		if (Send(m_Links.ToPrevious, m_GhostsToPrevious) == false)
+			return (false);
+	}
+	if (m_Links.ToNext)
+	{
+		const Region& region = GetRegion(lastRegionIndex);
+		const float ghostBandStart = static_cast<float>(region.MaxX - RegionEngine::GhostBandWidth);
+		for (Car* car : region.Cars)
+		{
+			if (car->GetPosition().x >= ghostBandStart)
+				m_GhostsToNext.push_back(car);
+		}
+		if (Send(m_Links.ToNext, m_GhostsToNext) == false)
+			return (false);
+	}
+	if (m_Links.FromPrevious && Receive(m_Links.FromPrevious, &m_GhostsFromPrevious) == false)
+		return (false);
+	if (m_Links.FromNext && Receive(m_Links.FromNext, &m_GhostsFromNext) == false)
+		return (false);
+
+	for (size_t i = firstRegionIndex; i <= lastRegionIndex; i++)
+		GatherNearbyCars(i);
+
+	// Even regions then odd regions
+	for (size_t i = firstRegionIndex; i <= lastRegionIndex; i++)
+	{
+		MoveCars(i);
+		if (i == firstRegionIndex)
+		{
+			// The neighbours' next regions need to see where our ghosts went (only the states, the ghosts stay the same)
+			if (m_Links.ToPrevious && Send(m_Links.ToPrevious, m_GhostsToPrevious) == false)
+				return (false);
+			if (m_Links.ToNext && Send(m_Links.ToNext, m_GhostsToNext) == false)
+				return (false);
+			if (m_Links.FromPrevious && Receive(m_Links.FromPrevious, nullptr) == false)
+				return (false);
+			if (m_Links.FromNext && Receive(m_Links.FromNext, nullptr) == false)
+				return (false);
+		}
+	}
+
+	// Hand over the cars that crossed the borders of the shard
+	if (m_Links.ToPrevious && Send(m_Links.ToPrevious, GetRegion(firstRegionIndex).LeavingToPrevious) == false)
+		return (false);
+	if (m_Links.ToNext && Send(m_Links.ToNext, GetRegion(lastRegionIndex).LeavingToNext) == false)
+		return (false);
+	if (m_Links.FromPrevious && Receive(m_Links.FromPrevious, &m_ArrivedFromPrevious) == false)
+		return (false);
+	if (m_Links.FromNext && Receive(m_Links.FromNext, &m_ArrivedFromNext) == false)
+		return (false);
+
+	for (size_t i = firstRegionIndex; i <= lastRegionIndex; i++)
+		AdoptCars(i);
+	return (true);
+}
+
+void ShardEngine::CollectOwnedCars(std::vector<const Car*>& outCars) const
+{
+	for (const Region& region : m_Regions)
+		outCars.insert(outCars.end(), region.Cars.begin(), region.Cars.end());
+}
+
+void ShardEngine::GatherNearbyCars(size_t regionIndex)
+{
+	Region& region = GetRegion(regionIndex);
+	region.NearbyCars.assign(region.Cars.begin(), region.Cars.end());
+
+	if (regionIndex > 0 && IsRegionOwned(regionIndex - 1))
+	{
+		const float ghostBandStart = static_cast<float>(region.MinX - RegionEngine::GhostBandWidth);
+		for (const Car* car : GetRegion(regionIndex - 1).Cars)
+		{
+			if (car->GetPosition().x >= ghostBandStart)
+				region.NearbyCars.push_back(car);
+		}
+	}
+	else if (regionIndex > 0)
+		// The previous region is in another shard, only its ghosts are up to date
+		region.NearbyCars.insert(region.NearbyCars.end(), m_GhostsFromPrevious.begin(), m_GhostsFromPrevious.end());
+
+	if (IsRegionOwned(regionIndex + 1))
+	{
+		const float ghostBandEnd = static_cast<float>(region.MaxX + RegionEngine::GhostBandWidth);
+		for (const Car* car : GetRegion(regionIndex + 1).Cars)
+		{
+			if (car->GetPosition().x < ghostBandEnd)
+				region.NearbyCars.push_back(car);
+		}
+	}
+	else if (regionIndex < m_RegionsEnd.size() - 1)
+		region.NearbyCars.insert(region.NearbyCars.end(), m_GhostsFromNext.begin(), m_GhostsFromNext.end());
+
+	// Sorted like RegionEngine::GatherNearbyCars, the cars are given to Car::Move in the same order
+	region.SortedNearbyCars.Clear();
+	for (size_t i = 0; i < region.NearbyCars.size(); i++)
+		region.SortedNearbyCars.Add(region.NearbyCars[i]->GetPosition(), static_cast<uint32_t>(i));
+	region.SortedNearbyCars.Sort();
+}
+
+void ShardEngine::MoveCars(size_t regionIndex)
+{
+	Region& region = GetRegion(regionIndex);
+	region.LeavingToPrevious.clear();
+	region.LeavingToNext.clear();
+
+	size_t i = 0;
+	while (i < region.Cars.size())
+	{
+		Car* car = region.Cars[i];
+		const IntVector2D carTile = region.SortedNearbyCars.GetClampedTile(car->GetPosition());
+		region.CarsAround.clear();
+		region.SortedNearbyCars.GatherCars(carTile - RegionEngine::NearbyTilesRadius, carTile + RegionEngine::NearbyTilesRadius, region.NearbyCars, region.CarsAround);
+		car->Move(region.CarsAround);
+
+		size_t newRegionIndex = RegionEngine::FindStripIndex(m_RegionsEnd, car->GetPosition().x);
+		if (newRegionIndex == regionIndex)
+		{
+			i++;
+			continue;
+		}
+		assert(newRegionIndex + 1 == regionIndex || newRegionIndex == regionIndex + 1);
+		(newRegionIndex < regionIndex ? region.LeavingToPrevious : region.LeavingToNext).push_back(car);
+		region.Cars[i] = region.Cars.back();
+		region.Cars.pop_back();
+		m_HandoversAmount++;
+	}
+}
+
+void ShardEngine::AdoptCars(size_t regionIndex)
+{
+	Region& region = GetRegion(regionIndex);
+	const std::vector<Car*>& fromPrevious = (regionIndex > 0 && IsRegionOwned(regionIndex - 1) ? GetRegion(regionIndex - 1).LeavingToNext : m_ArrivedFromPrevious);
+	const std::vector<Car*>& fromNext = (IsRegionOwned(regionIndex + 1) ? GetRegion(regionIndex + 1).LeavingToPrevious : m_ArrivedFromNext);
+	region.Cars.insert(region.Cars.end(), fromPrevious.begin(), fromPrevious.end());
+	region.Cars.insert(region.Cars.end(), fromNext.begin(), fromNext.end());
+}
+
+bool ShardEngine::Send(ShardRing* ring, const std::vector<Car*>& cars) const
+{
+	for (const Car* car : cars)
+	{
+		if (ring->Push(*m_Links.IsAborted, { car->GetId(), car->GetLastTrackDirection(), car->GetState() }) == false)
+			return (false);
+	}
+	return (ring->PushEndOfBatch(*m_Links.IsAborted));
+}
+
+bool ShardEngine::Receive(ShardRing* ring, std::vector<Car*>* outCars)
+{
+	if (outCars)
+		outCars->clear();
+
+	ShardCarRecord record;
+	while (true)
+	{
+		if (ring->Pop(*m_Links.IsAborted, record) == false)
+			return (false);
+		if (record.id == ShardCarRecord::EndOfBatchId)
+			return (true);
+
+		Car* car = m_Cars[record.id];
+		car->ApplyState(record.state, record.lastTrackDirection);
+		if (outCars)
+			outCars->push_back(car);
+	}
+}
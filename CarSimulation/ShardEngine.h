@@ -0,0 +1,115 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+#include "RegionEngine.h"
+#include "ShardChannel.h"
+#include "TileSortedCars.h"
+
+#include <vector>
+#include <memory>
+#include <atomic>
+
+/**
+ * One shard of a simulation split over several processes (see ShardRunner), each one stepping 2 regions of the map.
+ * It does exactly what the RegionEngine thread with the same index does, in the same order,
+ * but the neighbour regions of the other shards are replaced by messages:
+ * - the ghost cars along the borders are sent before moving, and sent again once they moved (even regions move before the odd ones),
+ * - the cars crossing a border are sent with their whole state to the neighbour shard.
+ * Every process hold a copy of the whole fleet, but only the cars owned by the shard (and the ghost copies) are up to date.
+ * So N shards give, tick for tick, the same result as a RegionEngine with N threads.
+ */
+class ShardEngine
+{
+
+public:
+	/** The connections of a shard, all in the shared memory (the rings are null for the first and last shard) */
+	struct Links
+	{
+		ShardRing* ToPrevious = nullptr;
+		ShardRing* FromPrevious = nullptr;
+		ShardRing* ToNext = nullptr;
+		ShardRing* FromNext = nullptr;
+		ProcessBarrier* TickBarrier = nullptr;
+		/** Set when a shard died, so the others stop waiting for it */
+		const std::atomic<uint32_t>* IsAborted = nullptr;
+	};
+
+	/** Amount of shards needed to split the map like a RegionEngine with the given amount of threads */
+	static size_t FindShardsAmount(const ATrack& track, unsigned int shardsAmount) { return ((RegionEngine::FindRegionsAmount(track, shardsAmount) + 1) / 2); }
+
+	/**
+	 * \param cars The whole fleet (the car ids have to be their index).
+	 * \param shardsAmount The amount of shards, it have to come from FindShardsAmount.
+	 */
+	ShardEngine(const ATrack& track, const std::vector<Car*>& cars, size_t shardIndex, size_t shardsAmount, const Links& links);
+
+public:
+	/**
+	 * Move the shard's cars 1 step forward, in lockstep with the other shards (the track's lights time have to be set before).
+	 *
+	 * \return false if the run has been aborted.
+	 */
+	bool Tick();
+
+	/** The cars currently owned by this shard */
+	void CollectOwnedCars(std::vector<const Car*>& outCars) const;
+	size_t GetHandoversAmount() const { return (m_HandoversAmount); }
+
+private:
+	/** Same as RegionEngine::Region */
+	struct Region
+	{
+		explicit Region(const ATrack& track) : SortedNearbyCars(track) {}
+
+		int MinX = 0;
+		int MaxX = 0;
+		std::vector<Car*> Cars;
+		std::vector<const Car*> NearbyCars;
+		TileSortedCars SortedNearbyCars;
+		std::vector<const Car*> CarsAround;
+		std::vector<Car*> LeavingToPrevious;
+		std::vector<Car*> LeavingToNext;
+	};
+
+	bool IsRegionOwned(size_t regionIndex) const { return (regionIndex >= m_FirstRegionIndex && regionIndex < m_FirstRegionIndex + m_Regions.size()); }
+	Region& GetRegion(size_t regionIndex) { return (m_Regions[regionIndex - m_FirstRegionIndex]); }
+
+	void GatherNearbyCars(size_t regionIndex);
+	void MoveCars(size_t regionIndex);
+	void AdoptCars(size_t regionIndex);
+
+	/**
+	 * Send the state of the given cars as 1 batch, wait for the neighbour when the ring is full.
+	 *
+	 * \return false if aborted.
+	 */
+	bool Send(ShardRing* ring, const std::vector<Car*>& cars) const;
+	/**
+	 * Receive 1 batch and apply it to our copies of the cars.
+	 *
+	 * \param outCars The received cars (can be null).
+	 * \return false if aborted.
+	 */
+	bool Receive(ShardRing* ring, std::vector<Car*>* outCars);
+
+private:
+	const std::vector<Car*>& m_Cars;
+	const Links m_Links;
+
+	const std::vector<int> m_RegionsEnd;
+	const size_t m_FirstRegionIndex;
+	std::vector<Region> m_Regions;
+
+	/** The ghost cars sent to the neighbours and received from them during the current tick */
+	std::vector<Car*> m_GhostsToPrevious;
+	std::vector<Car*> m_GhostsToNext;
+	std::vector<Car*> m_GhostsFromPrevious;
+	std::vector<Car*> m_GhostsFromNext;
+	/** The cars handed over by the neighbours during the current tick */
+	std::vector<Car*> m_ArrivedFromPrevious;
+	std::vector<Car*> m_ArrivedFromNext;
+
+	size_t m_HandoversAmount = 0;
+};
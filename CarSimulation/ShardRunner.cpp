@@ -0,0 +1,207 @@
+#include "ShardRunner.h"
+#include "TickPacer.h"
+
+#ifndef _WIN32
+
+#include <new>
+#include <thread>
+#include <string>
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+
+namespace
+{
+	size_t AlignOnCacheLine(size_t size) { return ((size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE); }
+}
+
+ShardRunner::ShardRunner(ATrack& track, const std::vector<Car*>& cars, size_t shardsAmount)
+	: m_Track(track),
+	m_Cars(cars),
+	m_ShardsAmount(ShardEngine::FindShardsAmount(track, static_cast<unsigned int>(shardsAmount)))
+{
+}
+
+ShardRunner::~ShardRunner()
+{
+	if (m_SharedMemory == nullptr)
+		return;
+
+	// Stop the shards still running, quietly, it's not a failure
+	m_Header->IsAborted.store(1);
+	for (pid_t process : m_ShardProcesses)
+	{
+		if (process != 0)
+			waitpid(process, nullptr, 0);
+	}
+	munmap(m_SharedMemory, m_SharedMemorySize);
+}
+
+bool ShardRunner::Start(uint64_t ticksAmount, bool isRealTime)
+{
+	assert(m_ShardProcesses.empty());
+	if (CreateSharedMemory() == false)
+		return (false);
+
+	// Otherwise what is waiting to be printed would be printed by every shard too
+	std::cout.flush();
+	for (size_t i = 0; i < m_ShardsAmount; i++)
+	{
+		pid_t process = fork();
+		if (process == -1)
+		{
+			std::cout << "Can't start the shard " << i << ": " << std::strerror(errno) << std::endl;
+			// The shards already started would wait for this one forever
+			m_Header->IsAborted.store(1);
+			Wait();
+			m_HasFailed = true;
+			return (false);
+		}
+		if (process == 0)
+			RunShard(i, ticksAmount, isRealTime);
+		m_ShardProcesses.push_back(process);
+	}
+	return (true);
+}
+
+bool ShardRunner::CheckShards()
+{
+	for (size_t i = 0; i < m_ShardProcesses.size(); i++)
+	{
+		int status;
+		if (m_ShardProcesses[i] != 0 && waitpid(m_ShardProcesses[i], &status, WNOHANG) == m_ShardProcesses[i])
+			OnShardExited(i, status);
+	}
+	return (m_HasFailed == false);
+}
+
+bool ShardRunner::Wait()
+{
+	// Wait for any shard, so the others are stopped as soon as one fail
+	size_t runningShardsAmount = 0;
+	for (pid_t process : m_ShardProcesses)
+		runningShardsAmount += (process != 0 ? 1 : 0);
+	while (runningShardsAmount > 0)
+	{
+		int status;
+		pid_t process = wait(&status);
+		if (process == -1)
+			break;
+		for (size_t i = 0; i < m_ShardProcesses.size(); i++)
+		{
+			if (m_ShardProcesses[i] == process)
+			{
+				OnShardExited(i, status);
+				runningShardsAmount--;
+			}
+		}
+	}
+	return (m_HasFailed == false);
+}
+
+void ShardRunner::ReadCarStates(const std::vector<Car*>& cars) const
+{
+	for (const auto& car : cars)
+	{
+		ShardCarRecord record = m_PublishedCars[car->GetId()].Load();
+		car->ApplyState(record.state, record.lastTrackDirection);
+	}
+}
+
+bool ShardRunner::CreateSharedMemory()
+{
+	// A batch hold at most every car plus the end of batch, and a ring may hold 2 batches
+	const uint64_t ringCapacity = (m_Cars.size() + 1) * 2;
+	const size_t ringsAmount = (m_ShardsAmount - 1) * 2;
+	const size_t headerSize = AlignOnCacheLine(sizeof(SharedHeader));
+	const size_t ringSize = AlignOnCacheLine(ShardRing::GetSizeInBytes(ringCapacity));
+	const size_t publishedCarsSize = AlignOnCacheLine(sizeof(SeqLock<ShardCarRecord>) * m_Cars.size());
+	const size_t sharedMemorySize = headerSize + ringSize * ringsAmount + publishedCarsSize;
+
+	const std::string name = "/CarSimulation-" + std::to_string(getpid());
+	int file = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+	if (file == -1)
+	{
+		std::cout << "Can't create the shared memory " << name << ": " << std::strerror(errno) << std::endl;
+		return (false);
+	}
+	void* memory = MAP_FAILED;
+	if (ftruncate(file, static_cast<off_t>(sharedMemorySize)) != 0)
+		std::cout << "Can't size the shared memory " << name << ": " << std::strerror(errno) << std::endl;
+	else if ((memory = mmap(nullptr, sharedMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0)) == MAP_FAILED)
+		std::cout << "Can't map the shared memory " << name << ": " << std::strerror(errno) << std::endl;
+	// The name is only needed to map it, the shards inherit the mapping
+	close(file);
+	shm_unlink(name.c_str());
+	if (memory == MAP_FAILED)
+		return (false);
+
+	m_SharedMemory = static_cast<unsigned char*>(memory);
+	m_SharedMemorySize = sharedMemorySize;
+	m_Header = new (m_SharedMemory) SharedHeader(static_cast<uint32_t>(m_ShardsAmount));
+	for (size_t i = 0; i < ringsAmount; i++)
+		m_Rings.push_back(new (m_SharedMemory + headerSize + ringSize * i) ShardRing(ringCapacity));
+	m_PublishedCars = reinterpret_cast<SeqLock<ShardCarRecord>*>(m_SharedMemory + headerSize + ringSize * ringsAmount);
+	for (const auto& car : m_Cars)
+		new (&m_PublishedCars[car->GetId()]) SeqLock<ShardCarRecord>({ car->GetId(), car->GetLastTrackDirection(), car->GetState() });
+	return (true);
+}
+
+ShardRing* ShardRunner::GetRing(size_t fromShardIndex, bool toPrevious) const
+{
+	// 2 rings between each pair of neighbours, the one going forward first
+	if (toPrevious)
+		return (fromShardIndex > 0 ? m_Rings[(fromShardIndex - 1) * 2 + 1] : nullptr);
+	return (fromShardIndex < m_ShardsAmount - 1 ? m_Rings[fromShardIndex * 2] : nullptr);
+}
+
+void ShardRunner::RunShard(size_t shardIndex, uint64_t ticksAmount, bool isRealTime)
+{
+	ShardEngine::Links links;
+	links.ToPrevious = GetRing(shardIndex, true);
+	links.FromPrevious = (shardIndex > 0 ? GetRing(shardIndex - 1, false) : nullptr);
+	links.ToNext = GetRing(shardIndex, false);
+	links.FromNext = (shardIndex < m_ShardsAmount - 1 ? GetRing(shardIndex + 1, true) : nullptr);
+	links.TickBarrier = &m_Header->TickBarrier;
+	links.IsAborted = &m_Header->IsAborted;
+	ShardEngine engine(m_Track, m_Cars, shardIndex, m_ShardsAmount, links);
+
+	std::vector<const Car*> ownedCars;
+	// The first tick run at once, the shards are on the same clock through the barrier of the tick
+	TickPacer pacer(THREAD_REFRESH_DURATION, SelectedOverrunPolicy, PACER_SPIN_DURATION);
+	for (uint64_t tick = 0; ticksAmount == 0 || tick < ticksAmount; tick++)
+	{
+		if (isRealTime && tick > 0)
+			pacer.WaitNextTick();
+
+		m_Track.GetTrafficLight().SetTime(static_cast<double>(tick) * TickDurationInSecond);
+		if (engine.Tick() == false)
+			_exit(EXIT_FAILURE);
+
+		ownedCars.clear();
+		engine.CollectOwnedCars(ownedCars);
+		for (const Car* car : ownedCars)
+			m_PublishedCars[car->GetId()].Store({ car->GetId(), car->GetLastTrackDirection(), car->GetState() });
+	}
+	// _exit, the shard is a copy of this process, it must not run what the original process run at exit
+	_exit(EXIT_SUCCESS);
+}
+
+void ShardRunner::OnShardExited(size_t shardIndex, int status)
+{
+	m_ShardProcesses[shardIndex] = 0;
+	if (WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS)
+		return;
+
+	// Stop the others, they would wait for this one forever
+	if (m_Header->IsAborted.exchange(1) == 0)
+		std::cout << "Shard " << shardIndex << " failed, stopping the simulation" << std::endl;
+	m_HasFailed = true;
+}
+
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+// Processes and POSIX shared memory, Linux only
+#ifndef _WIN32
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+#include "ShardEngine.h"
+#include "ShardChannel.h"
+#include "SeqLock.h"
+
+#include <vector>
+#include <memory>
+#include <chrono>
+#include <sys/types.h>
+
+/**
+ * Run a simulation split over several processes, one ShardEngine per process.
+ * The shards talk through rings in a POSIX shared memory block and wait for each other at the start of every tick.
+ * Each shard publish the state of its cars in the shared memory, so this process can follow the simulation (ReadCarStates).
+ * If a shard dies the others are stopped instead of waiting for it forever.
+ */
+class ShardRunner
+{
+
+public:
+	/**
+	 * \param track The track, with the cars registered (each shard get a copy of both when it start).
+	 * \param cars The whole fleet (the car ids have to be their index).
+	 * \param shardsAmount The amount of processes wanted, less are made if the map is too narrow (see ShardEngine::FindShardsAmount).
+	 */
+	ShardRunner(ATrack& track, const std::vector<Car*>& cars, size_t shardsAmount);
+	~ShardRunner();
+	ShardRunner(const ShardRunner& other) = delete;
+	ShardRunner& operator=(const ShardRunner& other) = delete;
+
+public:
+	/**
+	 * Create the shared memory and start the shards processes.
+	 *
+	 * \param ticksAmount The amount of ticks to run, 0 to run until this object is destroyed.
+	 * \param isRealTime true to run 1 tick every THREAD_REFRESH_DURATION, false to run as fast as possible.
+	 * \return false if the shared memory or a process can't be created (the error is printed, the shards already started are stopped).
+	 */
+	bool Start(uint64_t ticksAmount, bool isRealTime);
+	/** Check the shards without waiting, return false if one of them failed (the others are then stopped) */
+	bool CheckShards();
+	/** Wait for all the shards to finish, return false if one of them failed */
+	bool Wait();
+
+	/** Copy the last state published by the shards into the given cars (usually the cars given to the constructor), once started */
+	void ReadCarStates(const std::vector<Car*>& cars) const;
+
+	size_t GetShardsAmount() const { return (m_ShardsAmount); }
+
+private:
+	/** The beginning of the shared memory block */
+	struct SharedHeader
+	{
+		explicit SharedHeader(uint32_t shardsAmount) : TickBarrier(shardsAmount) {}
+
+		std::atomic<uint32_t> IsAborted = { 0 };
+		ProcessBarrier TickBarrier;
+	};
+
+	/** Create and map the shared memory block, and build everything in it */
+	bool CreateSharedMemory();
+	/** The ring from a shard to its previous (toPrevious = true) or next neighbour */
+	ShardRing* GetRing(size_t fromShardIndex, bool toPrevious) const;
+	/** Body of a shard process, never return */
+	void RunShard(size_t shardIndex, uint64_t ticksAmount, bool isRealTime);
+	/** Handle the exit of a shard, a shard that failed stop all the others */
+	void OnShardExited(size_t shardIndex, int status);
+
+private:
+	ATrack& m_Track;
+	const std::vector<Car*>& m_Cars;
+	const size_t m_ShardsAmount;
+
+	/** The shared memory block: the header, the rings, then the published car states */
+	unsigned char* m_SharedMemory = nullptr;
+	size_t m_SharedMemorySize = 0;
+	SharedHeader* m_Header = nullptr;
+	std::vector<ShardRing*> m_Rings;
+	SeqLock<ShardCarRecord>* m_PublishedCars = nullptr;
+
+	/** The process of each shard, 0 once it's finished */
+	std::vector<pid_t> m_ShardProcesses;
+	bool m_HasFailed = false;
+};
+
+#endif
@@ -0,0 +1,61 @@
+#include "TickArena.h"
+
+#include <algorithm>
+#include <new>
+
+namespace
+{
+	/** Enough for any type the arena can hold */
+	constexpr std::align_val_t BlockAlignment = std::align_val_t(alignof(std::max_align_t));
+}
+
+TickArena::TickArena(size_t capacityInBytes)
+{
+	if (capacityInBytes > 0)
+	{
+		m_Block = static_cast<std::byte*>(::operator new(capacityInBytes, BlockAlignment));
+		m_Capacity = capacityInBytes;
+	}
+}
+
+TickArena::~TickArena()
+{
+	Reset();
+	if (m_Block)
+		::operator delete(m_Block, BlockAlignment);
+}
+
+void TickArena::Reset()
+{
+	if (m_OverflowBlocks.empty() == false)
+	{
+		// That tick did not fit, make room for at least as much as it used
+		const size_t neededCapacity = std::max(m_Capacity * 2, m_UsedBytes + m_OverflowBytes);
+		for (std::byte* block : m_OverflowBlocks)
+			::operator delete(block, BlockAlignment);
+		m_OverflowBlocks.clear();
+		m_OverflowBytes = 0;
+
+		if (m_Block)
+			::operator delete(m_Block, BlockAlignment);
+		m_Block = static_cast<std::byte*>(::operator new(neededCapacity, BlockAlignment));
+		m_Capacity = neededCapacity;
+	}
+	m_UsedBytes = 0;
+}
+
+void* TickArena::AllocateBytes(size_t size, size_t alignment)
+{
+	const size_t alignedOffset = (m_UsedBytes + alignment - 1) / alignment * alignment;
+	if (m_Block && alignedOffset + size <= m_Capacity)
+	{
+		m_UsedBytes = alignedOffset + size;
+		return (m_Block + alignedOffset);
+	}
+
+	// Does not fit, it get its own block until the next reset
+	std::byte* block = static_cast<std::byte*>(::operator new(std::max<size_t>(1, size), BlockAlignment));
+	m_OverflowBlocks.push_back(block);
+	m_OverflowBytes += size + alignment;
+	return (block);
+}
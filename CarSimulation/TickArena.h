@@ -0,0 +1,49 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <type_traits>
+
+/**
+ * Bump allocator for the scratch data of a tick (or a frame): allocating only move an offset forward,
+ * and everything is released at once by Reset at the start of the next tick.
+ * When a tick need more than the block, the extra allocations get their own blocks and the next Reset
+ * grow the block to fit them, so once the biggest tick was seen the arena never touch the heap again.
+ * Only for trivial types, nothing is destroyed. Not thread safe, use one arena per thread.
+ */
+class TickArena
+{
+
+public:
+	explicit TickArena(size_t capacityInBytes = 0);
+	~TickArena();
+	TickArena(const TickArena& other) = delete;
+	TickArena& operator=(const TickArena& other) = delete;
+
+public:
+	/** Allocate an uninitialized array, valid until the next Reset */
+	template<typename T>
+	T* Allocate(size_t amount)
+	{
+		static_assert(std::is_trivially_default_constructible<T>::value && std::is_trivially_destructible<T>::value, "The arena only hold trivial types");
+		return (static_cast<T*>(AllocateBytes(sizeof(T) * amount, alignof(T))));
+	}
+	/** Release everything allocated since the last reset (and grow the block if it was too small) */
+	void Reset();
+
+	size_t GetCapacity() const { return (m_Capacity); }
+	/** Bytes allocated since the last reset, the overflow blocks included */
+	size_t GetUsedBytes() const { return (m_UsedBytes + m_OverflowBytes); }
+
+private:
+	void* AllocateBytes(size_t size, size_t alignment);
+
+private:
+	std::byte* m_Block = nullptr;
+	size_t m_Capacity = 0;
+	size_t m_UsedBytes = 0;
+
+	/** The allocations that did not fit in the block since the last reset */
+	std::vector<std::byte*> m_OverflowBlocks;
+	size_t m_OverflowBytes = 0;
+};
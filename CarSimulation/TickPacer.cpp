@@ -0,0 +1,56 @@
+#include "TickPacer.h"
+
+#include <thread>
+#include <algorithm>
+#include <cassert>
+
+TickPacer::TickPacer(Clock::duration tickDuration, EOverrunPolicy overrunPolicy, Clock::duration spinDuration)
+	: m_TickDuration(tickDuration), m_OverrunPolicy(overrunPolicy), m_SpinDuration(spinDuration), m_StartTime(Clock::now()), m_NextDeadline(m_StartTime + tickDuration)
+{
+	assert(tickDuration > Clock::duration::zero());
+}
+
+void TickPacer::WaitNextTick()
+{
+	m_TicksAmount++;
+	const Clock::time_point now = Clock::now();
+	if (now > m_NextDeadline)
+	{
+		// The tick took longer than its duration (or the thread did not get a core in time)
+		const Clock::duration lateness = now - m_NextDeadline;
+		m_MissedDeadlinesAmount++;
+		m_WorstLateness = std::max(m_WorstLateness, lateness);
+
+		// The deadlines after this one that passed too
+		const uint64_t passedDeadlinesAmount = static_cast<uint64_t>(lateness / m_TickDuration);
+		if (m_OverrunPolicy == EOverrunPolicy::CatchUp && passedDeadlinesAmount < MaxCatchUpTicks)
+		{
+			m_NextDeadline += m_TickDuration;
+			return;
+		}
+		// Back on the same grid of deadlines, the next one is the first still to come
+		m_SkippedDeadlinesAmount += passedDeadlinesAmount;
+		m_NextDeadline += m_TickDuration * (passedDeadlinesAmount + 1);
+		return;
+	}
+
+	if (m_SpinDuration > Clock::duration::zero())
+	{
+		std::this_thread::sleep_until(m_NextDeadline - m_SpinDuration);
+		while (Clock::now() < m_NextDeadline)
+		{
+			// Spin, a yield could give the core away for longer than a tick
+		}
+	}
+	else
+		std::this_thread::sleep_until(m_NextDeadline);
+
+	m_WorstWakeUpDelay = std::max(m_WorstWakeUpDelay, Clock::now() - m_NextDeadline);
+	m_NextDeadline += m_TickDuration;
+}
+
+double TickPacer::GetTickRate() const
+{
+	const std::chrono::duration<double> elapsedTime = Clock::now() - m_StartTime;
+	return (elapsedTime.count() > 0.0 ? static_cast<double>(m_TicksAmount) / elapsedTime.count() : 0.0);
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Defines.h"
+
+#include <chrono>
+#include <cstdint>
+
+/** What the TickPacer do with a tick that start after its deadline */
+enum class EOverrunPolicy
+{
+	/** The late tick run at once, the deadlines that passed meanwhile are dropped (the loop fall behind the clock) */
+	Skip,
+	/** The late ticks run back to back until they're on time again, so in the long run the loop run as many ticks as the clock say */
+	CatchUp
+};
+
+/** The policy selected in Defines.h */
+constexpr EOverrunPolicy SelectedOverrunPolicy = (PACER_OVERRUN_POLICY == 1 ? EOverrunPolicy::CatchUp : EOverrunPolicy::Skip);
+
+/**
+ * Run a loop at a fixed rate: the loop call WaitNextTick at the end of each tick, it return at the deadline of the next one.
+ * The deadlines are absolute (start + n * tick duration, on the steady clock), so the time taken by the loop and the late wake ups
+ * never add up, and a change of the system clock have no effect.
+ * The OS wake up a sleeping thread up to a millisecond late (a lot more on Windows), too late for the sub-millisecond ticks,
+ * so the end of each wait can be spent spinning instead (spinDuration, it keep a core busy for that long every tick).
+ * A tick that start after its deadline is counted as missed, then handled by the overrun policy.
+ * Not thread safe, one pacer per loop.
+ */
+class TickPacer
+{
+
+public:
+	using Clock = std::chrono::steady_clock;
+
+	/** With CatchUp, a loop more ticks than that behind the clock will never catch up, the pacer skip to the clock instead */
+	static constexpr uint64_t MaxCatchUpTicks = 10;
+
+public:
+	/**
+	 * The first deadline is one tick duration after the construction.
+	 *
+	 * \param tickDuration The time between 2 deadlines.
+	 * \param spinDuration How long before each deadline the pacer stop sleeping and spin, 0 to only sleep.
+	 */
+	TickPacer(Clock::duration tickDuration, EOverrunPolicy overrunPolicy, Clock::duration spinDuration = Clock::duration::zero());
+
+public:
+	/** Wait for the deadline of the next tick, return at once if it already passed */
+	void WaitNextTick();
+
+	uint64_t GetTicksAmount() const { return (m_TicksAmount); }
+	/** Amount of ticks that started after their deadline */
+	uint64_t GetMissedDeadlinesAmount() const { return (m_MissedDeadlinesAmount); }
+	/** Amount of deadlines without a tick (dropped by Skip, or by CatchUp once too far behind) */
+	uint64_t GetSkippedDeadlinesAmount() const { return (m_SkippedDeadlinesAmount); }
+	/** How late the latest tick started */
+	Clock::duration GetWorstLateness() const { return (m_WorstLateness); }
+	/** How late the pacer returned after a wait, what the spin is for */
+	Clock::duration GetWorstWakeUpDelay() const { return (m_WorstWakeUpDelay); }
+	/** Ticks per second since the construction */
+	double GetTickRate() const;
+
+private:
+	const Clock::duration m_TickDuration;
+	const EOverrunPolicy m_OverrunPolicy;
+	const Clock::duration m_SpinDuration;
+	const Clock::time_point m_StartTime;
+	Clock::time_point m_NextDeadline;
+
+	uint64_t m_TicksAmount = 0;
+	uint64_t m_MissedDeadlinesAmount = 0;
+	uint64_t m_SkippedDeadlinesAmount = 0;
+	Clock::duration m_WorstLateness = Clock::duration::zero();
+	Clock::duration m_WorstWakeUpDelay = Clock::duration::zero();
+};
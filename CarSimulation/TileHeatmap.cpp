@@ -0,0 +1,226 @@
+#include "TileHeatmap.h"
+
+#include <algorithm>
+#include <fstream>
+
+namespace
+{
+	/** What a pixel of the images sum up, the tiles drawn in it */
+	struct Cell
+	{
+		uint64_t busiestTileCarTicksAmount = 0;
+		uint64_t carTicksAmount = 0;
+		uint64_t stoppedTicksAmount = 0;
+		double speedSum = 0.0;
+		bool hasRoad = false;
+	};
+
+	char ToGray(float value)
+	{
+		return (static_cast<char>(static_cast<uint8_t>(CLAMP(0.0f, 1.0f, value) * 255.0f)));
+	}
+}
+
+TileHeatmap::TileHeatmap(const ATrack& track, size_t threadsAmount)
+	: m_Track(track),
+	m_BlocksWidth((track.GetWidth() + BlockSize - 1) / BlockSize),
+	m_BlocksHeight((track.GetHeight() + BlockSize - 1) / BlockSize),
+	m_Threads(std::max<size_t>(1, threadsAmount))
+{
+	for (ThreadTiles& thread : m_Threads)
+		thread.blocks.resize(static_cast<size_t>(m_BlocksWidth) * m_BlocksHeight);
+}
+
+void TileHeatmap::RecordCar(const Car& car, size_t threadIndex, uint64_t ticksAmount)
+{
+	assert(threadIndex < m_Threads.size());
+	const CarKinematicState state = car.GetState();
+	const IntVector2D tilePosition = m_Track.MapPositionOnTrack(state.position);
+	if (m_Track.IsHereInMapBounds(tilePosition) == false)
+		return;
+
+	std::unique_ptr<TileBlock>& block = m_Threads[threadIndex].blocks[(tilePosition.y / BlockSize) * m_BlocksWidth + tilePosition.x / BlockSize];
+	if (block == nullptr)
+		block = std::make_unique<TileBlock>();
+	TileCounters& tile = block->tiles[(tilePosition.y % BlockSize) * BlockSize + tilePosition.x % BlockSize];
+	tile.carTicksAmount += ticksAmount;
+	tile.speedSum += state.speed * static_cast<double>(ticksAmount);
+	if (state.speed == 0.0f)
+		tile.stoppedTicksAmount += ticksAmount;
+}
+
+void TileHeatmap::RecordCars(const std::vector<Car*>& cars)
+{
+	for (const Car* car : cars)
+		RecordCar(*car, 0);
+}
+
+bool TileHeatmap::WriteFiles(const std::string& prefix, int pixelsPerTile) const
+{
+	uint64_t ticksAmount;
+	const TileBlocks blocks = SumTiles(ticksAmount);
+
+	// Past MaxImageSize tiles, a pixel is a square of several tiles
+	const int mapSize = std::max(m_Track.GetWidth(), m_Track.GetHeight());
+	const int tilesPerPixel = (mapSize + MaxImageSize - 1) / MaxImageSize;
+	const int cellsSize = (mapSize + tilesPerPixel - 1) / tilesPerPixel;
+	const int pixelsPerCell = CLAMP(1, MaxImageSize / cellsSize, pixelsPerTile);
+
+	return (WriteImages(prefix, blocks, tilesPerPixel, pixelsPerCell)
+		&& WriteCsv(prefix + ".csv", blocks, ticksAmount));
+}
+
+TileHeatmap::TileBlocks TileHeatmap::SumTiles(uint64_t& outTicksAmount) const
+{
+	TileBlocks blocks(m_Threads[0].blocks.size());
+	outTicksAmount = 0;
+	for (const ThreadTiles& thread : m_Threads)
+	{
+		for (size_t i = 0; i < blocks.size(); i++)
+		{
+			if (thread.blocks[i] == nullptr)
+				continue;
+			if (blocks[i] == nullptr)
+				blocks[i] = std::make_unique<TileBlock>();
+			for (size_t j = 0; j < blocks[i]->tiles.size(); j++)
+			{
+				const TileCounters& threadTile = thread.blocks[i]->tiles[j];
+				blocks[i]->tiles[j].carTicksAmount += threadTile.carTicksAmount;
+				blocks[i]->tiles[j].stoppedTicksAmount += threadTile.stoppedTicksAmount;
+				blocks[i]->tiles[j].speedSum += threadTile.speedSum;
+			}
+		}
+		outTicksAmount += thread.ticksAmount;
+	}
+	return (blocks);
+}
+
+const TileHeatmap::TileCounters* TileHeatmap::FindTile(const TileBlocks& blocks, int x, int y) const
+{
+	const TileBlock* block = blocks[(y / BlockSize) * m_BlocksWidth + x / BlockSize].get();
+	return (block == nullptr ? nullptr : &block->tiles[(y % BlockSize) * BlockSize + x % BlockSize]);
+}
+
+bool TileHeatmap::WriteImages(const std::string& prefix, const TileBlocks& blocks, int tilesPerPixel, int pixelsPerCell) const
+{
+	std::ofstream occupancyFile(prefix + "_occupancy.pgm", std::ios::binary);
+	std::ofstream speedFile(prefix + "_speed.pgm", std::ios::binary);
+	std::ofstream stopsFile(prefix + "_stops.pgm", std::ios::binary);
+	std::ofstream colorFile(prefix + ".ppm", std::ios::binary);
+	if (occupancyFile.is_open() == false || speedFile.is_open() == false || stopsFile.is_open() == false || colorFile.is_open() == false)
+		return (false);
+
+	// Bring everything between 0 and 1, the occupancy relatively to the busiest tile
+	uint64_t maxCarTicksAmount = 1;
+	for (const std::unique_ptr<TileBlock>& block : blocks)
+	{
+		if (block == nullptr)
+			continue;
+		for (const TileCounters& tile : block->tiles)
+			maxCarTicksAmount = std::max(maxCarTicksAmount, tile.carTicksAmount);
+	}
+
+	const int width = m_Track.GetWidth();
+	const int height = m_Track.GetHeight();
+	const int cellsWidth = (width + tilesPerPixel - 1) / tilesPerPixel;
+	const int cellsHeight = (height + tilesPerPixel - 1) / tilesPerPixel;
+	const int imageWidth = cellsWidth * pixelsPerCell;
+	const int imageHeight = cellsHeight * pixelsPerCell;
+	for (std::ofstream* file : { &occupancyFile, &speedFile, &stopsFile })
+		*file << "P5\n" << imageWidth << ' ' << imageHeight << "\n255\n";
+	colorFile << "P6\n" << imageWidth << ' ' << imageHeight << "\n255\n";
+
+	// Only a row of cells at a time, the images are never held in memory
+	std::vector<Cell> cells(cellsWidth);
+	std::vector<char> occupancyLine(imageWidth);
+	std::vector<char> speedLine(imageWidth);
+	std::vector<char> stopsLine(imageWidth);
+	std::vector<char> colorLine(static_cast<size_t>(imageWidth) * 3);
+	for (int cellY = 0; cellY < cellsHeight; cellY++)
+	{
+		std::fill(cells.begin(), cells.end(), Cell());
+		for (int y = cellY * tilesPerPixel; y < std::min(height, (cellY + 1) * tilesPerPixel); y++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				Cell& cell = cells[x / tilesPerPixel];
+				cell.hasRoad |= m_Track.IsHereARoad(IntVector2D(x, y));
+				const TileCounters* tile = FindTile(blocks, x, y);
+				if (tile == nullptr)
+					continue;
+				cell.busiestTileCarTicksAmount = std::max(cell.busiestTileCarTicksAmount, tile->carTicksAmount);
+				cell.carTicksAmount += tile->carTicksAmount;
+				cell.stoppedTicksAmount += tile->stoppedTicksAmount;
+				cell.speedSum += tile->speedSum;
+			}
+		}
+
+		for (int cellX = 0; cellX < cellsWidth; cellX++)
+		{
+			const Cell& cell = cells[cellX];
+			float occupancy = 0.0f;
+			float speed = 0.0f;
+			float stops = 0.0f;
+			uint8_t red = 0;
+			uint8_t green = 0;
+			uint8_t blue = 0;
+			if (cell.carTicksAmount > 0)
+			{
+				occupancy = static_cast<float>(cell.busiestTileCarTicksAmount) / maxCarTicksAmount;
+				speed = static_cast<float>(cell.speedSum / cell.carTicksAmount / CAR_MAX_MAXSPEED);
+				stops = static_cast<float>(cell.stoppedTicksAmount) / cell.carTicksAmount;
+				red = static_cast<uint8_t>(ToGray(stops));
+				green = static_cast<uint8_t>(ToGray(speed));
+			}
+			else if (cell.hasRoad)
+				red = green = blue = 64;
+
+			std::fill_n(occupancyLine.begin() + cellX * pixelsPerCell, pixelsPerCell, ToGray(occupancy));
+			std::fill_n(speedLine.begin() + cellX * pixelsPerCell, pixelsPerCell, ToGray(speed));
+			std::fill_n(stopsLine.begin() + cellX * pixelsPerCell, pixelsPerCell, ToGray(stops));
+			for (int i = 0; i < pixelsPerCell; i++)
+			{
+				char* pixel = colorLine.data() + (static_cast<size_t>(cellX) * pixelsPerCell + i) * 3;
+				pixel[0] = static_cast<char>(red);
+				pixel[1] = static_cast<char>(green);
+				pixel[2] = static_cast<char>(blue);
+			}
+		}
+		for (int i = 0; i < pixelsPerCell; i++)
+		{
+			occupancyFile.write(occupancyLine.data(), occupancyLine.size());
+			speedFile.write(speedLine.data(), speedLine.size());
+			stopsFile.write(stopsLine.data(), stopsLine.size());
+			colorFile.write(colorLine.data(), colorLine.size());
+		}
+	}
+	return (occupancyFile.good() && speedFile.good() && stopsFile.good() && colorFile.good());
+}
+
+bool TileHeatmap::WriteCsv(const std::string& path, const TileBlocks& blocks, uint64_t ticksAmount) const
+{
+	std::ofstream file(path);
+	if (file.is_open() == false)
+		return (false);
+
+	file << "x,y,track_char,car_ticks,average_cars,mean_speed,stopped_ratio\n";
+	for (int y = 0; y < m_Track.GetHeight(); y++)
+	{
+		for (int blockX = 0; blockX < m_BlocksWidth; blockX++)
+		{
+			if (blocks[(y / BlockSize) * m_BlocksWidth + blockX] == nullptr)
+				continue;
+			for (int x = blockX * BlockSize; x < std::min(m_Track.GetWidth(), (blockX + 1) * BlockSize); x++)
+			{
+				const TileCounters& tile = *FindTile(blocks, x, y);
+				if (tile.carTicksAmount == 0)
+					continue;
+				file << x << ',' << y << ',' << m_Track.GetTrackChar(IntVector2D(x, y)) << ',' << tile.carTicksAmount << ','
+					<< (ticksAmount > 0 ? static_cast<double>(tile.carTicksAmount) / ticksAmount : 0.0) << ','
+					<< tile.speedSum / tile.carTicksAmount << ','
+					<< static_cast<double>(tile.stoppedTicksAmount) / tile.carTicksAmount << '\n';
+			}
+		}
+	}
+	return (file.good());
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+
+#include <vector>
+#include <array>
+#include <memory>
+#include <string>
+#include <cstdint>
+
+/**
+ * Accumulate for every tile of the track how often a car was on it, how fast, and how often stopped,
+ * to see where the jams form without replaying the run.
+ * Each thread count in its own grid (a few additions per car and per tick, no lock), the grids are only summed when exported.
+ * A grid is sparse: the tiles are stored by blocks of BlockSize x BlockSize, a block is allocated the first time a car enter it,
+ * so the memory depend on the area the cars went through and not on the size of the map.
+ * The counts are written as grayscale images (PGM), one color image (PPM) and a CSV file.
+ */
+class TileHeatmap
+{
+
+public:
+	/** The side of a block of tiles, in tiles */
+	static constexpr int BlockSize = 16;
+	/** The max width and height of the images, a big map is drawn with several tiles per pixel */
+	static constexpr int MaxImageSize = 2048;
+
+public:
+	/** \param threadsAmount The amount of threads that can record cars at the same time */
+	TileHeatmap(const ATrack& track, size_t threadsAmount = 1);
+
+public:
+	/**
+	 * Count the car on the tile it is on, each car have to be recorded once per tick by one of the threads.
+	 *
+	 * \param ticksAmount When a step last several ticks (see AdaptiveTimeStep), the car is counted as if it stayed there for all of them.
+	 */
+	void RecordCar(const Car& car, size_t threadIndex, uint64_t ticksAmount = 1);
+	/** Record every car from the calling thread */
+	void RecordCars(const std::vector<Car*>& cars);
+	/** Count a tick of a simulation, call it once per tick (from the thread of the simulation when each thread run its own) */
+	void EndTick(size_t threadIndex = 0, uint64_t ticksAmount = 1) { m_Threads[threadIndex].ticksAmount += ticksAmount; }
+
+	/**
+	 * Write the heatmaps, the files are named after the prefix:
+	 * - prefix_occupancy.pgm: average amount of cars on the tile (white for the busiest tile),
+	 * - prefix_speed.pgm: mean speed of the cars on the tile (white for the max speed of the fastest cars),
+	 * - prefix_stops.pgm: part of the time the cars on the tile were stopped,
+	 * - prefix.ppm: the speed in green and the stops in red, the empty roads in gray,
+	 * - prefix.csv: one line per tile a car went on with the raw values.
+	 * When the map is too big for MaxImageSize, the tiles are drawn smaller, and then several tiles share a pixel
+	 * (the occupancy of its busiest tile, the speed and stops of all the cars on its tiles).
+	 *
+	 * \param pixelsPerTile The size of a tile in the images, at most.
+	 * \return false if a file can't be written.
+	 */
+	bool WriteFiles(const std::string& prefix, int pixelsPerTile = 16) const;
+
+private:
+	struct TileCounters
+	{
+		uint64_t carTicksAmount = 0;
+		uint64_t stoppedTicksAmount = 0;
+		double speedSum = 0.0;
+	};
+	struct TileBlock
+	{
+		std::array<TileCounters, BlockSize * BlockSize> tiles;
+	};
+	/** The blocks of a grid in the map order, nullptr where no car went */
+	using TileBlocks = std::vector<std::unique_ptr<TileBlock>>;
+	/** The grid of a thread, on its own cache lines */
+	struct alignas(CACHE_LINE_SIZE) ThreadTiles
+	{
+		TileBlocks blocks;
+		uint64_t ticksAmount = 0;
+	};
+
+	/** Sum the grids of all the threads */
+	TileBlocks SumTiles(uint64_t& outTicksAmount) const;
+	/** The counters of a tile, nullptr if no car went in its block */
+	const TileCounters* FindTile(const TileBlocks& blocks, int x, int y) const;
+	/** Write the images a row of pixels after the other, each cell (tilesPerPixel x tilesPerPixel tiles) is drawn as a square of pixelsPerCell */
+	bool WriteImages(const std::string& prefix, const TileBlocks& blocks, int tilesPerPixel, int pixelsPerCell) const;
+	bool WriteCsv(const std::string& path, const TileBlocks& blocks, uint64_t ticksAmount) const;
+
+private:
+	const ATrack& m_Track;
+	const int m_BlocksWidth;
+	const int m_BlocksHeight;
+	std::vector<ThreadTiles> m_Threads;
+};
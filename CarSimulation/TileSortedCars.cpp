@@ -0,0 +1,23 @@
+#include "TileSortedCars.h"
+
+IntVector2D TileSortedCars::GetTile(size_t i) const
+{
+	const uint64_t tileIndex = m_Entries[i] >> 32;
+	const int width = m_Track.GetWidth();
+	return (IntVector2D(static_cast<int>(tileIndex % width), static_cast<int>(tileIndex / width)));
+}
+
+size_t TileSortedCars::FindTileEnd(size_t i) const
+{
+	const uint64_t tileIndex = m_Entries[i] >> 32;
+	size_t end = i + 1;
+	while (end < m_Entries.size() && (m_Entries[end] >> 32) == tileIndex)
+		end++;
+	return (end);
+}
+
+IntVector2D TileSortedCars::GetClampedTile(const Vector2D& position) const
+{
+	const IntVector2D tile = m_Track.MapPositionOnTrack(position);
+	return (IntVector2D(CLAMP(0, m_Track.GetWidth() - 1, tile.x), CLAMP(0, m_Track.GetHeight() - 1, tile.y)));
+}
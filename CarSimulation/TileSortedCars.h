@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+/**
+ * Cars sorted by the tile they're on, to find the cars of a block of tiles without going through all of them
+ * (a grid of the tiles would not fit in memory on a 10000 x 10000 map).
+ * Each entry hold the index of the tile in the high 32 bits and the index of the car in the low ones (its id, or its index in the caller's list),
+ * the cars of a row of tiles are contiguous so a block of tiles is found with one binary search per row.
+ * The positions out of the map are clamped on its border, nothing is allocated once the reserved amount of cars is reached.
+ */
+class TileSortedCars
+{
+
+public:
+	explicit TileSortedCars(const ATrack& track) : m_Track(track) {}
+
+public:
+	void Reserve(size_t carsAmount) { m_Entries.reserve(carsAmount); }
+	void Clear() { m_Entries.clear(); }
+	/** Add a car at the given position, Sort have to be called before looking for the cars */
+	void Add(const Vector2D& position, uint32_t carIndex) { m_Entries.push_back(MakeKey(GetTileIndex(GetClampedTile(position)), carIndex)); }
+	void Sort() { std::sort(m_Entries.begin(), m_Entries.end()); }
+
+	size_t GetSize() const { return (m_Entries.size()); }
+	/** The index given to Add of the i-th sorted car */
+	uint32_t GetCarIndex(size_t i) const { return (static_cast<uint32_t>(m_Entries[i])); }
+	IntVector2D GetTile(size_t i) const;
+	/** The sorted cars on the same tile as the i-th one are [i, FindTileEnd(i)) (i have to be the first of its tile) */
+	size_t FindTileEnd(size_t i) const;
+
+	/** Call function(i) for each sorted car i on the tiles between firstTile and lastTile included (the tiles out of the map are skipped) */
+	template <typename Function>
+	void ForEachInTiles(const IntVector2D& firstTile, const IntVector2D& lastTile, Function&& function) const
+	{
+		const int width = m_Track.GetWidth();
+		const int firstX = std::max(0, firstTile.x);
+		const int lastX = std::min(width - 1, lastTile.x);
+		if (firstX > lastX)
+			return;
+		for (int y = std::max(0, firstTile.y); y <= std::min(m_Track.GetHeight() - 1, lastTile.y); y++)
+		{
+			// The tiles of a row are contiguous
+			const uint64_t rowIndex = static_cast<uint64_t>(y) * width;
+			size_t i = std::lower_bound(m_Entries.begin(), m_Entries.end(), MakeKey(rowIndex + firstX, 0)) - m_Entries.begin();
+			for (; i < m_Entries.size() && (m_Entries[i] >> 32) <= rowIndex + lastX; i++)
+				function(i);
+		}
+	}
+	/** Add to outCars the cars on the tiles between firstTile and lastTile included, the indices given to Add are indices in cars */
+	template <typename CarPointer>
+	void GatherCars(const IntVector2D& firstTile, const IntVector2D& lastTile, const std::vector<CarPointer>& cars, std::vector<const Car*>& outCars) const
+	{
+		ForEachInTiles(firstTile, lastTile, [&](size_t i) { outCars.push_back(cars[GetCarIndex(i)]); });
+	}
+
+	/** The tile under the position, clamped into the map */
+	IntVector2D GetClampedTile(const Vector2D& position) const;
+
+private:
+	uint64_t GetTileIndex(const IntVector2D& tile) const { return (static_cast<uint64_t>(tile.y) * m_Track.GetWidth() + tile.x); }
+	static uint64_t MakeKey(uint64_t tileIndex, uint32_t carIndex) { return ((tileIndex << 32) | carIndex); }
+
+private:
+	const ATrack& m_Track;
+	std::vector<uint64_t> m_Entries;
+};
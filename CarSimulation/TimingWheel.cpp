@@ -0,0 +1,119 @@
+#include "TimingWheel.h"
+
+#include <cassert>
+#include <algorithm>
+
+TimingWheel::TimingWheel(uint64_t startTick)
+	: m_CurrentTick(startTick)
+{}
+
+void TimingWheel::Schedule(uint64_t tick, uint32_t id)
+{
+	assert(tick >= m_CurrentTick);
+	assert(((tick - m_CurrentTick) >> (LevelAmount * SlotBits)) == 0);
+
+	uint32_t entryIndex = m_FirstFreeEntryIndex;
+	if (entryIndex != NoEntry)
+		m_FirstFreeEntryIndex = m_Entries[entryIndex].nextEntryIndex;
+	else
+	{
+		entryIndex = static_cast<uint32_t>(m_Entries.size());
+		m_Entries.emplace_back();
+	}
+	m_Entries[entryIndex].tick = tick;
+	m_Entries[entryIndex].id = id;
+	Insert(entryIndex);
+	m_Size++;
+}
+
+bool TimingWheel::PopNextTick(uint64_t untilTick, std::vector<uint32_t>& outIds, uint64_t& outTick)
+{
+	while (m_CurrentTick <= untilTick)
+	{
+		if (m_Size == 0)
+		{
+			// Nothing to cascade, we can go straight to the end
+			m_CurrentTick = untilTick + 1;
+			return (false);
+		}
+
+		Slot& slot = m_Levels[0][GetSlotIndex(m_CurrentTick, 0)];
+		bool hasEntries = (slot.firstEntryIndex != NoEntry);
+		if (hasEntries)
+		{
+			// Dispatch the whole chain, then give it back to the free list at once
+			size_t entriesAmount = 0;
+			for (uint32_t entryIndex = slot.firstEntryIndex; entryIndex != NoEntry; entryIndex = m_Entries[entryIndex].nextEntryIndex)
+			{
+				outIds.push_back(m_Entries[entryIndex].id);
+				entriesAmount++;
+			}
+			m_Entries[slot.lastEntryIndex].nextEntryIndex = m_FirstFreeEntryIndex;
+			m_FirstFreeEntryIndex = slot.firstEntryIndex;
+			slot = Slot();
+
+			m_LevelSizes[0] -= entriesAmount;
+			m_Size -= entriesAmount;
+			outTick = m_CurrentTick;
+		}
+
+		// Go to the next tick, or directly to the start of the next level 1 slot if the level 0 is empty
+		if (hasEntries || m_LevelSizes[0] != 0)
+			m_CurrentTick++;
+		else
+			m_CurrentTick = std::min(((m_CurrentTick >> SlotBits) + 1) << SlotBits, untilTick + 1);
+		if (GetSlotIndex(m_CurrentTick, 0) == 0)
+			Cascade();
+
+		if (hasEntries)
+			return (true);
+	}
+	return (false);
+}
+
+void TimingWheel::Insert(uint32_t entryIndex)
+{
+	Entry& entry = m_Entries[entryIndex];
+	entry.nextEntryIndex = NoEntry;
+
+	// Find the lowest level where the entry share the same upper slot with the current tick
+	for (int level = 0; level < LevelAmount; level++)
+	{
+		int upperShift = (level + 1) * SlotBits;
+		if (level == LevelAmount - 1 || (entry.tick >> upperShift) == (m_CurrentTick >> upperShift))
+		{
+			Slot& slot = m_Levels[level][GetSlotIndex(entry.tick, level)];
+			if (slot.lastEntryIndex == NoEntry)
+				slot.firstEntryIndex = entryIndex;
+			else
+				m_Entries[slot.lastEntryIndex].nextEntryIndex = entryIndex;
+			slot.lastEntryIndex = entryIndex;
+			m_LevelSizes[level]++;
+			return;
+		}
+	}
+}
+
+void TimingWheel::Cascade()
+{
+	// Find the highest level that just reached the start of a slot
+	int highestLevel = 1;
+	while (highestLevel < LevelAmount - 1 && GetSlotIndex(m_CurrentTick, highestLevel) == 0)
+		highestLevel++;
+
+	// Then move its entries down, from the highest level to the lowest (an entry can go down multiple levels at once)
+	for (int level = highestLevel; level >= 1; level--)
+	{
+		// Detach the chain first, its entries never go back to the same slot
+		Slot& slot = m_Levels[level][GetSlotIndex(m_CurrentTick, level)];
+		uint32_t entryIndex = slot.firstEntryIndex;
+		slot = Slot();
+		while (entryIndex != NoEntry)
+		{
+			uint32_t nextEntryIndex = m_Entries[entryIndex].nextEntryIndex;
+			m_LevelSizes[level]--;
+			Insert(entryIndex);
+			entryIndex = nextEntryIndex;
+		}
+	}
+}
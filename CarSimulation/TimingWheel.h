@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <array>
+
+/**
+ * Hierarchical timing wheel, store ids to be dispatched at a given tick.
+ * Each level is a ring of SlotAmount slots, a slot of the level n cover SlotAmount^n ticks.
+ * Scheduling is O(1), and the entries are moved down one level at the time when their slot is reached,
+ * so dispatching cost O(1) per entry and per level, and the empty ticks are skipped a whole slot at the time.
+ */
+class TimingWheel
+{
+
+public:
+	static constexpr int SlotBits = 8;
+	static constexpr int SlotAmount = 1 << SlotBits;
+	static constexpr int LevelAmount = 4;
+
+public:
+	TimingWheel(uint64_t startTick = 0);
+
+public:
+	/** Schedule an id at the given tick (has to be in the future, or the current tick, and less than SlotAmount^LevelAmount ticks away) */
+	void Schedule(uint64_t tick, uint32_t id);
+	/**
+	 * Advance the wheel to the next tick that has something scheduled, without going further than untilTick.
+	 *
+	 * \param untilTick The last tick that can be dispatched.
+	 * \param outIds The ids scheduled at that tick are added to it.
+	 * \param outTick The tick of the dispatched ids.
+	 * \return false if nothing is scheduled until untilTick (the wheel is then at untilTick + 1).
+	 */
+	bool PopNextTick(uint64_t untilTick, std::vector<uint32_t>& outIds, uint64_t& outTick);
+
+	uint64_t GetCurrentTick() const { return (m_CurrentTick); }
+	size_t GetSize() const { return (m_Size); }
+	bool IsEmpty() const { return (m_Size == 0); }
+
+private:
+	static constexpr uint32_t NoEntry = UINT32_MAX;
+
+	/** The entries are chained in their slot, and recycled through the free list instead of being freed */
+	struct Entry
+	{
+		uint64_t tick;
+		uint32_t id;
+		uint32_t nextEntryIndex;
+	};
+	/** Chain of entries in scheduling order (so the ids of a tick are dispatched in the order they were scheduled) */
+	struct Slot
+	{
+		uint32_t firstEntryIndex = NoEntry;
+		uint32_t lastEntryIndex = NoEntry;
+	};
+
+	void Insert(uint32_t entryIndex);
+	/** Move the entries of the higher levels slots that start at the current tick to the lower levels */
+	void Cascade();
+	static int GetSlotIndex(uint64_t tick, int level) { return (static_cast<int>((tick >> (level * SlotBits)) & (SlotAmount - 1))); }
+
+private:
+	std::array<std::array<Slot, SlotAmount>, LevelAmount> m_Levels;
+	std::array<size_t, LevelAmount> m_LevelSizes = {};
+	/**
+	 * Storage of all the entries, used or free.
+	 * It only grow when more entries are scheduled at once than ever before, a vector per slot would allocate
+	 * every time a slot is used for the first time, and the higher levels slots are only reached every few hours of simulation.
+	 */
+	std::vector<Entry> m_Entries;
+	uint32_t m_FirstFreeEntryIndex = NoEntry;
+	size_t m_Size = 0;
+	uint64_t m_CurrentTick;
+};
@@ -1,13 +1,46 @@
 #include "Track.h"
 #include "Car.h"
 
+#include "Random.h"
+
+ATrack::ATrack(std::vector<std::vector<char>>&& map)
+{
+	std::shared_ptr<RuntimeTables> tables = std::make_shared<RuntimeTables>();
+	const int width = static_cast<int>(map[0].size());
+	const int height = static_cast<int>(map.size());
+	tables->tiles.reserve(static_cast<size_t>(width) * height);
+	for (std::vector<char>& row : map)
+	{
+		assert(static_cast<int>(row.size()) == width);
+		tables->tiles.insert(tables->tiles.end(), row.begin(), row.end());
+		// The generated maps are big, only one copy of them at a time
+		std::vector<char>().swap(row);
+	}
+
+	// Same tables as a BakedTrack, computed by the same functions
+	tables->tileFlags.resize(tables->tiles.size());
+	for (size_t i = 0; i < tables->tiles.size(); i++)
+	{
+		const uint8_t flags = ComputeTileFlags(tables->tiles.data(), width, height, static_cast<int>(i % width), static_cast<int>(i / width));
+		tables->tileFlags[i] = flags;
+		if ((flags & TileFlags::Intersection) != 0)
+			tables->intersectionTiles.push_back(static_cast<uint32_t>(i));
+		else if ((flags & TileFlags::Road) != 0)
+			tables->spawnSlots.push_back(static_cast<uint32_t>(i));
+	}
+
+	m_Layout = TrackLayout{ width, height, tables->tiles.data(), tables->tileFlags.data(),
+		tables->spawnSlots.data(), tables->spawnSlots.size(), tables->intersectionTiles.data(), tables->intersectionTiles.size() };
+	m_RuntimeTables = std::move(tables);
+}
+
 void ATrack::CopyTrack(std::vector<std::vector<char>>& outTrack) const
 {
-	for (int y = 0; y < m_Height; y++)
+	for (int y = 0; y < m_Layout.height; y++)
 	{
-		for (int x = 0; x < m_Width; x++)
+		for (int x = 0; x < m_Layout.width; x++)
 		{
-			outTrack[y][x] = m_TrackMap[y][x];
+			outTrack[y][x] = m_Layout.tiles[y * m_Layout.width + x];
 		}
 	}
 }
@@ -20,56 +53,32 @@ IntVector2D ATrack::MapPositionOnTrack(const Vector2D& position) const
 		);
 }
 
-bool ATrack::IsRoad(char c) const
-{
-	if (c == UP || c == UP_RIGHT || c == RIGHT || c == RIGHT_DOWN
-		|| c == DOWN || c == DOWN_LEFT || c == LEFT || c == LEFT_UP || c == INTERSECTION)
-		return (true);
-	return (false);
-}
-
-bool ATrack::IsHereARoad(const IntVector2D& pos) const
+std::vector<Vector2D> ATrack::GetSpawnSlots() const
 {
-	return IsRoad(GetTrackChar(pos));
-}
-
-bool ATrack::IsHereARoad(const Vector2D& pos) const
-{
-	return IsHereARoad(MapPositionOnTrack(pos));
-}
-
-bool ATrack::IsHereInMapBounds(const IntVector2D& pos) const
-{
-	return (pos.x >= 0.0f && pos.x < GetWidth() && pos.y >= 0.0f && pos.y < GetHeight());
+	std::vector<Vector2D> slots;
+	slots.reserve(m_Layout.spawnSlotsAmount);
+	for (size_t i = 0; i < m_Layout.spawnSlotsAmount; i++)
+	{
+		const uint32_t tileIndex = m_Layout.spawnSlots[i];
+		// center the spawn point to the middle of the tile
+		slots.emplace_back(tileIndex % m_Layout.width + 0.5f, tileIndex / m_Layout.width + 0.5f);
+	}
+	return (slots);
 }
 
-char ATrack::GetTrackChar(const IntVector2D& pos) const
+std::vector<Vector2D> ATrack::GetUniqueSpawnPoints(size_t amount, uint64_t seed) const
 {
-	if (IsHereInMapBounds(pos))
-		return (m_TrackMap[pos.y][pos.x]);
-	return (' ');
-}
+	std::vector<Vector2D> slots = GetSpawnSlots();
+	// Not enough room on the track for all the cars
+	assert(amount <= slots.size());
 
-Vector2D ATrack::GetSpawnPoint() const
-{
-	int randX = std::rand() % GetWidth();
-	int randY = std::rand() % GetHeight();
-	Vector2D startPosition = Vector2D(static_cast<float>(randX), static_cast<float>(randY));
-	char trackChar = ' ';
-	while (IsRoad(trackChar) == false || trackChar == INTERSECTION)
+	// Partial Fisher-Yates shuffle, we only need the first 'amount' slots to be random
+	RandomStream random(seed, 0, ERandomPurpose::SpawnPoints);
+	for (size_t i = 0; i < amount; i++)
 	{
-		startPosition.x += 1;
-		if (startPosition.x >= GetWidth())
-		{
-			startPosition.x = 0;
-			startPosition.y += 1;
-			if (startPosition.y >= GetHeight())
-				startPosition.y = 0;
-		}
-		trackChar = GetTrackChar(startPosition);
+		size_t pickedSlot = i + random.Range(static_cast<uint32_t>(slots.size() - i));
+		std::swap(slots[i], slots[pickedSlot]);
 	}
-	// center the spawn point to the middle of the tile
-	startPosition.x += 0.5f;
-	startPosition.y += 0.5f;
-	return (startPosition);
+	slots.resize(amount);
+	return (slots);
 }
\ No newline at end of file
@@ -1,11 +1,17 @@
 #pragma once
 
 #include "Defines.h"
+#include "TrafficLight.h"
+#include "FixedVector2D.h"
+#include "BakedTrack.h"
 
 #include <vector>
 #include <memory>
+#include <span>
+#include <cassert>
 
 class Car;
+class IntersectionManager;
 
 /**
  * Class that contain all the properties / member to manage a track
@@ -15,10 +21,23 @@ class ATrack
 {
 
 public:
-	ATrack(std::vector<std::vector<char>>&& map)
-		: m_TrackMap(std::move(map)), m_Width(m_TrackMap[0].size()), m_Height(m_TrackMap.size())
+	/** A map made at run time (generated or loaded), its tables are computed once here */
+	ATrack(std::vector<std::vector<char>>&& map);
+	/** A built-in map, nothing is copied or computed (see BakedTrack, it have to stay alive as long as the track) */
+	template<int Width, int Height>
+	ATrack(const BakedTrack<Width, Height>& bakedTrack)
+		: m_Layout(bakedTrack.GetLayout())
 	{}
 
+	/** Create a new track on the same map (shared, not copied) without any car, with its own lights and without intersection manager, for an independent simulation */
+	ATrack CreateEmptyCopy() const
+	{
+		ATrack copy = *this;
+		copy.m_CarsRegisterOnTrack.clear();
+		copy.m_IntersectionManager = nullptr;
+		return (copy);
+	}
+
 public:
 	/**
 	 * Copy the track into the 2d vector given in argument.
@@ -27,35 +46,92 @@ public:
 	void CopyTrack(std::vector<std::vector<char>>& outTrack) const;
 	/* Convert a position to a position of a tile in the track map*/
 	IntVector2D MapPositionOnTrack(const Vector2D& position) const;
+	IntVector2D MapPositionOnTrack(const FixedVector2D& position) const { return (position.GetTile()); }
 	/* return whether or not the giver char is a road */
-	bool IsRoad(char c) const;
+	static constexpr bool IsRoad(char c) { return IsRoadChar(c); }
 	/* return whether or not the given position is a road */
-	bool IsHereARoad(const IntVector2D& pos) const;
-	bool IsHereARoad(const Vector2D& pos) const;
+	bool IsHereARoad(const IntVector2D& pos) const { return ((GetTileFlags(pos) & TileFlags::Road) != 0); }
+	bool IsHereARoad(const Vector2D& pos) const { return IsHereARoad(MapPositionOnTrack(pos)); }
 	/* return whether or not the given position is out of track map bounds */
-	bool IsHereInMapBounds(const IntVector2D& pos) const;
-	Vector2D GetMapCenter() const { return Vector2D(m_Width / 2 + 0.5f, m_Height / 2 + 0.5f); }
+	bool IsHereInMapBounds(const IntVector2D& pos) const { return (pos.x >= 0 && pos.x < m_Layout.width && pos.y >= 0 && pos.y < m_Layout.height); }
+	Vector2D GetMapCenter() const { return Vector2D(m_Layout.width / 2 + 0.5f, m_Layout.height / 2 + 0.5f); }
 
 public:
-	int GetWidth() const { return m_Width; }
-	int GetHeight() const { return m_Height; }
-	/* return the track char at the given position, or '\0' if out of bound */
-	char GetTrackChar(const IntVector2D& pos) const;
+	int GetWidth() const { return m_Layout.width; }
+	int GetHeight() const { return m_Layout.height; }
+	/* return the track char at the given position, or ' ' if out of bound */
+	char GetTrackChar(const IntVector2D& pos) const
+	{
+		if (IsHereInMapBounds(pos))
+			return (m_Layout.tiles[pos.y * m_Layout.width + pos.x]);
+		return (' ');
+	}
+	/* return the TileFlags of the given position, or 0 if out of bound */
+	uint8_t GetTileFlags(const IntVector2D& pos) const
+	{
+		if (IsHereInMapBounds(pos))
+			return (m_Layout.tileFlags[pos.y * m_Layout.width + pos.x]);
+		return (0);
+	}
+	/* Index (y * width + x) of every intersection tile, in the map order */
+	std::span<const uint32_t> GetIntersectionTiles() const { return std::span<const uint32_t>(m_Layout.intersectionTiles, m_Layout.intersectionTilesAmount); }
 	/* Return all the cars that has been register has driving onto the track */
-	const std::vector<std::weak_ptr<Car>> GetCarsOnTrack() const { return m_CarsRegisterOnTrack; }
-	/** Get a random Spawn point, if the point is not a road we look for the next road, once the track find we add 0.5 to x and y to center the spawn point onto the tile */
-	Vector2D GetSpawnPoint() const;
+	const std::vector<const Car*>& GetCarsOnTrack() const { return m_CarsRegisterOnTrack; }
+	/**
+	 * Get every position where a car can spawn: the center of each road tile except the intersections.
+	 * One slot per tile, so cars spawned on different slots never overlap (read from the spawn slots table, the map is not scanned).
+	 */
+	std::vector<Vector2D> GetSpawnSlots() const;
+	/**
+	 * Pick unique random spawn points for a whole fleet at once.
+	 * The slots are enumerated once then partially shuffled, so it cost O(tiles + amount) instead of probing for each car.
+	 *
+	 * \param amount The amount of spawn points wanted (must not be greater than the amount of spawn slots)
+	 * \param seed The simulation seed, the same seed always give the same spawn points
+	 * \return The spawn points, all different
+	 */
+	std::vector<Vector2D> GetUniqueSpawnPoints(size_t amount, uint64_t seed) const;
 
-	void RegisterNewCarOnTrack(std::weak_ptr<Car> car) { m_CarsRegisterOnTrack.push_back(car); }
+	/* The track does not own the car, it have to stay alive as long as the track is simulated */
+	void RegisterNewCarOnTrack(const Car* car) { m_CarsRegisterOnTrack.push_back(car); }
 
-protected:
-	/** The track itself, made of char that represent in which direction the car should go */
-	const std::vector<std::vector<char>> m_TrackMap;
-	/** All the cars registered has driving on this track */
-	std::vector<std::weak_ptr<Car>> m_CarsRegisterOnTrack;
+	/* The traffic lights of all the intersections of the track */
+	const TrafficLight& GetTrafficLight() const { return m_TrafficLight; }
+	TrafficLight& GetTrafficLight() { return m_TrafficLight; }
+	/**
+	 * The reservations of the intersections, the cars ask it instead of looking at the lights when there is one (see IntersectionManager).
+	 * The track does not own it, it have to stay alive as long as the track is simulated.
+	 */
+	IntersectionManager* GetIntersectionManager() const { return m_IntersectionManager; }
+	void SetIntersectionManager(IntersectionManager* intersectionManager) { m_IntersectionManager = intersectionManager; }
+
+private:
+	/** The tiles and tables of a map made at run time, same content as a BakedTrack */
+	struct RuntimeTables
+	{
+		std::vector<char> tiles;
+		std::vector<uint8_t> tileFlags;
+		std::vector<uint32_t> spawnSlots;
+		std::vector<uint32_t> intersectionTiles;
+	};
 
-	int m_Width;
-	int m_Height;
+protected:
+	/**
+	 * The track itself, made of char that represent in which direction the car should go, and its tables.
+	 * Never modified, so the copies of the track share it.
+	 */
+	TrackLayout m_Layout;
+	/** Own what m_Layout point to for the maps made at run time, nullptr for the baked ones */
+	std::shared_ptr<const RuntimeTables> m_RuntimeTables;
+	/**
+	 * All the cars registered has driving on this track.
+	 * Raw pointers: locking a weak_ptr touch the shared reference counts, and every thread scanning the cars would fight over them.
+	 */
+	std::vector<const Car*> m_CarsRegisterOnTrack;
+	/** The lights of the intersections, they're all sync so one is enough */
+	TrafficLight m_TrafficLight;
+	/** nullptr when the cars follow the lights */
+	IntersectionManager* m_IntersectionManager = nullptr;
 };
 
 // Create 3 char long alias for the direction char macro (easier to use)
@@ -75,24 +151,28 @@ protected:
 class FigureEightTrack : public ATrack
 {
 
+public:
+	/** The map and its tables, built when the program is compiled */
+	static constexpr BakedTrack<29, 14> Map = BakedTrack<29, 14>({
+		{ ' ', ' ', ' ', ' ', ' ', _R_, _R_, _R_, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _L_, _L_, _L_, ' ', ' ', ' ', ' ', ' ' },
+		{ ' ', ' ', ' ', ' ', _UR, _R_, _R_, _R_, _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _DL, _L_, _L_, _L_, _LU, ' ', ' ', ' ', ' ' },
+		{ ' ', ' ', ' ', _UR, _UR, ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', ' ', _LU, _LU, ' ', ' ', ' ' },
+		{ ' ', ' ', _UR, _UR, ' ', ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU, ' ', ' ' },
+		{ ' ', _UR, _UR, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU, ' ' },
+		{ _UR, _UR, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU },
+		{ _U_, _U_, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _X_, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _U_, _U_ },
+		{ _U_, _U_, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _X_, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _U_, _U_ },
+		{ _U_, _U_, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _U_, _U_ },
+		{ ' ', _LU, _LU, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _UR, _UR, ' ' },
+		{ ' ', ' ', _LU, _LU, ' ', ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', _UR, _UR, ' ', ' ' },
+		{ ' ', ' ', ' ', _LU, _LU, ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', _UR, _UR, ' ', ' ', ' ' },
+		{ ' ', ' ', ' ', ' ', _LU, _LU, _L_, _L_, _L_, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _R_, _R_, _R_, _UR, _UR, ' ', ' ', ' ', ' ' },
+		{ ' ', ' ', ' ', ' ', ' ', _LU, _L_, _L_, _L_, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _R_, _R_, _R_, _UR, ' ', ' ', ' ', ' ', ' ' }
+	});
+
 public:
 	FigureEightTrack()
-		: ATrack({
-			{ ' ', ' ', ' ', ' ', ' ', _R_, _R_, _R_, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _L_, _L_, _L_, ' ', ' ', ' ', ' ', ' ' },
-			{ ' ', ' ', ' ', ' ', _UR, _R_, _R_, _R_, _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _DL, _L_, _L_, _L_, _LU, ' ', ' ', ' ', ' ' },
-			{ ' ', ' ', ' ', _UR, _UR, ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', ' ', _LU, _LU, ' ', ' ', ' ' },
-			{ ' ', ' ', _UR, _UR, ' ', ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU, ' ', ' ' },
-			{ ' ', _UR, _UR, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU, ' ' },
-			{ _UR, _UR, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU },
-			{ _U_, _U_, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _X_, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _U_, _U_ },
-			{ _U_, _U_, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _X_, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _U_, _U_ },
-			{ _U_, _U_, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _U_, _U_ },
-			{ ' ', _LU, _LU, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _UR, _UR, ' ' },
-			{ ' ', ' ', _LU, _LU, ' ', ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', _UR, _UR, ' ', ' ' },
-			{ ' ', ' ', ' ', _LU, _LU, ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', _UR, _UR, ' ', ' ', ' ' },
-			{ ' ', ' ', ' ', ' ', _LU, _LU, _L_, _L_, _L_, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _R_, _R_, _R_, _UR, _UR, ' ', ' ', ' ', ' ' },
-			{ ' ', ' ', ' ', ' ', ' ', _LU, _L_, _L_, _L_, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _R_, _R_, _R_, _UR, ' ', ' ', ' ', ' ', ' ' }
-		})
+		: ATrack(Map)
 	{}
 };
 
@@ -102,27 +182,38 @@ public:
 class MultiIntersectionTrack : public ATrack
 {
 
+public:
+	/** The map and its tables, built when the program is compiled */
+	static constexpr BakedTrack<29, 14> Map = BakedTrack<29, 14>({
+		{ ' ', ' ', ' ', _DL, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, ' ', ' ', ' ', ' ', ' ', ' '},
+		{ ' ', ' ', _DL, _DL, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _LU, ' ', ' ', ' ', ' ', ' '},
+		{ ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU, ' ', ' ', ' ', ' '},
+		{ _D_, _D_, ' ', ' ', _DL, _L_, _L_, ' ', ' ', ' ', ' ', _R_, _RD, ' ', ' ', ' ', ' ', ' ', _DL, _L_, _L_, _L_, ' ', ' ', _LU, _LU, ' ', ' ', ' '},
+		{ _D_, _D_, ' ', _D_, _D_, _L_, _L_, _LU, ' ', ' ', _UR, _R_, _RD, _RD, ' ', ' ', ' ', _DL, _DL, _L_, _L_, _L_, _LU, ' ', ' ', _LU, _LU, ' ', ' '},
+		{ _D_, _D_, ' ', _D_, _D_, ' ', _U_, _U_, ' ', _UR, _UR, ' ', ' ', _RD, _RD, ' ', _DL, _DL, ' ', ' ', ' ', ' ', _LU, _LU, ' ', ' ', _LU, _LU, ' '},
+		{ _D_, _D_, ' ', _RD, _R_, _R_, _X_, _X_, _UR, _UR, ' ', ' ', ' ', ' ', _RD, _X_, _DL, ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU, ' ', ' ', _LU, _LU },
+		{ _D_, _D_, ' ', ' ', _R_, _R_, _X_, _X_, _UR, ' ', ' ', ' ', ' ', ' ', _DL, _X_, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU, ' ', _U_, _U_ },
+		{ _D_, _D_, ' ', ' ', ' ', ' ', _U_, _U_, ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', _U_, _U_, ' ', _U_, _U_},
+		{ _D_, _D_, ' ', ' ', ' ', ' ', _U_, _U_, ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', _RD, _R_, _R_, _R_, _R_, _R_, _R_, _U_, _U_, ' ', _U_, _U_},
+		{ _RD, _RD, ' ', ' ', ' ', _UR, _UR, ' ', ' ', ' ', ' ', _D_, _D_, ' ', ' ', ' ', ' ', ' ', _R_, _R_, _R_, _R_, _R_, _R_, _UR, ' ', ' ', _U_, _U_},
+		{ ' ', _RD, _R_, _R_, _UR, _UR, ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _UR, _UR, ' '},
+		{ ' ', ' ', _R_, _R_, _UR, ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _UR, _UR, ' ', ' '},
+		{ ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _UR, ' ', ' ', ' '}
+	});
+
 public:
 	MultiIntersectionTrack()
-		: ATrack({
-			{ ' ', ' ', ' ', _DL, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, ' ', ' ', ' ', ' ', ' ', ' '},
-			{ ' ', ' ', _DL, _DL, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _L_, _LU, ' ', ' ', ' ', ' ', ' '},
-			{ ' ', _DL, _DL, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU, ' ', ' ', ' ', ' '},
-			{ _D_, _D_, ' ', ' ', _DL, _L_, _L_, ' ', ' ', ' ', ' ', _R_, _RD, ' ', ' ', ' ', ' ', ' ', _DL, _L_, _L_, _L_, ' ', ' ', _LU, _LU, ' ', ' ', ' '},
-			{ _D_, _D_, ' ', _D_, _D_, _L_, _L_, _LU, ' ', ' ', _UR, _R_, _RD, _RD, ' ', ' ', ' ', _DL, _DL, _L_, _L_, _L_, _LU, ' ', ' ', _LU, _LU, ' ', ' '},
-			{ _D_, _D_, ' ', _D_, _D_, ' ', _U_, _U_, ' ', _UR, _UR, ' ', ' ', _RD, _RD, ' ', _DL, _DL, ' ', ' ', ' ', ' ', _LU, _LU, ' ', ' ', _LU, _LU, ' '},
-			{ _D_, _D_, ' ', _RD, _R_, _R_, _X_, _X_, _UR, _UR, ' ', ' ', ' ', ' ', _RD, _X_, _DL, ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU, ' ', ' ', _LU, _LU },
-			{ _D_, _D_, ' ', ' ', _R_, _R_, _X_, _X_, _UR, ' ', ' ', ' ', ' ', ' ', _DL, _X_, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', _LU, _LU, ' ', _U_, _U_ },
-			{ _D_, _D_, ' ', ' ', ' ', ' ', _U_, _U_, ' ', ' ', ' ', ' ', ' ', _DL, _DL, ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', _U_, _U_, ' ', _U_, _U_},
-			{ _D_, _D_, ' ', ' ', ' ', ' ', _U_, _U_, ' ', ' ', ' ', ' ', _DL, _DL, ' ', ' ', ' ', _RD, _R_, _R_, _R_, _R_, _R_, _R_, _U_, _U_, ' ', _U_, _U_},
-			{ _RD, _RD, ' ', ' ', ' ', _UR, _UR, ' ', ' ', ' ', ' ', _D_, _D_, ' ', ' ', ' ', ' ', ' ', _R_, _R_, _R_, _R_, _R_, _R_, _UR, ' ', ' ', _U_, _U_},
-			{ ' ', _RD, _R_, _R_, _UR, _UR, ' ', ' ', ' ', ' ', ' ', _RD, _RD, ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _UR, _UR, ' '},
-			{ ' ', ' ', _R_, _R_, _UR, ' ', ' ', ' ', ' ', ' ', ' ', ' ', _RD, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _UR, _UR, ' ', ' '},
-			{ ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', ' ', _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _R_, _UR, ' ', ' ', ' '}
-		})
+		: ATrack(Map)
 	{}
 };
 
+// The built-in maps are known by the compiler, so is the room they have for the cars
+#if SELECTED_MAP == 0
+static_assert(FigureEightTrack::Map.GetSpawnSlotsAmount() >= CARS_AMOUNT, "Not enough room on the figure eight track for all the cars");
+#elif SELECTED_MAP == 1
+static_assert(MultiIntersectionTrack::Map.GetSpawnSlotsAmount() >= CARS_AMOUNT, "Not enough room on the custom track for all the cars");
+#endif
+
 // Undef the macros aliases
 #undef _U_
 #undef _UR
@@ -0,0 +1,142 @@
+#include "TrackGenerator.h"
+#include "Track.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+	char GetOppositeDirectionChar(char directionChar)
+	{
+		switch (directionChar)
+		{
+		case UP: return DOWN;
+		case UP_RIGHT: return DOWN_LEFT;
+		case RIGHT: return LEFT;
+		case RIGHT_DOWN: return LEFT_UP;
+		case DOWN: return UP;
+		case DOWN_LEFT: return UP_RIGHT;
+		case LEFT: return RIGHT;
+		case LEFT_UP: return RIGHT_DOWN;
+		}
+		return (CENTER);
+	}
+}
+
+TrackGenerator::TrackMap TrackGenerator::CreateTiledFigureEights(int width, int height, int gap)
+{
+	const ATrack figureEight = FigureEightTrack();
+	assert(gap >= 1);
+	assert(width >= figureEight.GetWidth() && height >= figureEight.GetHeight());
+
+	TrackMap figureEightMap(figureEight.GetHeight(), std::vector<char>(figureEight.GetWidth()));
+	figureEight.CopyTrack(figureEightMap);
+
+	TrackMap map = CreateEmptyMap(width, height);
+	for (int top = 0; top + figureEight.GetHeight() <= height; top += figureEight.GetHeight() + gap)
+		for (int left = 0; left + figureEight.GetWidth() <= width; left += figureEight.GetWidth() + gap)
+			for (int y = 0; y < figureEight.GetHeight(); y++)
+				std::copy(figureEightMap[y].begin(), figureEightMap[y].end(), map[top + y].begin() + left);
+	assert(IsValid(map));
+	return (map);
+}
+
+TrackGenerator::TrackMap TrackGenerator::CreateManhattanGrid(int width, int height, int blockSize, int cornerSize)
+{
+	assert(cornerSize >= 0 && blockSize >= 4 + cornerSize);
+	assert(width >= 3 * blockSize + 1 && height >= 3 * blockSize + 1);
+	TrackMap map = CreateEmptyMap(width, height);
+
+	// One empty tile around the map, the loops are closed in the first 'blockSize' tiles of each side
+	// (horizontal streets on the left and right, vertical ones on the top and bottom) so they never cross there
+	const int border = 1;
+	for (int top = blockSize; top + 2 * blockSize <= height - 1; top += 2 * blockSize)
+		DrawLoop(map, IntVector2D(border, top), IntVector2D(width - 1 - border, top + blockSize), cornerSize, true);
+	for (int left = blockSize; left + 2 * blockSize <= width - 1; left += 2 * blockSize)
+		DrawLoop(map, IntVector2D(left, border), IntVector2D(left + blockSize, height - 1 - border), cornerSize, true);
+	assert(IsValid(map));
+	return (map);
+}
+
+TrackGenerator::TrackMap TrackGenerator::CreateRingRoads(int width, int height, int ringsSpacing)
+{
+	assert(ringsSpacing >= 3);
+	TrackMap map = CreateEmptyMap(width, height);
+
+	const IntVector2D center(width / 2, height / 2);
+	IntVector2D halfSize(width / 2 - 2, height / 2 - 2);
+	for (bool isClockwise = true; halfSize.x >= 3 && halfSize.y >= 3; isClockwise = !isClockwise)
+	{
+		// The corners of a regular octagon are cut at ~29% of its size, so every side is at the same distance from the center
+		const int cornerSize = std::max(1, std::min(halfSize.x, halfSize.y) * 2 * 29 / 100);
+		DrawLoop(map, center - halfSize, center + halfSize, cornerSize, isClockwise);
+		halfSize -= IntVector2D(ringsSpacing);
+	}
+	assert(IsValid(map));
+	return (map);
+}
+
+bool TrackGenerator::IsValid(const TrackMap& map)
+{
+	for (int y = 0; y < static_cast<int>(map.size()); y++)
+	{
+		for (int x = 0; x < static_cast<int>(map[y].size()); x++)
+		{
+			const char trackChar = map[y][x];
+			if (trackChar == CENTER || trackChar == INTERSECTION)
+				continue;
+			const IntVector2D nextPosition = IntVector2D(x, y) + GetDirectionVector(trackChar);
+			if (nextPosition.x < 0 || nextPosition.y < 0 || nextPosition.y >= static_cast<int>(map.size()) || nextPosition.x >= static_cast<int>(map[nextPosition.y].size())
+				|| map[nextPosition.y][nextPosition.x] == CENTER)
+				return (false);
+		}
+	}
+	return (true);
+}
+
+TrackGenerator::TrackMap TrackGenerator::CreateEmptyMap(int width, int height)
+{
+	assert(width > 0 && width <= MaxSize && height > 0 && height <= MaxSize);
+	return (TrackMap(height, std::vector<char>(width, CENTER)));
+}
+
+void TrackGenerator::DrawLoop(TrackMap& map, const IntVector2D& topLeft, const IntVector2D& bottomRight, int cornerSize, bool isClockwise)
+{
+	DrawLane(map, topLeft, bottomRight, cornerSize, isClockwise);
+	DrawLane(map, topLeft + IntVector2D(1), bottomRight - IntVector2D(1), std::max(0, cornerSize - 1), isClockwise);
+}
+
+void TrackGenerator::DrawLane(TrackMap& map, const IntVector2D& topLeft, const IntVector2D& bottomRight, int cornerSize, bool isClockwise)
+{
+	const int straightWidth = bottomRight.x - topLeft.x - 2 * cornerSize;
+	const int straightHeight = bottomRight.y - topLeft.y - 2 * cornerSize;
+	assert(straightWidth > 0 && straightHeight > 0);
+
+	// Walk around clockwise from the top left, each tile point to the next one
+	// (counterclockwise each tile point to the previous one instead)
+	const struct { char directionChar; int length; } segments[] = {
+		{ RIGHT, straightWidth }, { RIGHT_DOWN, cornerSize }, { DOWN, straightHeight }, { DOWN_LEFT, cornerSize },
+		{ LEFT, straightWidth }, { LEFT_UP, cornerSize }, { UP, straightHeight }, { UP_RIGHT, cornerSize }
+	};
+	IntVector2D position(topLeft.x + cornerSize, topLeft.y);
+	for (const auto& segment : segments)
+	{
+		const IntVector2D step = GetDirectionVector(segment.directionChar);
+		for (int i = 0; i < segment.length; i++)
+		{
+			if (isClockwise)
+				SetRoadTile(map, position, segment.directionChar);
+			else
+				SetRoadTile(map, position + step, GetOppositeDirectionChar(segment.directionChar));
+			position += step;
+		}
+	}
+	assert(position == IntVector2D(topLeft.x + cornerSize, topLeft.y));
+}
+
+void TrackGenerator::SetRoadTile(TrackMap& map, const IntVector2D& position, char directionChar)
+{
+	assert(position.x >= 0 && position.y >= 0 && position.y < static_cast<int>(map.size()) && position.x < static_cast<int>(map[position.y].size()));
+	char& tile = map[position.y][position.x];
+	tile = (tile == CENTER ? directionChar : INTERSECTION);
+}
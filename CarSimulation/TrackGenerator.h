@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Defines.h"
+
+#include <vector>
+
+/**
+ * Build large maps from a few parameters, to see how the simulation scale (the hand made tracks are only 29x14).
+ * The result is a regular map of direction chars, given as is to the ATrack constructor:
+ *     ATrack track(TrackGenerator::CreateManhattanGrid(1000, 1000));
+ * Every road is a closed loop of two lanes (so the cars can change lane) and the roads only cross at a right angle,
+ * where the crossing tiles become INTERSECTION (the lights only handle 2 perpendicular flows).
+ */
+class TrackGenerator
+{
+
+public:
+	using TrackMap = std::vector<std::vector<char>>;
+
+	/** The biggest map that can be generated, in tiles on each side */
+	static constexpr int MaxSize = 10000;
+
+public:
+	/**
+	 * As many copies of the figure eight track as fit in the map, side by side, each copy is an independent circuit.
+	 *
+	 * \param gap The amount of empty tiles between the copies (at least 1, or the lanes of 2 copies would touch)
+	 */
+	static TrackMap CreateTiledFigureEights(int width, int height, int gap = 1);
+	/**
+	 * A grid of one way streets of 2 lanes, every 'blockSize' tiles, with an intersection at each crossing.
+	 * The streets go in pairs: a street going right and the next one going left are one loop,
+	 * closed on the left and right sides of the map, the same for the vertical streets on the top and bottom sides.
+	 *
+	 * \param blockSize The distance between 2 parallel streets (at least 4 + cornerSize)
+	 * \param cornerSize The length of the diagonal that cut the corners of the loops (0 for square corners)
+	 */
+	static TrackMap CreateManhattanGrid(int width, int height, int blockSize = 8, int cornerSize = 2);
+	/**
+	 * Concentric ring roads of 2 lanes around the center of the map, each ring going the other way than the previous one.
+	 * The rings are octagons (the cars only know 8 directions), close to circles.
+	 *
+	 * \param ringsSpacing The distance between 2 rings (at least 3, or the lanes of 2 rings would touch)
+	 */
+	static TrackMap CreateRingRoads(int width, int height, int ringsSpacing = 6);
+
+	/**
+	 * Check that every direction tile lead to another road tile, so no car can drive out of the road.
+	 * It read the whole map, the generators only call it in debug.
+	 */
+	static bool IsValid(const TrackMap& map);
+
+private:
+	static TrackMap CreateEmptyMap(int width, int height);
+	/**
+	 * Draw a loop of 2 lanes, the outer lane follow the rectangle and its corners are cut by a diagonal of cornerSize tiles,
+	 * the inner lane is one tile inside (with a one tile shorter diagonal, so the diagonal lanes stay side by side).
+	 */
+	static void DrawLoop(TrackMap& map, const IntVector2D& topLeft, const IntVector2D& bottomRight, int cornerSize, bool isClockwise);
+	/** Draw one lane going around the rectangle, each tile pointing to the next one */
+	static void DrawLane(TrackMap& map, const IntVector2D& topLeft, const IntVector2D& bottomRight, int cornerSize, bool isClockwise);
+	/** Set a road tile, if there is already a road there it's a crossing and the tile become an intersection */
+	static void SetRoadTile(TrackMap& map, const IntVector2D& position, char directionChar);
+};
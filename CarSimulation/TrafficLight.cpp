@@ -0,0 +1,35 @@
+#include "TrafficLight.h"
+
+#include <cmath>
+#include <cassert>
+
+double TrafficLight::GetNextPhaseTime(double seconds) const
+{
+	return ((std::floor(seconds / m_PhaseDurationInSecond) + 1.0) * m_PhaseDurationInSecond);
+}
+
+double TrafficLight::GetNextGreenTime(char trackDirectionChar, double seconds) const
+{
+	int currentPhase = GetPhaseAt(seconds);
+	int greenPhase = GetModuloIndex(trackDirectionChar);
+	if (currentPhase == greenPhase)
+		return (seconds);
+
+	int phasesToWait = (greenPhase - currentPhase + PhaseAmount) % PhaseAmount;
+	return (GetNextPhaseTime(seconds) + (phasesToWait - 1) * m_PhaseDurationInSecond);
+}
+
+int TrafficLight::GetModuloIndex(char trackDirectionChar)
+{
+	if (trackDirectionChar == RIGHT_DOWN || trackDirectionChar == LEFT_UP)
+		return 0;
+	else if (trackDirectionChar == UP_RIGHT || trackDirectionChar == DOWN_LEFT)
+		return 2;
+	else if (trackDirectionChar == RIGHT || trackDirectionChar == LEFT)
+		return 0;
+	else if (trackDirectionChar == UP || trackDirectionChar == DOWN)
+		return 2;
+
+	assert(false);
+	return 0;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Defines.h"
+
+#include <cstdint>
+#include <atomic>
+
+/**
+ * The traffic lights of a track.
+ * All the intersections on the map are sync and they only work on 4 way intersections (2 input, 2 output),
+ * either on diagonal or normal (no mix).
+ * The lights cycle through PhaseAmount phases, a direction is green only during the phase matching its modulo index,
+ * the other phases are red for it.
+ * The lights do not read any clock, whoever drive the simulation set their time (so it can be the wall clock or a simulated time).
+ */
+class TrafficLight
+{
+
+public:
+	static constexpr int PhaseAmount = 4;
+	static constexpr double DefaultPhaseDurationInSecond = 5.0;
+
+public:
+	TrafficLight() = default;
+	TrafficLight(const TrafficLight& other) : m_TimeInSecond(other.GetTime()), m_PhaseDurationInSecond(other.m_PhaseDurationInSecond) {}
+
+public:
+	/** Set the time of the lights, in second since the start of the simulation (can be called from any thread) */
+	void SetTime(double seconds) { m_TimeInSecond.store(seconds, std::memory_order_relaxed); }
+	double GetTime() const { return (m_TimeInSecond.load(std::memory_order_relaxed)); }
+	/** Change how long each phase last (only before the simulation start, it's not thread safe) */
+	void SetPhaseDuration(double seconds) { m_PhaseDurationInSecond = seconds; }
+	double GetPhaseDuration() const { return (m_PhaseDurationInSecond); }
+
+	/** Get the current phase of all the lights (between 0 -> PhaseAmount - 1) */
+	int GetCurrentPhase() const { return (GetPhaseAt(GetTime())); }
+	/**
+	 * Return whether or not the traffic light is green for you base on where you should go.
+	 *
+	 * \param trackDirectionChar the direction char that tell you where to go.
+	 * \return true if it's green (and you can continue), false if it's red (and you have to stop)
+	 */
+	bool IsGreenFor(char trackDirectionChar) const { return (GetCurrentPhase() == GetModuloIndex(trackDirectionChar)); }
+
+public:
+	int GetPhaseAt(double seconds) const { return (static_cast<int>(static_cast<uint64_t>(seconds / m_PhaseDurationInSecond) % PhaseAmount)); }
+	/** Get the time at which the next phase start */
+	double GetNextPhaseTime(double seconds) const;
+	/** Get the time at which the light turn green for the given direction (the given time if it's already green) */
+	double GetNextGreenTime(char trackDirectionChar, double seconds) const;
+	/**
+	 * Get the phase during which the light is green for the given direction.
+	 * note that the index are either 0 or 2 that's because we want a delay to allow the car to go through before allowing the other car to go through
+	 *
+	 * \param trackDirectionChar the direction char that tell you where to go.
+	 */
+	static int GetModuloIndex(char trackDirectionChar);
+
+private:
+	std::atomic<double> m_TimeInSecond = { 0.0 };
+	double m_PhaseDurationInSecond = DefaultPhaseDurationInSecond;
+};
@@ -0,0 +1,203 @@
+#include "TrafficStatistics.h"
+
+#include <algorithm>
+#include <iomanip>
+
+TrafficCounters::TrafficCounters()
+	: speeds(0.0f, CAR_MAX_MAXSPEED)
+{}
+
+void TrafficCounters::Merge(const TrafficCounters& other)
+{
+	carTicksAmount += other.carTicksAmount;
+	speedSum += other.speedSum;
+	speeds.Merge(other.speeds);
+	stopsAmount += other.stopsAmount;
+	redLightTicksAmount += other.redLightTicksAmount;
+	laneChangesAmount += other.laneChangesAmount;
+	jamsAmount += other.jamsAmount;
+	jamTicksSum += other.jamTicksSum;
+	longestJamTicks = std::max(longestJamTicks, other.longestJamTicks);
+	enteredIntersections.insert(enteredIntersections.end(), other.enteredIntersections.begin(), other.enteredIntersections.end());
+}
+
+void TrafficCounters::Reset()
+{
+	carTicksAmount = 0;
+	speedSum = 0.0;
+	speeds.Reset();
+	stopsAmount = 0;
+	redLightTicksAmount = 0;
+	laneChangesAmount = 0;
+	jamsAmount = 0;
+	jamTicksSum = 0;
+	longestJamTicks = 0;
+	enteredIntersections.clear();
+}
+
+TrafficStatistics::TrafficStatistics(const ATrack& track, size_t carsAmount, size_t threadsAmount)
+	: m_Track(track),
+	m_Intersections(track),
+	m_IntersectionsAmount(m_Intersections.GetIntersectionsAmount()),
+	m_Cars(carsAmount),
+	m_ThreadCounters(std::max<size_t>(1, threadsAmount)),
+	m_TotalIntersectionsEntries(m_IntersectionsAmount, 0)
+{
+	static_assert(ReportTicks > 0, "The report duration have to be longer than a tick");
+}
+
+void TrafficStatistics::RecordCar(const Car& car, size_t threadIndex)
+{
+	assert(car.GetId() < m_Cars.size() && threadIndex < m_ThreadCounters.size());
+	TrafficCounters& counters = m_ThreadCounters[threadIndex].counters;
+	CarTracking& tracking = m_Cars[car.GetId()];
+
+	// Read the published state once, the car may be moved by another thread in the thread per car mode
+	const CarKinematicState state = car.GetState();
+	counters.carTicksAmount++;
+	counters.speedSum += state.speed;
+	counters.speeds.Add(state.speed);
+
+	const bool isStopped = (state.speed == 0.0f);
+	if (isStopped && tracking.isStopped == false)
+		counters.stopsAmount++;
+	tracking.isStopped = isStopped;
+
+	if (state.lastMoveResult == EMoveResult::StoppedAtRedLight || state.lastMoveResult == EMoveResult::WaitingForReservation)
+		counters.redLightTicksAmount++;
+
+	counters.laneChangesAmount += state.laneChangesAmount - tracking.laneChangesAmount;
+	tracking.laneChangesAmount = state.laneChangesAmount;
+
+	if (isStopped && state.lastMoveResult == EMoveResult::BlockedByCar)
+		tracking.jamTicks++;
+	else if (tracking.jamTicks > 0)
+	{
+		counters.jamsAmount++;
+		counters.jamTicksSum += tracking.jamTicks;
+		counters.longestJamTicks = std::max<uint64_t>(counters.longestJamTicks, tracking.jamTicks);
+		tracking.jamTicks = 0;
+	}
+
+	const int intersectionIndex = m_Intersections.FindIntersection(m_Track.MapPositionOnTrack(state.position));
+	if (intersectionIndex != -1 && intersectionIndex != tracking.intersectionIndex)
+		counters.enteredIntersections.push_back(static_cast<uint32_t>(intersectionIndex));
+	tracking.intersectionIndex = intersectionIndex;
+}
+
+void TrafficStatistics::RecordCars(const std::vector<Car*>& cars)
+{
+	for (const Car* car : cars)
+		RecordCar(*car, 0);
+}
+
+bool TrafficStatistics::EndTick()
+{
+	for (ThreadCounters& threadCounters : m_ThreadCounters)
+	{
+		m_Period.Merge(threadCounters.counters);
+		threadCounters.counters.Reset();
+	}
+
+	m_TicksAmount++;
+	if (m_TicksAmount % ReportTicks != 0)
+		return (false);
+
+	// The entries are only counted per intersection here, the period keep its list for the next period
+	CountIntersectionsEntries(m_Period.enteredIntersections);
+	m_Period.enteredIntersections.clear();
+	m_LastPeriod = m_Period;
+	m_Total.Merge(m_Period);
+	m_Period.Reset();
+	m_HasReport = true;
+	return (true);
+}
+
+void TrafficStatistics::CountIntersectionsEntries(std::vector<uint32_t>& enteredIntersections)
+{
+	// The intersections entered during the period, with their amount of entries
+	std::sort(enteredIntersections.begin(), enteredIntersections.end());
+	m_LastPeriodBusiestIntersections.clear();
+	for (size_t first = 0; first < enteredIntersections.size();)
+	{
+		size_t last = first + 1;
+		while (last < enteredIntersections.size() && enteredIntersections[last] == enteredIntersections[first])
+			last++;
+		m_LastPeriodBusiestIntersections.push_back({ enteredIntersections[first], last - first });
+		m_TotalIntersectionsEntries[enteredIntersections[first]] += last - first;
+		first = last;
+	}
+
+	// Only the intersections entered during the period got busier, the others can't overtake the previous busiest ones
+	const size_t previousBusiestAmount = m_TotalBusiestIntersections.size();
+	for (const IntersectionEntries& entries : m_LastPeriodBusiestIntersections)
+	{
+		const auto isSameIntersection = [&](const IntersectionEntries& other) { return (other.intersectionIndex == entries.intersectionIndex); };
+		if (std::none_of(m_TotalBusiestIntersections.begin(), m_TotalBusiestIntersections.begin() + previousBusiestAmount, isSameIntersection))
+			m_TotalBusiestIntersections.push_back({ entries.intersectionIndex, 0 });
+	}
+	for (IntersectionEntries& entries : m_TotalBusiestIntersections)
+		entries.entriesAmount = m_TotalIntersectionsEntries[entries.intersectionIndex];
+
+	KeepBusiestIntersections(m_LastPeriodBusiestIntersections);
+	KeepBusiestIntersections(m_TotalBusiestIntersections);
+}
+
+void TrafficStatistics::KeepBusiestIntersections(std::vector<IntersectionEntries>& inOutIntersections)
+{
+	// The most entries first, then the lowest index
+	const size_t keptAmount = std::min(ReportedIntersectionsAmount, inOutIntersections.size());
+	std::partial_sort(inOutIntersections.begin(), inOutIntersections.begin() + keptAmount, inOutIntersections.end(),
+		[](const IntersectionEntries& a, const IntersectionEntries& b)
+		{
+			return (a.entriesAmount != b.entriesAmount ? a.entriesAmount > b.entriesAmount : a.intersectionIndex < b.intersectionIndex);
+		});
+	inOutIntersections.resize(keptAmount);
+}
+
+void TrafficStatistics::PrintReport(std::ostream& stream) const
+{
+	if (m_HasReport == false)
+		return;
+
+	const std::ios_base::fmtflags flags = stream.flags();
+	const std::streamsize precision = stream.precision();
+	stream << std::fixed << std::setprecision(2);
+
+	stream << "Last " << ReportTicks * TickDurationInSecond << "s: ";
+	PrintCounters(stream, m_LastPeriod, m_LastPeriodBusiestIntersections, ReportTicks);
+	const uint64_t totalTicksAmount = m_TicksAmount / ReportTicks * ReportTicks;
+	stream << "Since the start (" << totalTicksAmount * TickDurationInSecond << "s): ";
+	PrintCounters(stream, m_Total, m_TotalBusiestIntersections, totalTicksAmount);
+
+	stream.flags(flags);
+	stream.precision(precision);
+}
+
+void TrafficStatistics::PrintCounters(std::ostream& stream, const TrafficCounters& counters, const std::vector<IntersectionEntries>& busiestIntersections, uint64_t ticksAmount) const
+{
+	if (counters.carTicksAmount == 0 || ticksAmount == 0)
+	{
+		stream << "no car" << std::endl;
+		return;
+	}
+
+	// The speeds are in tiles per tick, the rates per car and per minute
+	const double carMinutes = counters.carTicksAmount * TickDurationInSecond / 60.0;
+	const double minutes = ticksAmount * TickDurationInSecond / 60.0;
+	stream << "speed mean " << counters.speedSum / counters.carTicksAmount / TickDurationInSecond
+		<< " p50 " << counters.speeds.GetQuantile(0.5f) / TickDurationInSecond
+		<< " p90 " << counters.speeds.GetQuantile(0.9f) / TickDurationInSecond
+		<< " p99 " << counters.speeds.GetQuantile(0.99f) / TickDurationInSecond << " tiles/s, "
+		<< counters.stopsAmount / carMinutes << " stops/car/min, "
+		<< 100.0 * counters.redLightTicksAmount / counters.carTicksAmount << "% of the time at red, "
+		<< counters.laneChangesAmount / carMinutes << " lane changes/car/min" << std::endl;
+
+	stream << "  " << counters.jamsAmount << " jams";
+	if (counters.jamsAmount > 0)
+		stream << " (mean " << counters.jamTicksSum * TickDurationInSecond / counters.jamsAmount
+			<< "s, longest " << counters.longestJamTicks * TickDurationInSecond << "s)";
+	for (const IntersectionEntries& entries : busiestIntersections)
+		stream << ", intersection " << entries.intersectionIndex << ": " << entries.entriesAmount / minutes << " cars/min";
+	stream << std::endl;
+}
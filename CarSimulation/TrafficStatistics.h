@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Defines.h"
+#include "Car.h"
+#include "Track.h"
+#include "IntersectionIndex.h"
+#include "QuantileSketch.h"
+
+#include <vector>
+#include <chrono>
+#include <iostream>
+
+/** Everything measured over a period, the counters of two periods can be added together */
+struct TrafficCounters
+{
+	TrafficCounters();
+
+	void Merge(const TrafficCounters& other);
+	void Reset();
+
+	/** Amount of car states recorded (1 per car and per tick) */
+	uint64_t carTicksAmount = 0;
+	double speedSum = 0.0;
+	/** Speeds in tiles per tick */
+	QuantileSketch speeds;
+	/** Amount of times a moving car stopped */
+	uint64_t stopsAmount = 0;
+	/** Car ticks spent stopped at a red light (or waiting for a reservation of the intersection) */
+	uint64_t redLightTicksAmount = 0;
+	uint64_t laneChangesAmount = 0;
+	/** A jam is a car stuck behind a stopped car, counted when the car can move again */
+	uint64_t jamsAmount = 0;
+	uint64_t jamTicksSum = 0;
+	uint64_t longestJamTicks = 0;
+	/** The intersection entered by each car entering one, in no order (a car enter at most one intersection per tick) */
+	std::vector<uint32_t> enteredIntersections;
+};
+
+/** The amount of cars that entered an intersection */
+struct IntersectionEntries
+{
+	uint32_t intersectionIndex = 0;
+	uint64_t entriesAmount = 0;
+};
+
+/**
+ * Measure the traffic while the simulation run: speeds (mean and percentiles), stops, time at red, lane changes, jams,
+ * and the throughput of each intersection (a block of intersection tiles).
+ * Each thread record the cars it moved in its own counters, the counters are merged when the tick ends
+ * and a report is made every ReportTicks ticks.
+ * The intersections entered are only listed as they're entered, they're counted per intersection when a report is made
+ * and only the busiest ones are reported: a tick never go through all the intersections of a big map.
+ * The memory only depend on the amount of cars, threads and intersections, not on the length of the run,
+ * and nothing is allocated once the lists of entered intersections held the entries of a busy period.
+ */
+class TrafficStatistics
+{
+
+public:
+	static constexpr uint64_t ReportTicks = static_cast<uint64_t>(STATISTICS_REPORT_DURATION / THREAD_REFRESH_DURATION);
+	/** The amount of intersections in the report, the busiest ones */
+	static constexpr size_t ReportedIntersectionsAmount = 5;
+
+public:
+	/**
+	 * \param carsAmount The cars ids have to be lower than it.
+	 * \param threadsAmount The amount of threads that can record cars at the same time.
+	 */
+	TrafficStatistics(const ATrack& track, size_t carsAmount, size_t threadsAmount = 1);
+
+public:
+	/** Record the state of a car at the end of the tick, each car have to be recorded once per tick by one of the threads */
+	void RecordCar(const Car& car, size_t threadIndex);
+	/** Record every car from the calling thread */
+	void RecordCars(const std::vector<Car*>& cars);
+	/**
+	 * Merge the counters of the threads, once all the cars of the tick are recorded.
+	 *
+	 * \return true if a new report is ready.
+	 */
+	bool EndTick();
+
+	/** Print the last report (nothing before the first one) */
+	void PrintReport(std::ostream& stream) const;
+	size_t GetIntersectionsAmount() const { return (m_IntersectionsAmount); }
+	uint64_t GetTicksAmount() const { return (m_TicksAmount); }
+	/** The busiest intersections of the last report period and since the start, the busiest first (at most ReportedIntersectionsAmount) */
+	const std::vector<IntersectionEntries>& GetLastPeriodBusiestIntersections() const { return (m_LastPeriodBusiestIntersections); }
+	const std::vector<IntersectionEntries>& GetTotalBusiestIntersections() const { return (m_TotalBusiestIntersections); }
+
+private:
+	/** What we remember about each car between two ticks (only the thread recording the car touch it) */
+	struct CarTracking
+	{
+		/** The intersection the car is in, -1 if none */
+		int intersectionIndex = -1;
+		uint32_t laneChangesAmount = 0;
+		/** The cars spawn stopped, it does not count as a stop */
+		bool isStopped = true;
+		uint32_t jamTicks = 0;
+	};
+	/** The counters of a thread, on their own cache lines */
+	struct alignas(CACHE_LINE_SIZE) ThreadCounters
+	{
+		TrafficCounters counters;
+	};
+
+	/** Count the entries of the period per intersection, add them to the totals and find the busiest intersections (the list is sorted) */
+	void CountIntersectionsEntries(std::vector<uint32_t>& enteredIntersections);
+	/** Keep the ReportedIntersectionsAmount busiest intersections of the list, the busiest first */
+	static void KeepBusiestIntersections(std::vector<IntersectionEntries>& inOutIntersections);
+	void PrintCounters(std::ostream& stream, const TrafficCounters& counters, const std::vector<IntersectionEntries>& busiestIntersections, uint64_t ticksAmount) const;
+
+private:
+	const ATrack& m_Track;
+
+	/** The intersection of each intersection tile, for the throughput */
+	const IntersectionIndex m_Intersections;
+	const size_t m_IntersectionsAmount;
+
+	std::vector<CarTracking> m_Cars;
+	std::vector<ThreadCounters> m_ThreadCounters;
+
+	uint64_t m_TicksAmount = 0;
+	TrafficCounters m_Period;
+	TrafficCounters m_LastPeriod;
+	TrafficCounters m_Total;
+	/** Amount of cars that entered each intersection since the start, updated when a report is made */
+	std::vector<uint64_t> m_TotalIntersectionsEntries;
+	std::vector<IntersectionEntries> m_LastPeriodBusiestIntersections;
+	std::vector<IntersectionEntries> m_TotalBusiestIntersections;
+	bool m_HasReport = false;
+};
@@ -1,62 +1,140 @@
 #pragma once
 
 #include <ostream>
+#include <cmath>
+#include <type_traits>
 
 struct IntVector2D;
 
+/**
+ * 2D float vector.
+ * Everything is inlined and constexpr (except what need the <cmath> functions) so the compiler can fold
+ * the vector math of the steering and collision loops instead of calling into another translation unit.
+ */
 struct Vector2D
 {
 	float x;
 	float y;
 
-	Vector2D();
-	Vector2D(float x, float y);
-	Vector2D(float value);
-	Vector2D(const Vector2D& other);
-	Vector2D(const IntVector2D& other);
+	constexpr Vector2D() : x(0.0f), y(0.0f) {}
+	constexpr Vector2D(float x, float y) : x(x), y(y) {}
+	constexpr Vector2D(float value) : x(value), y(value) {}
+	constexpr Vector2D(const Vector2D& other) = default;
+	constexpr Vector2D(const IntVector2D& other);
 
 	/* ADD */
-	Vector2D operator+(const Vector2D& other) const;
-	Vector2D operator+(const IntVector2D other) const;
+	constexpr Vector2D operator+(const Vector2D& other) const { return Vector2D(x + other.x, y + other.y); }
+	constexpr Vector2D operator+(const IntVector2D other) const;
 	template<typename T2>
-	Vector2D operator+(const T2 value) const;
+	constexpr Vector2D operator+(const T2 value) const { return Vector2D(x + value, y + value); }
 
 	/* SUB */
-	Vector2D operator-() const;
-	Vector2D operator-(const Vector2D& other) const;
-	Vector2D operator-(const IntVector2D other) const;
+	constexpr Vector2D operator-() const { return Vector2D(-x, -y); }
+	constexpr Vector2D operator-(const Vector2D& other) const { return Vector2D(x - other.x, y - other.y); }
+	constexpr Vector2D operator-(const IntVector2D other) const;
 	template<typename T2>
-	Vector2D operator-(const T2 value) const;
+	constexpr Vector2D operator-(const T2 value) const { return Vector2D(x - value, y - value); }
 
 	/* MULT */
-	Vector2D operator*(const Vector2D& other) const;
+	constexpr Vector2D operator*(const Vector2D& other) const { return Vector2D(x * other.x, y * other.y); }
 	template<typename T2>
-	Vector2D operator*(const T2 value) const;
+	constexpr Vector2D operator*(const T2 value) const { return Vector2D(x * value, y * value); }
 
 	/* DIV */
-	Vector2D operator/(const Vector2D& other) const;
+	constexpr Vector2D operator/(const Vector2D& other) const { return Vector2D(x / other.x, y / other.y); }
 	template<typename T2>
-	Vector2D operator/(const T2 value) const;
+	constexpr Vector2D operator/(const T2 value) const { return Vector2D(x / value, y / value); }
 
 	/* EQUAL */
-	Vector2D& operator=(const Vector2D& other);
-	bool operator==(const Vector2D& other) const;
-	Vector2D& operator+=(const Vector2D& other);
-	Vector2D& operator-=(const Vector2D& other);
-	Vector2D& operator*=(const Vector2D& other);
-	Vector2D& operator/=(const Vector2D& other);
-	bool operator!=(const Vector2D& other) const;
+	constexpr Vector2D& operator=(const Vector2D& other) = default;
+	constexpr bool operator==(const Vector2D& other) const { return x == other.x && y == other.y; }
+	constexpr Vector2D& operator+=(const Vector2D& other) { x += other.x; y += other.y; return *this; }
+	constexpr Vector2D& operator-=(const Vector2D& other) { x -= other.x; y -= other.y; return *this; }
+	constexpr Vector2D& operator*=(const Vector2D& other) { x *= other.x; y *= other.y; return *this; }
+	constexpr Vector2D& operator/=(const Vector2D& other) { x /= other.x; y /= other.y; return *this; }
+	constexpr bool operator!=(const Vector2D& other) const { return (x != other.x || y != other.y); }
 
-	Vector2D Round(const float precision = 0.0f) const;
-	Vector2D Normalize() const;
-	float Length() const;
-	float Dot(const Vector2D& other) const;
-	float AngleBetween(const Vector2D& other) const;
+	Vector2D Round(const float precision = 0.0f) const
+	{
+		if (precision == 0.0f)
+			return Vector2D(std::round(x), std::round(y));
+		return Vector2D(std::round(x / precision) * precision, std::round(y / precision) * precision);
+	}
+	Vector2D Normalize() const
+	{
+		float length = Length();
+		if (length == 0.0f)
+			return Vector2D(0.0f, 0.0f);
+		return Vector2D(x / length, y / length);
+	}
+	float Length() const { return std::sqrt(LengthSquared()); }
+	/** Squared length, use it to compare distances without paying for the square root */
+	constexpr float LengthSquared() const { return (x * x) + (y * y); }
+	constexpr float Dot(const Vector2D& other) const { return (x * other.x) + (y * other.y); }
+	/** Angle in radian between the two vectors (use IsAngleWiderThan in hot loops, it does not need acos) */
+	float AngleBetween(const Vector2D& other) const { return (std::acos(Dot(other) / (Length() * other.Length()))); }
+	/**
+	 * Compare the angle between the two vectors against an angle given by its cosine, using only dot products.
+	 * Like AngleBetween, a zero length vector has no angle so it's never wider.
+	 *
+	 * \param other The other vector.
+	 * \param cosAngle The cosine of the angle to compare with (see CosDegree).
+	 * \return true if the angle between the vectors is greater or equal than the given angle.
+	 */
+	constexpr bool IsAngleWiderThan(const Vector2D& other, float cosAngle) const
+	{
+		float lengthsSquared = LengthSquared() * other.LengthSquared();
+		if (lengthsSquared == 0.0f)
+			return false;
+		float dot = Dot(other);
+		// cos(angle) <= cosAngle, squared to avoid the square root (the sign have to be handled by hand)
+		if ((dot < 0.0f) != (cosAngle < 0.0f))
+			return dot < 0.0f;
+		float dotSquared = dot * dot;
+		float limitSquared = cosAngle * cosAngle * lengthsSquared;
+		return (dot < 0.0f ? dotSquared >= limitSquared : dotSquared <= limitSquared);
+	}
 
-	Vector2D& Rotate(const float angle);
+	/** Rotate by any angle in degree (trigonometry, prefer the fixed rotations below when possible) */
+	Vector2D& Rotate(const float degree)
+	{
+		constexpr float DegreeToRadian = 3.14159265358979323846f / 180.0f;
+		float radian = degree * DegreeToRadian;
+		float cosAngle = std::cos(radian);
+		float sinAngle = std::sin(radian);
+		float newX = x * cosAngle - y * sinAngle;
+		float newY = x * sinAngle + y * cosAngle;
+		x = newX;
+		y = newY;
+		return *this;
+	}
+	/* Fixed rotations, without any trigonometry (positive angles follow the same orientation as Rotate) */
+	constexpr Vector2D& Rotate45() { return (*this = Vector2D((x - y) * Sqrt2Over2, (x + y) * Sqrt2Over2)); }
+	constexpr Vector2D& RotateMinus45() { return (*this = Vector2D((x + y) * Sqrt2Over2, (y - x) * Sqrt2Over2)); }
+	constexpr Vector2D& Rotate90() { return (*this = Vector2D(-y, x)); }
+	constexpr Vector2D& RotateMinus90() { return (*this = Vector2D(y, -x)); }
 
-	static Vector2D Zero;
+	static const Vector2D Zero;
 
+	static constexpr float Sqrt2Over2 = 0.70710678118654752440f;
 };
 
-std::ostream& operator<<(std::ostream& os, const Vector2D& vector);
+inline constexpr Vector2D Vector2D::Zero = Vector2D(0.0f, 0.0f);
+
+static_assert(std::is_trivially_copyable<Vector2D>::value, "Vector2D have to stay trivially copyable");
+
+/** Cosine of an angle in degree, for the angles used with IsAngleWiderThan */
+inline float CosDegree(float degree)
+{
+	constexpr float DegreeToRadian = 3.14159265358979323846f / 180.0f;
+	return std::cos(degree * DegreeToRadian);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Vector2D& vector)
+{
+	os << "(x" << vector.x << ", y" << vector.y << ")";
+	return (os);
+}
+
+// The conversion and mixed operators are defined with IntVector2D
+#include "IntVector2D.h"
@@ -1,137 +1,269 @@
 #include "Car.h"
 #include "Track.h"
+#include "TrackGenerator.h"
 #include "Renderer.h"
+#include "ActivityScheduler.h"
+#include "EventEngine.h"
+#include "RegionEngine.h"
+#include "LodEngine.h"
+#include "ShardRunner.h"
+#include "BatchRunner.h"
+#include "AgentExecutor.h"
+#include "CarAgent.h"
+#include "FleetPool.h"
+#include "AllocationCounter.h"
+#include "TrafficStatistics.h"
+#include "TileHeatmap.h"
+#include "RunRecording.h"
+#include "FrameRenderer.h"
+#include "IntersectionManager.h"
+#include "TickPacer.h"
+#include "InvariantChecker.h"
+#include "Bench.h"
 
-#include <array>
+#include <vector>
 #include <chrono>
 #include <thread>
 #include <memory>
+#include <atomic>
 #include <assert.h>
 
-static Vector2D GetUniqueSpawnPoint(ATrack& track, const std::array<std::shared_ptr<Car>, CARS_AMOUNT>& cars)
-{
-	uint16_t attempt = 0;
-
-	Vector2D spawnPoint;
-	bool isSpawnPointUnique;
-	do
-	{
-		isSpawnPointUnique = true;
-		spawnPoint = track.GetSpawnPoint();
-
-		for (auto car : cars)
-		{
-			if (car != nullptr && car->GetPosition() == spawnPoint)
-			{
-				isSpawnPointUnique = false;
-				break;
-			}
-		}
-
-		attempt++;
-		if (attempt >= 10000)
-			assert(false);
-	} while (isSpawnPointUnique == false);
+/** Raised when the main loop end, the threads of the cars have to stop before the fleet is destroyed */
+static std::atomic<bool> StopCarThreads = { false };
 
-	return spawnPoint;
-}
-
-void ThreadFunction(std::shared_ptr<Car> car)
+void ThreadFunction(Car* car)
 {
-	std::chrono::nanoseconds time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
-	std::chrono::nanoseconds timeTakenToLoop = {};
-	std::chrono::nanoseconds currentTime = {};
-	std::chrono::nanoseconds sleepTime = {};
+	TickPacer pacer(THREAD_REFRESH_DURATION, SelectedOverrunPolicy, PACER_SPIN_DURATION);
 
 	// Thread loop
-	while (true)
+	while (StopCarThreads == false)
 	{
 		car->Move();
+		pacer.WaitNextTick();
+	}
+}
 
-		currentTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
-		timeTakenToLoop = currentTime - time;
-		sleepTime = std::chrono::nanoseconds(std::max(0ll, (std::chrono::duration_cast<std::chrono::nanoseconds>(THREAD_REFRESH_DURATION) - timeTakenToLoop).count()));
-		std::this_thread::sleep_for(sleepTime);
-		time = currentTime - sleepTime;
+#if RECORD_FRAMES
+/** Render the recorded ticks, one image per tick, on every core */
+static int RenderRecording(const ATrack& track, const RunRecording& recording)
+{
+	const FrameRenderer frameRenderer(track, FRAME_PIXELS_PER_TILE);
+	const unsigned int threadsAmount = std::max(1u, std::thread::hardware_concurrency());
+	const std::chrono::steady_clock::time_point renderStartTime = std::chrono::steady_clock::now();
+	if (frameRenderer.RenderRecording(recording, FRAMES_PREFIX, threadsAmount) == false)
+	{
+		std::cout << "Can't write the frames " << FRAMES_PREFIX << std::endl;
+		return (1);
 	}
+	const std::chrono::duration<double> renderDuration = std::chrono::steady_clock::now() - renderStartTime;
+	std::cout << recording.GetTicksAmount() << " frames of " << frameRenderer.GetWidth() << "x" << frameRenderer.GetHeight()
+		<< " rendered in " << renderDuration.count() << "s on " << threadsAmount << " threads (" << FRAMES_PREFIX << "_*.ppm)" << std::endl;
+	return (0);
 }
+#endif
 
-static int MainLoopGameThread(const ATrack& track, const std::array<std::shared_ptr<Car>, CARS_AMOUNT>& cars)
+static int MainLoopGameThread(ATrack& track, const std::vector<Car*>& cars)
 {
 	AsciiRenderer renderer;
-
-	std::chrono::nanoseconds time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
-	std::chrono::nanoseconds timeTakenToLoop = {};
-	std::chrono::nanoseconds currentTime = {};
-	std::chrono::nanoseconds sleepTime = {};
+#if SIMULATION_ENGINE == 1
+	EventEngine engine(track, cars);
+#elif SIMULATION_ENGINE == 2
+	RegionEngine engine(track, cars);
+#elif SIMULATION_ENGINE == 3
+#ifdef _WIN32
+#error The sharded engine need processes and POSIX shared memory, it only run on Linux
+#endif
+	ShardRunner shards(track, cars, SHARDS_AMOUNT);
+	if (shards.Start(0, true) == false)
+		return (1);
+	std::cout << shards.GetShardsAmount() << " shards started" << std::endl;
+#elif SIMULATION_ENGINE == 4
+	// The close up follow the first car, it's the one that need the full model
+	LodEngine engine(track, cars, { 0 }, LOD_MICRO_RADIUS);
+#elif MULTI_THREADING == 0
+	ActivityScheduler scheduler(track, cars);
+#elif MULTI_THREADING == 2
+	AgentExecutor executor(track);
+	for (const auto& car : cars)
+		executor.Spawn(RunCarAgent(*car, executor));
+#endif
+#if TRAFFIC_STATISTICS && SIMULATION_ENGINE == 2
+	// Each thread of the engine record its own cars
+	TrafficStatistics statistics(track, cars.size(), engine.GetThreadsAmount());
+	engine.SetStatistics(&statistics);
+#elif TRAFFIC_STATISTICS
+	TrafficStatistics statistics(track, cars.size());
+#endif
+#if TILE_HEATMAP && SIMULATION_ENGINE == 2
+	TileHeatmap heatmap(track, engine.GetThreadsAmount());
+	engine.SetHeatmap(&heatmap);
+#elif TILE_HEATMAP
+	TileHeatmap heatmap(track);
+#endif
+	InvariantChecker invariantChecker(track, cars.size(), SelectedInvariantCheckMode, INVARIANT_SAMPLING_TICKS, INVARIANT_LOG_SIZE);
+#if RECORD_FRAMES
+	// The rendering is the slow part, it's done once every tick is recorded
+	RunRecording recording(cars.size());
+	recording.Reserve(RECORDED_TICKS);
+#endif
+	const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	TickPacer pacer(MAIN_THREAD_REFRESH_DURATION, SelectedOverrunPolicy, PACER_SPIN_DURATION);
 
 	// Main loop
-	while (true)
+	for (uint64_t tick = 0; true; tick++)
 	{
+#if COUNT_ALLOCATIONS
+		const uint64_t allocationsAmountBefore = AllocationCounter::GetAllocationsAmount();
+#endif
 
-#if MULTI_THREADING == 0
-		for (auto car : cars)
-			car->Move();
+		// The simulation follow the wall clock
+		std::chrono::duration<double> elapsedTime = std::chrono::steady_clock::now() - startTime;
+#if SIMULATION_ENGINE == 1
+		engine.RunUntil(static_cast<uint64_t>(elapsedTime / THREAD_REFRESH_DURATION));
+#else
+		track.GetTrafficLight().SetTime(elapsedTime.count());
+#if SIMULATION_ENGINE == 2 || SIMULATION_ENGINE == 4
+		engine.Tick();
+#elif SIMULATION_ENGINE == 3
+		// The shards run on their own, just look at where they are
+		if (shards.CheckShards() == false)
+			return (1);
+		shards.ReadCarStates(cars);
+#elif MULTI_THREADING == 0
+		scheduler.Tick();
+#elif MULTI_THREADING == 2
+		executor.Tick();
+#endif
+#endif
+#if SIMULATION_ENGINE == 4
+		// The meso cars share their cells, only the cars of the full model have to avoid each other
+		invariantChecker.CheckTick(tick, cars, engine.GetMicroCarIds());
+#else
+		invariantChecker.CheckTick(tick, cars);
+#endif
+#if RECORD_FRAMES
+		recording.Record(cars);
+		if (recording.GetTicksAmount() == RECORDED_TICKS)
+			return (RenderRecording(track, recording));
+#endif
+#if TRAFFIC_STATISTICS
+#if SIMULATION_ENGINE != 2
+		statistics.RecordCars(cars);
+#endif
+		statistics.EndTick();
+#endif
+#if TILE_HEATMAP
+#if SIMULATION_ENGINE != 2
+		heatmap.RecordCars(cars);
+#endif
+		heatmap.EndTick();
+		// There is no end to the real time simulation, so the files are rewritten from time to time
+		if ((tick + 1) % (HEATMAP_WRITE_DURATION / THREAD_REFRESH_DURATION) == 0 && heatmap.WriteFiles(HEATMAP_FILES_PREFIX) == false)
+			std::cout << "Can't write the heatmaps " << HEATMAP_FILES_PREFIX << std::endl;
 #endif
 
 		renderer.Render(track, cars);
-
-		// check if no cars are overlapping
-		for (int i = 0; i < CARS_AMOUNT; i++)
+#if TRAFFIC_STATISTICS
+		statistics.PrintReport(std::cout);
+#endif
+		invariantChecker.PrintReport(std::cout);
+		if (pacer.GetMissedDeadlinesAmount() > 0)
 		{
-			for (int j = i + 1; j < CARS_AMOUNT; j++)
-			{
-				if (cars[i]->IsColliding(cars[j]))
-				{
-					std::cout << "Collision between car '" << cars[i]->GetDisplayChar() << "' and car '" << cars[j]->GetDisplayChar() << "'" << std::endl;
-					break;
-				}
-			}
-
-			// make sure it's on the track
-			if (track.IsHereARoad(track.MapPositionOnTrack(cars[i]->GetPosition())) == false)
-			{
-				std::cout << "Car '" << cars[i]->GetDisplayChar() << "' is off the track" << std::endl;
-			}
+			std::cout << pacer.GetMissedDeadlinesAmount() << " late ticks (worst " << std::chrono::duration<double, std::milli>(pacer.GetWorstLateness()).count()
+				<< " ms), " << pacer.GetSkippedDeadlinesAmount() << " skipped, " << pacer.GetTickRate() << " ticks per second" << std::endl;
 		}
 
-		currentTime = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch());
-		timeTakenToLoop = currentTime - time;
-		sleepTime = std::chrono::nanoseconds(std::max(0ll, (std::chrono::duration_cast<std::chrono::nanoseconds>(MAIN_THREAD_REFRESH_DURATION) - timeTakenToLoop).count()));
-		std::this_thread::sleep_for(sleepTime);
-		time = currentTime - sleepTime;
+#if COUNT_ALLOCATIONS
+		const uint64_t tickAllocationsAmount = AllocationCounter::GetAllocationsAmount() - allocationsAmountBefore;
+		if (tickAllocationsAmount > 0)
+			std::cout << "Tick " << tick << " allocated " << tickAllocationsAmount << " times" << std::endl;
+#endif
+
+		pacer.WaitNextTick();
 	}
 }
 
 int main()
 {
-	// set rand seed otherwise will always have the same RNG
-	std::srand(time(nullptr));
+#if RUN_BENCHMARKS
+	Bench::RunAll(std::cout);
+	return 0;
+#endif
+
+	// Every random value of the simulation derive from this seed
+	uint64_t seed = SIMULATION_SEED;
+	if (seed == 0)
+		seed = static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+	std::cout << "Seed: " << seed << std::endl;
 
-	std::array<std::shared_ptr<Car>, CARS_AMOUNT> cars;
 #if SELECTED_MAP == 0
 	ATrack track = FigureEightTrack();
-#else
+#elif SELECTED_MAP == 1
 	ATrack track = MultiIntersectionTrack();
+#elif SELECTED_MAP == 2
+	ATrack track(TrackGenerator::CreateManhattanGrid(GENERATED_MAP_WIDTH, GENERATED_MAP_HEIGHT));
+#elif SELECTED_MAP == 3
+	ATrack track(TrackGenerator::CreateRingRoads(GENERATED_MAP_WIDTH, GENERATED_MAP_HEIGHT));
+#else
+	ATrack track(TrackGenerator::CreateTiledFigureEights(GENERATED_MAP_WIDTH, GENERATED_MAP_HEIGHT));
+#endif
+#if INTERSECTION_CONTROL
+#if SIMULATION_ENGINE == 3
+#error The reservations of the intersections are not shared between the processes of the sharded engine
+#endif
+	IntersectionManager intersectionManager(track);
+	track.SetIntersectionManager(&intersectionManager);
+	std::cout << intersectionManager.GetIntersectionsAmount() << " intersections (" << intersectionManager.GetIntersectionTilesAmount() << " tiles) managed by reservations" << std::endl;
 #endif
 
-	for (int i = 0; i < CARS_AMOUNT; i++)
+#if BATCH_MODE
+	BatchRunner batch(track);
+#if TILE_HEATMAP
+	TileHeatmap heatmap(track, batch.GetThreadsAmount());
+	batch.SetHeatmap(&heatmap);
+#endif
+	batch.Run(BatchRunner::CreateScenarios(seed, BATCH_SCENARIOS_AMOUNT, BATCH_MIN_CARS_AMOUNT, BATCH_MAX_CARS_AMOUNT,
+		BATCH_MIN_LIGHT_PHASE_DURATION, BATCH_MAX_LIGHT_PHASE_DURATION, BATCH_TICKS_PER_SCENARIO));
+	std::cout << BATCH_SCENARIOS_AMOUNT << " simulations in " << batch.GetRunDuration() << "s on " << batch.GetThreadsAmount() << " threads ("
+		<< batch.GetSimulationsPerSecond() << " simulations per second)" << std::endl;
+	if (batch.WriteResults(BATCH_RESULTS_FILE) == false)
 	{
-		Vector2D spawnPoint = GetUniqueSpawnPoint(track, cars);
-
-		cars[i] = std::make_shared<Car>(track, i, spawnPoint);
-		track.RegisterNewCarOnTrack(cars[i]);
+		std::cout << "Can't write " << BATCH_RESULTS_FILE << std::endl;
+		return 1;
 	}
-
-#if MULTI_THREADING
-	for (int i = 0; i < CARS_AMOUNT; i++)
+	std::cout << "Results written in " << BATCH_RESULTS_FILE << std::endl;
+#if TILE_HEATMAP
+	if (heatmap.WriteFiles(HEATMAP_FILES_PREFIX) == false)
 	{
-		std::thread threadProcess(ThreadFunction, cars[i]);
-		threadProcess.detach();
+		std::cout << "Can't write the heatmaps " << HEATMAP_FILES_PREFIX << std::endl;
+		return 1;
 	}
+	std::cout << "Heatmaps written in " << HEATMAP_FILES_PREFIX << "*" << std::endl;
+#endif
+	return 0;
 #endif
 
-	MainLoopGameThread(track, cars);
+	// Spawn the whole fleet at once, in one block of memory
+	std::vector<Vector2D> spawnPoints = track.GetUniqueSpawnPoints(CARS_AMOUNT, seed);
+	FleetPool fleet(CARS_AMOUNT);
+	for (int i = 0; i < CARS_AMOUNT; i++)
+		track.RegisterNewCarOnTrack(fleet.Create(track, i, seed, spawnPoints[i]));
+	const std::vector<Car*>& cars = fleet.GetCars();
+	std::cout << CARS_AMOUNT << " cars spawned" << std::endl;
 
-	return 0;
+#if SIMULATION_ENGINE == 0 && MULTI_THREADING == 1
+	std::vector<std::thread> carThreads;
+	carThreads.reserve(CARS_AMOUNT);
+	for (int i = 0; i < CARS_AMOUNT; i++)
+		carThreads.emplace_back(ThreadFunction, cars[i]);
+
+	// The main loop only end once the frames are recorded or on an error
+	const int result = MainLoopGameThread(track, cars);
+	StopCarThreads = true;
+	for (std::thread& carThread : carThreads)
+		carThread.join();
+	return (result);
+#else
+	return (MainLoopGameThread(track, cars));
+#endif
 }
\ No newline at end of file